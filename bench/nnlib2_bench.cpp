@@ -0,0 +1,458 @@
+//		----------------------------------------------------------
+//		(c)2026  Vasilis.N.Nikolaidis          All rights reserved.
+//		-----------------------------------------------------------
+//		nnlib2_bench.cpp						Version 0.1
+//		-----------------------------------------------------------
+//		Microbenchmarks for nnlib2 components and kernels (standalone,
+//		does not use R). Measures recall and encode of layers and
+//		connection sets (fully connected, size x size), and dllist
+//		operations, for a range of sizes. For each it reports time
+//		per call and per item (connection, PE or list item), GFLOP/s
+//		and (estimated) memory bandwidth, i.e. bytes of component
+//		storage that must be read or written per call (connections
+//		or weights, and misc values; PE values are not counted).
+//		Useful for choosing component types (s.a. connection sets vs
+//		matrices) and for catching performance regressions.
+//		-----------------------------------------------------------
+//		Build (from this directory, using the library sources in src):
+//
+//		g++ -std=c++11 -O2 -DNNLIB2_FOR_GCC -pthread -I../src
+//		    -o nnlib2_bench nnlib2_bench.cpp
+//		    $(ls ../src/*.cpp | grep -v /Rcpp)
+//
+//		Run:
+//		nnlib2_bench [--sizes 16,64,256,1024] [--min-time 0.2] [--csv]
+//		(--min-time is seconds spent on each measurement, --csv prints
+//		results as CSV, s.a. for comparing runs.)
+//		-----------------------------------------------------------
+
+#include "nnlib2.h"
+
+#ifndef NNLIB2_FOR_GCC
+#error "nnlib2 benchmarks must be compiled with NNLIB2_FOR_GCC defined (see build instructions above)"
+#endif
+
+#include "layer.h"
+#include "connection_set.h"
+#include "connection_matrix.h"
+#include "nnlib2_dllist.h"
+#include "nn_bp.h"
+#include "nn_lvq.h"
+#include "nn_mam.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <vector>
+
+using namespace nnlib2;
+using namespace nnlib2::bp;
+using namespace nnlib2::lvq;
+using namespace nnlib2::mam;
+
+/*-----------------------------------------------------------------------*/
+// connection and matrix with the same (simple) functionality, so that the
+// two storage schemes (Connection_Set of connection objects vs
+// generic_connection_matrix) can be compared directly:
+// recall: destination input += weight * source output
+// encode: weight += rate * source output * destination output (Hebbian)
+
+#define BENCH_RATE ((DATA)0.0001)
+
+class bench_connection : public connection
+{
+public:
+	void recall() { destin_pe().add_to_input(weight() * source_pe().output); }
+	void encode() { weight() += BENCH_RATE * source_pe().output * destin_pe().output; }
+};
+
+typedef Connection_Set<bench_connection> bench_connection_set;
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+class bench_connection_matrix : public generic_connection_matrix
+{
+public:
+	void recall()
+	{
+		if(NOT sizes_are_consistent()) return;
+		layer REF source = source_layer();
+		layer REF destin = destin_layer();
+		int source_size = source.size();
+		int destin_size = destin.size();
+		for(int d=0;d<destin_size;d++)
+		{
+			const DATA PTR weights = m_weights[d];
+			DATA x = 0;
+			for(int s=0;s<source_size;s++)
+				x += weights[s] * source.PE(s).output;
+			destin.PE(d).add_to_input(x);
+		}
+	}
+
+	void encode()
+	{
+		if(NOT sizes_are_consistent()) return;
+		layer REF source = source_layer();
+		layer REF destin = destin_layer();
+		int source_size = source.size();
+		int destin_size = destin.size();
+		for(int d=0;d<destin_size;d++)
+		{
+			DATA PTR weights = m_weights[d];
+			DATA y = BENCH_RATE * destin.PE(d).output;
+			for(int s=0;s<source_size;s++)
+				weights[s] += y * source.PE(s).output;
+		}
+	}
+};
+
+/*-----------------------------------------------------------------------*/
+// measurement
+
+struct bench_result
+{
+	string component;
+	string operation;
+	int size;
+	double items;						// connections, PEs or list items processed per call
+	double ns_per_call;
+	double flops_per_item;				// 0 if not applicable
+	double bytes_per_item;				// 0 if not applicable
+};
+
+static double g_min_seconds = 0.2;		// time spent on each measurement
+static std::vector<bench_result> g_results;
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// time op (best ns per call, over batches of calls lasting at least ~1/10
+// of g_min_seconds each). op must be repeatable.
+
+template <class OP>
+double time_per_call(OP op)
+{
+	typedef std::chrono::steady_clock clock;
+
+	op();													// warm up (caches, lazily allocated buffers)
+
+	long batch = 1;
+	double batch_seconds = g_min_seconds / 10;
+	for(;;)													// find batch size
+	{
+		clock::time_point start = clock::now();
+		for(long i=0;i<batch;i++) op();
+		double seconds = std::chrono::duration<double>(clock::now()-start).count();
+		if(seconds>=batch_seconds) break;
+		batch = (seconds<=0) ? batch*10 : (long)(batch*1.5*batch_seconds/seconds)+1;
+	}
+
+	double best = -1;
+	double total = 0;
+	while(total<g_min_seconds)
+	{
+		clock::time_point start = clock::now();
+		for(long i=0;i<batch;i++) op();
+		double seconds = std::chrono::duration<double>(clock::now()-start).count();
+		total += seconds;
+		double ns = seconds * 1e9 / batch;
+		if((best<0) OR (ns<best)) best = ns;
+	}
+	return best;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+template <class OP>
+void measure(string component, string operation, int size, double items, double flops_per_item, double bytes_per_item, OP op)
+{
+	bench_result r;
+	r.component = component;
+	r.operation = operation;
+	r.size = size;
+	r.items = items;
+	r.ns_per_call = time_per_call(op);
+	r.flops_per_item = flops_per_item;
+	r.bytes_per_item = bytes_per_item;
+	g_results.push_back(r);
+}
+
+/*-----------------------------------------------------------------------*/
+// layers (items are PEs)
+
+static void bench_pe_layer(int n)
+{
+	error_flag_t error_flag(false);
+	pe_layer l;
+	l.setup("pe_layer",n,&error_flag);
+
+	// generic pes sum values received (as from generic connections), one per pe here:
+	measure("pe_layer","recall",n,n,1,sizeof(pe),[&]()
+		{
+		for(int i=0;i<n;i++) l.PE(i).receive_input_value((DATA)i);
+		l.recall();
+		});
+	measure("pe_layer","encode",n,n,1,sizeof(pe),[&]()
+		{
+		for(int i=0;i<n;i++) l.PE(i).receive_input_value((DATA)i);
+		l.encode();
+		});
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+static void bench_bp_comput_layer(int n)
+{
+	error_flag_t error_flag(false);
+	bp_comput_layer l;
+	l.setup("bp_comput_layer",n,&error_flag);
+	l.set_learning_rate(0.1);
+	l.randomize_biases(-1,1);
+	std::vector<DATA> input(n);
+	for(int i=0;i<n;i++) input[i] = random(-1,1);
+
+	// input (sum) is set, then sigmoid computed (exp is counted as one operation):
+	measure("bp_comput_layer","recall",n,n,5,sizeof(pe),[&]()
+		{
+		l.input_data_from_vector(input.data(),n);
+		l.recall();
+		});
+	measure("bp_comput_layer","encode",n,n,6,sizeof(pe),[&]()
+		{
+		l.input_data_from_vector(input.data(),n);
+		l.encode();
+		});
+}
+
+/*-----------------------------------------------------------------------*/
+// connection sets (items are connections, n x n)
+
+template <class CONNECTION_SET>
+static void bench_weighted_sum(string name, int n, CONNECTION_SET REF c, double bytes_per_connection)
+{
+	error_flag_t error_flag(false);
+	pe_layer source, destin;
+	source.setup("source",n,&error_flag);
+	destin.setup("destin",n,&error_flag);
+	for(int i=0;i<n;i++) { source.PE(i).output = random(0,1); destin.PE(i).output = random(0,1); }
+	c.setup(name,&source,&destin,&error_flag,true,-1,1);
+
+	double connections = (double)n * n;
+	measure(name,"recall",n,connections,2,bytes_per_connection,[&]() { c.recall(); });
+	measure(name,"encode",n,connections,3,2*bytes_per_connection,[&]() { c.encode(); });
+	if(error_flag) fprintf(stderr,"%s (%d) failed\n",name.c_str(),n);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+static void bench_generic_connections(int n)
+{
+	bench_connection_set s;
+	bench_weighted_sum("Connection_Set<connection>",n,s,sizeof(bench_connection));
+	bench_connection_matrix m;
+	bench_weighted_sum("generic_connection_matrix",n,m,sizeof(DATA));
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+template <class CONNECTION_SET>
+static void bench_bp_connections(string name, int n, double bytes_per_connection)
+{
+	error_flag_t error_flag(false);
+	bp_comput_layer source, destin;
+	source.setup("source",n,&error_flag);
+	destin.setup("destin",n,&error_flag);
+	for(int i=0;i<n;i++)
+		{
+		source.PE(i).output = random(0,1);
+		destin.PE(i).misc = random(-0.001,0.001);			// (errors, back-propagated by encode)
+		}
+	CONNECTION_SET c;
+	c.set_learning_rate(0.0001);
+	c.setup(name,&source,&destin,&error_flag,true,-1,1);
+
+	// recall: weighted sum; encode: error back-propagated to source and weight adjusted:
+	double connections = (double)n * n;
+	measure(name,"recall",n,connections,2,bytes_per_connection,[&]() { c.recall(); });
+	measure(name,"encode",n,connections,5,2*bytes_per_connection,[&]() { c.encode(); });
+	if(error_flag) fprintf(stderr,"%s (%d) failed\n",name.c_str(),n);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+static void bench_lvq_connection_set(int n)
+{
+	error_flag_t error_flag(false);
+	lvq_input_layer source;
+	lvq_output_layer destin;
+	source.setup("source",n,&error_flag);
+	destin.set_error_flag(&error_flag);
+	destin.setup("destin",n,1);
+	for(int i=0;i<n;i++) source.PE(i).output = random(0,1);
+	lvq_connection_set c;
+	c.setup("lvq_connection_set",&source,&destin,&error_flag,true,0,1);
+	c.set_iteration_number(1);
+	c.recall();												// (finds differences used by encode)
+	destin.recall();										// (selects winner, rewarded by encode)
+
+	// recall: squared differences summed; encode: only connections to winner are changed:
+	double connections = (double)n * n;
+	measure("lvq_connection_set","recall",n,connections,3,2*sizeof(connection),[&]() { c.recall(); });
+	measure("lvq_connection_set","encode",n,connections,3.0/n,sizeof(connection),[&]() { c.encode(); });
+	if(error_flag) fprintf(stderr,"lvq_connection_set (%d) failed\n",n);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+static void bench_mam_connection_set(int n)
+{
+	error_flag_t error_flag(false);
+	pe_layer source, destin;
+	source.setup("source",n,&error_flag);
+	destin.setup("destin",n,&error_flag);
+	for(int i=0;i<n;i++) { source.PE(i).output = random(0,1); destin.PE(i).input = random(0,1); }
+	mam_connection_set c;
+	c.setup("mam_connection_set",&source,&destin,&error_flag,true,-1,1);
+
+	// MAM connections queue values to destination pes (received_values), so recall
+	// includes destination layer recall (which sums and clears them):
+	double connections = (double)n * n;
+	measure("mam_connection_set","recall",n,connections,2,sizeof(mam_connection),[&]()
+		{
+		c.recall();
+		destin.recall();
+		});
+	for(int i=0;i<n;i++) destin.PE(i).input = random(0,1);
+	measure("mam_connection_set","encode",n,connections,2,2*sizeof(mam_connection),[&]() { c.encode(); });
+	if(error_flag) fprintf(stderr,"mam_connection_set (%d) failed\n",n);
+}
+
+/*-----------------------------------------------------------------------*/
+// dllist (items are list items)
+
+static void bench_dllist(int n)
+{
+	dllist<DATA> l;
+
+	measure("dllist","append+reset",n,n,0,0,[&]()
+		{
+		for(int i=0;i<n;i++) l.append((DATA)i);
+		l.reset();
+		});
+
+	for(int i=0;i<n;i++) l.append((DATA)i);
+
+	volatile DATA sink;
+	measure("dllist","iterate",n,n,1,0,[&]()				// (external iterator)
+		{
+		DATA sum = 0;
+		for(DATA d : l) sum += d;
+		sink = sum;
+		});
+	measure("dllist","goto_next",n,n,1,0,[&]()				// (internal iterator)
+		{
+		DATA sum = 0;
+		if(l.goto_first())
+			do sum += l.current(); while(l.goto_next());
+		sink = sum;
+		});
+	measure("dllist","remove_last",n,n,0,0,[&]()
+		{
+		for(int i=0;i<n;i++) l.remove_last();
+		for(int i=0;i<n;i++) l.append((DATA)i);				// (restore)
+		});
+	(void) sink;
+}
+
+/*-----------------------------------------------------------------------*/
+
+static void print_results(bool csv)
+{
+	if(csv)
+		printf("component,operation,size,items,ns_per_call,ns_per_item,gflops,gbytes_per_second\n");
+	else
+		printf("%-28s %-13s %6s %10s %14s %10s %8s %8s\n","component","operation","size","items","ns/call","ns/item","GFLOP/s","GB/s");
+
+	for(const bench_result REF r : g_results)
+	{
+		double ns_per_item = r.ns_per_call / r.items;
+		double gflops = r.flops_per_item / ns_per_item;			// (flops per ns = GFLOP/s)
+		double gbytes = r.bytes_per_item / ns_per_item;
+		if(csv)
+			printf("%s,%s,%d,%.0f,%.3f,%.4f,%.4f,%.4f\n",r.component.c_str(),r.operation.c_str(),r.size,r.items,r.ns_per_call,ns_per_item,gflops,gbytes);
+		else
+		{
+			char gflops_text[32] = "-";
+			char gbytes_text[32] = "-";
+			if(r.flops_per_item>0) snprintf(gflops_text,sizeof(gflops_text),"%.3f",gflops);
+			if(r.bytes_per_item>0) snprintf(gbytes_text,sizeof(gbytes_text),"%.2f",gbytes);
+			printf("%-28s %-13s %6d %10.0f %14.1f %10.3f %8s %8s\n",r.component.c_str(),r.operation.c_str(),r.size,r.items,r.ns_per_call,ns_per_item,gflops_text,gbytes_text);
+		}
+	}
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+static bool parse_sizes(const char PTR text, std::vector<int> REF sizes)
+{
+	sizes.clear();
+	std::stringstream s(text);
+	string item;
+	while(std::getline(s,item,','))
+	{
+		int n = atoi(item.c_str());
+		if(n<=0) return false;
+		sizes.push_back(n);
+	}
+	return NOT sizes.empty();
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+int main(int argc, char PTR argv[])
+{
+	std::vector<int> sizes = {16,64,256,1024};
+	bool csv = false;
+
+	for(int a=1;a<argc;a++)
+	{
+		if((strcmp(argv[a],"--sizes")==0) AND (a+1<argc))
+		{
+			if(NOT parse_sizes(argv[++a],sizes)) { fprintf(stderr,"invalid sizes: %s\n",argv[a]); return 1; }
+		}
+		else
+		if((strcmp(argv[a],"--min-time")==0) AND (a+1<argc))
+		{
+			g_min_seconds = atof(argv[++a]);
+			if(g_min_seconds<=0) { fprintf(stderr,"invalid time: %s\n",argv[a]); return 1; }
+		}
+		else
+		if(strcmp(argv[a],"--csv")==0) csv = true;
+		else
+		{
+			fprintf(stderr,"usage: %s [--sizes 16,64,256,1024] [--min-time 0.2] [--csv]\n",argv[0]);
+			return 1;
+		}
+	}
+
+	if(NOT csv) fprintf(stderr,"%s\n",NN_VERSION);
+
+	for(int n : sizes)
+	{
+		if(NOT csv) fprintf(stderr,"size %d...\n",n);
+		bench_pe_layer(n);
+		bench_bp_comput_layer(n);
+		bench_generic_connections(n);
+		bench_bp_connections<bp_connection_set>("bp_connection_set",n,sizeof(connection));
+		bench_bp_connections<bp_connection_matrix>("bp_connection_matrix",n,sizeof(DATA));
+		bench_lvq_connection_set(n);
+		bench_mam_connection_set(n);
+		bench_dllist(n);
+	}
+
+	print_results(csv);
+	return 0;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
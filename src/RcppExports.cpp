@@ -11,8 +11,8 @@ Rcpp::Rostream<false>& Rcpp::Rcerr = Rcpp::Rcpp_cerr_get();
 #endif
 
 // Autoencoder
-NumericMatrix Autoencoder(NumericMatrix data_in, int desired_new_dimension, int number_of_training_epochs, double learning_rate, int num_hidden_layers, int hidden_layer_size, bool show_nn, std::string error_type, double acceptable_error_level, int display_rate);
-RcppExport SEXP _nnlib2Rcpp_Autoencoder(SEXP data_inSEXP, SEXP desired_new_dimensionSEXP, SEXP number_of_training_epochsSEXP, SEXP learning_rateSEXP, SEXP num_hidden_layersSEXP, SEXP hidden_layer_sizeSEXP, SEXP show_nnSEXP, SEXP error_typeSEXP, SEXP acceptable_error_levelSEXP, SEXP display_rateSEXP) {
+NumericMatrix Autoencoder(NumericMatrix data_in, int desired_new_dimension, int number_of_training_epochs, double learning_rate, int num_hidden_layers, int hidden_layer_size, bool show_nn, std::string error_type, double acceptable_error_level, int display_rate, std::string checkpoint_file, int checkpoint_epochs, double checkpoint_seconds, bool resume, std::string weights_file_prefix);
+RcppExport SEXP _nnlib2Rcpp_Autoencoder(SEXP data_inSEXP, SEXP desired_new_dimensionSEXP, SEXP number_of_training_epochsSEXP, SEXP learning_rateSEXP, SEXP num_hidden_layersSEXP, SEXP hidden_layer_sizeSEXP, SEXP show_nnSEXP, SEXP error_typeSEXP, SEXP acceptable_error_levelSEXP, SEXP display_rateSEXP, SEXP checkpoint_fileSEXP, SEXP checkpoint_epochsSEXP, SEXP checkpoint_secondsSEXP, SEXP resumeSEXP, SEXP weights_file_prefixSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
@@ -26,13 +26,99 @@ BEGIN_RCPP
     Rcpp::traits::input_parameter< std::string >::type error_type(error_typeSEXP);
     Rcpp::traits::input_parameter< double >::type acceptable_error_level(acceptable_error_levelSEXP);
     Rcpp::traits::input_parameter< int >::type display_rate(display_rateSEXP);
-    rcpp_result_gen = Rcpp::wrap(Autoencoder(data_in, desired_new_dimension, number_of_training_epochs, learning_rate, num_hidden_layers, hidden_layer_size, show_nn, error_type, acceptable_error_level, display_rate));
+    Rcpp::traits::input_parameter< std::string >::type checkpoint_file(checkpoint_fileSEXP);
+    Rcpp::traits::input_parameter< int >::type checkpoint_epochs(checkpoint_epochsSEXP);
+    Rcpp::traits::input_parameter< double >::type checkpoint_seconds(checkpoint_secondsSEXP);
+    Rcpp::traits::input_parameter< bool >::type resume(resumeSEXP);
+    Rcpp::traits::input_parameter< std::string >::type weights_file_prefix(weights_file_prefixSEXP);
+    rcpp_result_gen = Rcpp::wrap(Autoencoder(data_in, desired_new_dimension, number_of_training_epochs, learning_rate, num_hidden_layers, hidden_layer_size, show_nn, error_type, acceptable_error_level, display_rate, checkpoint_file, checkpoint_epochs, checkpoint_seconds, resume, weights_file_prefix));
+    return rcpp_result_gen;
+END_RCPP
+}
+// Autoencoder_file
+double Autoencoder_file(std::string input_file, std::string output_file, std::string format, int desired_new_dimension, int number_of_training_epochs, double learning_rate, int num_hidden_layers, int hidden_layer_size, std::string error_type, double acceptable_error_level, int display_rate, bool shuffle, int input_dimension, std::string checkpoint_file, int checkpoint_epochs, double checkpoint_seconds, bool resume, std::string weights_file_prefix);
+RcppExport SEXP _nnlib2Rcpp_Autoencoder_file(SEXP input_fileSEXP, SEXP output_fileSEXP, SEXP formatSEXP, SEXP desired_new_dimensionSEXP, SEXP number_of_training_epochsSEXP, SEXP learning_rateSEXP, SEXP num_hidden_layersSEXP, SEXP hidden_layer_sizeSEXP, SEXP error_typeSEXP, SEXP acceptable_error_levelSEXP, SEXP display_rateSEXP, SEXP shuffleSEXP, SEXP input_dimensionSEXP, SEXP checkpoint_fileSEXP, SEXP checkpoint_epochsSEXP, SEXP checkpoint_secondsSEXP, SEXP resumeSEXP, SEXP weights_file_prefixSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< std::string >::type input_file(input_fileSEXP);
+    Rcpp::traits::input_parameter< std::string >::type output_file(output_fileSEXP);
+    Rcpp::traits::input_parameter< std::string >::type format(formatSEXP);
+    Rcpp::traits::input_parameter< int >::type desired_new_dimension(desired_new_dimensionSEXP);
+    Rcpp::traits::input_parameter< int >::type number_of_training_epochs(number_of_training_epochsSEXP);
+    Rcpp::traits::input_parameter< double >::type learning_rate(learning_rateSEXP);
+    Rcpp::traits::input_parameter< int >::type num_hidden_layers(num_hidden_layersSEXP);
+    Rcpp::traits::input_parameter< int >::type hidden_layer_size(hidden_layer_sizeSEXP);
+    Rcpp::traits::input_parameter< std::string >::type error_type(error_typeSEXP);
+    Rcpp::traits::input_parameter< double >::type acceptable_error_level(acceptable_error_levelSEXP);
+    Rcpp::traits::input_parameter< int >::type display_rate(display_rateSEXP);
+    Rcpp::traits::input_parameter< bool >::type shuffle(shuffleSEXP);
+    Rcpp::traits::input_parameter< int >::type input_dimension(input_dimensionSEXP);
+    Rcpp::traits::input_parameter< std::string >::type checkpoint_file(checkpoint_fileSEXP);
+    Rcpp::traits::input_parameter< int >::type checkpoint_epochs(checkpoint_epochsSEXP);
+    Rcpp::traits::input_parameter< double >::type checkpoint_seconds(checkpoint_secondsSEXP);
+    Rcpp::traits::input_parameter< bool >::type resume(resumeSEXP);
+    Rcpp::traits::input_parameter< std::string >::type weights_file_prefix(weights_file_prefixSEXP);
+    rcpp_result_gen = Rcpp::wrap(Autoencoder_file(input_file, output_file, format, desired_new_dimension, number_of_training_epochs, learning_rate, num_hidden_layers, hidden_layer_size, error_type, acceptable_error_level, display_rate, shuffle, input_dimension, checkpoint_file, checkpoint_epochs, checkpoint_seconds, resume, weights_file_prefix));
+    return rcpp_result_gen;
+END_RCPP
+}
+// Autoencoder_async
+SEXP Autoencoder_async(NumericMatrix data_in, int desired_new_dimension, int number_of_training_epochs, double learning_rate, int num_hidden_layers, int hidden_layer_size, std::string error_type, double acceptable_error_level, std::string weights_file_prefix);
+RcppExport SEXP _nnlib2Rcpp_Autoencoder_async(SEXP data_inSEXP, SEXP desired_new_dimensionSEXP, SEXP number_of_training_epochsSEXP, SEXP learning_rateSEXP, SEXP num_hidden_layersSEXP, SEXP hidden_layer_sizeSEXP, SEXP error_typeSEXP, SEXP acceptable_error_levelSEXP, SEXP weights_file_prefixSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< NumericMatrix >::type data_in(data_inSEXP);
+    Rcpp::traits::input_parameter< int >::type desired_new_dimension(desired_new_dimensionSEXP);
+    Rcpp::traits::input_parameter< int >::type number_of_training_epochs(number_of_training_epochsSEXP);
+    Rcpp::traits::input_parameter< double >::type learning_rate(learning_rateSEXP);
+    Rcpp::traits::input_parameter< int >::type num_hidden_layers(num_hidden_layersSEXP);
+    Rcpp::traits::input_parameter< int >::type hidden_layer_size(hidden_layer_sizeSEXP);
+    Rcpp::traits::input_parameter< std::string >::type error_type(error_typeSEXP);
+    Rcpp::traits::input_parameter< double >::type acceptable_error_level(acceptable_error_levelSEXP);
+    Rcpp::traits::input_parameter< std::string >::type weights_file_prefix(weights_file_prefixSEXP);
+    rcpp_result_gen = Rcpp::wrap(Autoencoder_async(data_in, desired_new_dimension, number_of_training_epochs, learning_rate, num_hidden_layers, hidden_layer_size, error_type, acceptable_error_level, weights_file_prefix));
+    return rcpp_result_gen;
+END_RCPP
+}
+// Autoencoder_job_status
+List Autoencoder_job_status(SEXP job);
+RcppExport SEXP _nnlib2Rcpp_Autoencoder_job_status(SEXP jobSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type job(jobSEXP);
+    rcpp_result_gen = Rcpp::wrap(Autoencoder_job_status(job));
+    return rcpp_result_gen;
+END_RCPP
+}
+// Autoencoder_job_cancel
+bool Autoencoder_job_cancel(SEXP job);
+RcppExport SEXP _nnlib2Rcpp_Autoencoder_job_cancel(SEXP jobSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type job(jobSEXP);
+    rcpp_result_gen = Rcpp::wrap(Autoencoder_job_cancel(job));
+    return rcpp_result_gen;
+END_RCPP
+}
+// Autoencoder_job_result
+SEXP Autoencoder_job_result(SEXP job, double wait_seconds);
+RcppExport SEXP _nnlib2Rcpp_Autoencoder_job_result(SEXP jobSEXP, SEXP wait_secondsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type job(jobSEXP);
+    Rcpp::traits::input_parameter< double >::type wait_seconds(wait_secondsSEXP);
+    rcpp_result_gen = Rcpp::wrap(Autoencoder_job_result(job, wait_seconds));
     return rcpp_result_gen;
 END_RCPP
 }
 // LVQu
-IntegerVector LVQu(NumericMatrix data, int max_number_of_desired_clusters, int number_of_training_epochs, int neighborhood_size, bool show_nn);
-RcppExport SEXP _nnlib2Rcpp_LVQu(SEXP dataSEXP, SEXP max_number_of_desired_clustersSEXP, SEXP number_of_training_epochsSEXP, SEXP neighborhood_sizeSEXP, SEXP show_nnSEXP) {
+IntegerVector LVQu(NumericMatrix data, int max_number_of_desired_clusters, int number_of_training_epochs, int neighborhood_size, bool show_nn, std::string checkpoint_file, int checkpoint_epochs, double checkpoint_seconds, bool resume, int checkpoint_deltas);
+RcppExport SEXP _nnlib2Rcpp_LVQu(SEXP dataSEXP, SEXP max_number_of_desired_clustersSEXP, SEXP number_of_training_epochsSEXP, SEXP neighborhood_sizeSEXP, SEXP show_nnSEXP, SEXP checkpoint_fileSEXP, SEXP checkpoint_epochsSEXP, SEXP checkpoint_secondsSEXP, SEXP resumeSEXP, SEXP checkpoint_deltasSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
@@ -41,10 +127,85 @@ BEGIN_RCPP
     Rcpp::traits::input_parameter< int >::type number_of_training_epochs(number_of_training_epochsSEXP);
     Rcpp::traits::input_parameter< int >::type neighborhood_size(neighborhood_sizeSEXP);
     Rcpp::traits::input_parameter< bool >::type show_nn(show_nnSEXP);
-    rcpp_result_gen = Rcpp::wrap(LVQu(data, max_number_of_desired_clusters, number_of_training_epochs, neighborhood_size, show_nn));
+    Rcpp::traits::input_parameter< std::string >::type checkpoint_file(checkpoint_fileSEXP);
+    Rcpp::traits::input_parameter< int >::type checkpoint_epochs(checkpoint_epochsSEXP);
+    Rcpp::traits::input_parameter< double >::type checkpoint_seconds(checkpoint_secondsSEXP);
+    Rcpp::traits::input_parameter< bool >::type resume(resumeSEXP);
+    Rcpp::traits::input_parameter< int >::type checkpoint_deltas(checkpoint_deltasSEXP);
+    rcpp_result_gen = Rcpp::wrap(LVQu(data, max_number_of_desired_clusters, number_of_training_epochs, neighborhood_size, show_nn, checkpoint_file, checkpoint_epochs, checkpoint_seconds, resume, checkpoint_deltas));
+    return rcpp_result_gen;
+END_RCPP
+}
+// performance_counters
+NumericVector performance_counters();
+RcppExport SEXP _nnlib2Rcpp_performance_counters() {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    rcpp_result_gen = Rcpp::wrap(performance_counters());
+    return rcpp_result_gen;
+END_RCPP
+}
+// reset_performance_counters
+void reset_performance_counters();
+RcppExport SEXP _nnlib2Rcpp_reset_performance_counters() {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    reset_performance_counters();
+    return R_NilValue;
+END_RCPP
+}
+// get_training_progress
+DataFrame get_training_progress(double since);
+RcppExport SEXP _nnlib2Rcpp_get_training_progress(SEXP sinceSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< double >::type since(sinceSEXP);
+    rcpp_result_gen = Rcpp::wrap(get_training_progress(since));
     return rcpp_result_gen;
 END_RCPP
 }
+// reset_training_progress
+void reset_training_progress();
+RcppExport SEXP _nnlib2Rcpp_reset_training_progress() {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    reset_training_progress();
+    return R_NilValue;
+END_RCPP
+}
+// set_tracing
+bool set_tracing(bool on);
+RcppExport SEXP _nnlib2Rcpp_set_tracing(SEXP onSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< bool >::type on(onSEXP);
+    rcpp_result_gen = Rcpp::wrap(set_tracing(on));
+    return rcpp_result_gen;
+END_RCPP
+}
+// write_trace
+int write_trace(std::string filename);
+RcppExport SEXP _nnlib2Rcpp_write_trace(SEXP filenameSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< std::string >::type filename(filenameSEXP);
+    rcpp_result_gen = Rcpp::wrap(write_trace(filename));
+    return rcpp_result_gen;
+END_RCPP
+}
+// reset_trace
+void reset_trace();
+RcppExport SEXP _nnlib2Rcpp_reset_trace() {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    reset_trace();
+    return R_NilValue;
+END_RCPP
+}
 
 RcppExport SEXP _rcpp_module_boot_class_BP();
 RcppExport SEXP _rcpp_module_boot_class_LVQs();
@@ -52,8 +213,20 @@ RcppExport SEXP _rcpp_module_boot_class_MAM();
 RcppExport SEXP _rcpp_module_boot_class_NN();
 
 static const R_CallMethodDef CallEntries[] = {
-    {"_nnlib2Rcpp_Autoencoder", (DL_FUNC) &_nnlib2Rcpp_Autoencoder, 10},
-    {"_nnlib2Rcpp_LVQu", (DL_FUNC) &_nnlib2Rcpp_LVQu, 5},
+    {"_nnlib2Rcpp_Autoencoder", (DL_FUNC) &_nnlib2Rcpp_Autoencoder, 15},
+    {"_nnlib2Rcpp_Autoencoder_file", (DL_FUNC) &_nnlib2Rcpp_Autoencoder_file, 18},
+    {"_nnlib2Rcpp_Autoencoder_async", (DL_FUNC) &_nnlib2Rcpp_Autoencoder_async, 9},
+    {"_nnlib2Rcpp_Autoencoder_job_status", (DL_FUNC) &_nnlib2Rcpp_Autoencoder_job_status, 1},
+    {"_nnlib2Rcpp_Autoencoder_job_cancel", (DL_FUNC) &_nnlib2Rcpp_Autoencoder_job_cancel, 1},
+    {"_nnlib2Rcpp_Autoencoder_job_result", (DL_FUNC) &_nnlib2Rcpp_Autoencoder_job_result, 2},
+    {"_nnlib2Rcpp_LVQu", (DL_FUNC) &_nnlib2Rcpp_LVQu, 10},
+    {"_nnlib2Rcpp_performance_counters", (DL_FUNC) &_nnlib2Rcpp_performance_counters, 0},
+    {"_nnlib2Rcpp_reset_performance_counters", (DL_FUNC) &_nnlib2Rcpp_reset_performance_counters, 0},
+    {"_nnlib2Rcpp_get_training_progress", (DL_FUNC) &_nnlib2Rcpp_get_training_progress, 1},
+    {"_nnlib2Rcpp_reset_training_progress", (DL_FUNC) &_nnlib2Rcpp_reset_training_progress, 0},
+    {"_nnlib2Rcpp_set_tracing", (DL_FUNC) &_nnlib2Rcpp_set_tracing, 1},
+    {"_nnlib2Rcpp_write_trace", (DL_FUNC) &_nnlib2Rcpp_write_trace, 1},
+    {"_nnlib2Rcpp_reset_trace", (DL_FUNC) &_nnlib2Rcpp_reset_trace, 0},
     {"_rcpp_module_boot_class_BP", (DL_FUNC) &_rcpp_module_boot_class_BP, 0},
     {"_rcpp_module_boot_class_LVQs", (DL_FUNC) &_rcpp_module_boot_class_LVQs, 0},
     {"_rcpp_module_boot_class_MAM", (DL_FUNC) &_rcpp_module_boot_class_MAM, 0},
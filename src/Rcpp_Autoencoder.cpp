@@ -12,6 +12,10 @@ using namespace Rcpp;
 //--------------------------------------------------------------------------------
 
 #include "nn_bp.h"
+#include "nnlib2_checkpoint.h"
+#include "Rcpp_dataset.h"
+#include "Rcpp_training_job.h"
+#include <fstream>
 
 using namespace nnlib2;
 using namespace nnlib2::bp;
@@ -29,7 +33,12 @@ NumericMatrix Autoencoder  (
                            bool show_nn = false,
                            std::string error_type = "MAE",
                            double acceptable_error_level = 0,
-                           int display_rate = 1000
+                           int display_rate = 1000,
+                           std::string checkpoint_file = "",        // if not empty, take checkpoints (to resume training) in this file...
+                           int checkpoint_epochs = 0,               // ...every this many epochs...
+                           double checkpoint_seconds = 0,           // ...and/or seconds.
+                           bool resume = false,                     // continue training from checkpoint_file (if it exists)
+                           std::string weights_file_prefix = ""     // if not empty, store weights on disk (see bp_nn::store_weights_on_disk)
                            )
  {
  TEXTOUT << "acceptable error level = " << acceptable_error_level << "\n";
@@ -45,6 +54,7 @@ NumericMatrix Autoencoder  (
  data_out=NumericMatrix(num_training_cases,desired_new_dimension);
 
  bpu_autoencoder_nn ae;
+ if(NOT weights_file_prefix.empty()) ae.store_weights_on_disk(weights_file_prefix);   // (before setup, so weights are created on disk)
  if( ae.no_error()) ae.setup(input_dimension, learning_rate, num_hidden_layers, hidden_layer_size, desired_new_dimension);
  if(NOT ae.no_error()) return(data_out);
 
@@ -70,24 +80,43 @@ NumericMatrix Autoencoder  (
  TEXTOUT << "Max number of epochs = " << number_of_training_epochs << "\n";
  DATA error_level = 0;
 
- for(int i=0;(i<number_of_training_epochs) && ae.no_error();i++)
+ checkpoint_writer checkpoints;
+ checkpoints.setup(checkpoint_file, checkpoint_epochs, checkpoint_seconds);
+
+ int first_epoch = 0;
+ if(resume)
+  {
+  if(NOT std::ifstream(checkpoint_file.c_str()))
+   TEXTOUT << "No checkpoint file found, training starts from first epoch.\n";
+  else
+   {
+   if(NOT load_checkpoint(ae, checkpoint_file, first_epoch, true)) return data_out;
+   TEXTOUT << "Training resumes from checkpoint (" << first_epoch << " epochs completed).\n";
+   }
+  }
+
+ row_major_dataset dataset(data_in);                                // (rows copied once, see Rcpp_dataset.h)
+
+ epoch_counter epochs_timed("Autoencoder");					// (rows/sec per epoch and progress records, see nnlib2_counters.h)
+ interval_timer interrupt_checks(NN_INTERRUPT_CHECK_SECONDS);
+ for(int i=first_epoch;(i<number_of_training_epochs) && ae.no_error();i++)
   {
     for(int r=0;r<num_training_cases;r++)
       {
-      NumericVector v(data_in( r , _ ));                            // my (lame?) way to interface with R. Remember, NumericMatrix stores data row-first, as R does.
-      double * fp_v = REAL(v);                                      // my (lame?) way to interface with R, cont.)
+      DATA * fp_v = dataset.row(r);
 
-      error_level += ae.encode_s(fp_v, v.size(), fp_v, v.size());
+      error_level += ae.encode_s(fp_v, input_dimension, fp_v, input_dimension);
       }
 
     error_level = error_level/(num_training_cases);					// compute MAE or MSE
 
+    epochs_timed.epoch_done(num_training_cases, i+1, error_level);
+    checkpoints.checkpoint_if_due(ae, i+1);							// (written in background)
+    if(interrupt_checks.due()) checkUserInterrupt();				// (RCpp function to check if user pressed cancel)
+
     if(display_rate>0)
     if(i%display_rate==0)
-      {
-      checkUserInterrupt();                                       // (RCpp function to check if user pressed cancel)
       TEXTOUT << "Epoch = "<< i << " , error level = " << error_level << "\n";
-      }
 
     if(error_level<=acceptable_error_level)
       {
@@ -99,6 +128,8 @@ NumericMatrix Autoencoder  (
       }
   }
 
+ checkpoints.finish();
+
  TEXTOUT << "Training ended , error level = " << error_level << "\n\n";
 
  if(show_nn)
@@ -108,21 +139,297 @@ NumericMatrix Autoencoder  (
    TEXTOUT << "--------Network structure (END)--------\n";
  }
 
- NumericVector v_out(desired_new_dimension);                        // buffer for output
- double * fp_out = REAL(v_out);                                     // buffer for output (as double *)
+ row_major_dataset output(num_training_cases,desired_new_dimension);  // (copied to R matrix once, at the end)
 
  for(int r=0;r<num_training_cases;r++)
+   ae.recall(dataset.row(r), input_dimension, output.row(r), desired_new_dimension);
+
+ data_out = output.to_matrix();
+ return data_out;
+ }
+
+//--------------------------------------------------------------------------------
+// as above, but data is streamed (in chunks) from a data set file and results
+// written to another (in the same format, "csv" or "binary"), for data sets too
+// large for memory. Returns the number of rows written (-1 if failed).
+
+// [[Rcpp::export]]
+double Autoencoder_file  (
+                         std::string input_file,
+                         std::string output_file,
+                         std::string format,                      // "csv" or "binary" (both files)
+                         int desired_new_dimension,
+                         int number_of_training_epochs,           // (each presents all data)
+                         double learning_rate,
+                         int num_hidden_layers = 1,               // number of hidden layers on each side of special layer
+                         int hidden_layer_size = 5,               // number of nodes in each hidden layer
+                         std::string error_type = "MAE",
+                         double acceptable_error_level = 0,
+                         int display_rate = 1000,
+                         bool shuffle = true,                     // present chunks in different (random) order in each epoch
+                         int input_dimension = 0,                 // number of columns in input file (required for binary files)
+                         std::string checkpoint_file = "",        // if not empty, take checkpoints (to resume training) in this file...
+                         int checkpoint_epochs = 0,               // ...every this many epochs...
+                         double checkpoint_seconds = 0,           // ...and/or seconds.
+                         bool resume = false,                     // continue training from checkpoint_file (if it exists)
+                         std::string weights_file_prefix = ""     // if not empty, store weights on disk (see bp_nn::store_weights_on_disk)
+                         )
  {
-   NumericVector v(data_in( r , _ ));                               // my (lame?) way to interface with R. Remember, NumericMatrix stores data row-first, as R does.
-   double * fp_v = REAL(v);                                         // my (lame?) way to interface with R, cont.)
+ dataset_stream dataset;
+ if(NOT open_dataset_file(dataset, input_file, format, input_dimension)) return -1;
+ input_dimension = dataset.cols();
 
-   ae.recall(fp_v, v.size(), fp_out, desired_new_dimension);
+ if(desired_new_dimension<=0) return -1;
 
-   data_out( r , _ ) = v_out;                                       // my (lame?) way to interface with R, cont.)
+ bpu_autoencoder_nn ae;
+ if(NOT weights_file_prefix.empty()) ae.store_weights_on_disk(weights_file_prefix);   // (before setup, so weights are created on disk)
+ if( ae.no_error()) ae.setup(input_dimension, learning_rate, num_hidden_layers, hidden_layer_size, desired_new_dimension);
+ if(NOT ae.no_error()) return -1;
+
+ if((error_type!="MAE") AND
+    (error_type!="MSE"))
+ {
+ 	error_type="MAE";
+  	warning("Unsupported error type (must be 'MAE' or 'MSE'). Using and displaying Mean Absolute Error (MAE)");
  }
 
- return data_out;
+ ae.m_use_squared_error = (error_type=="MSE");
+
+ if(acceptable_error_level<0) acceptable_error_level=0;
+ if(display_rate<0) display_rate=1000;
+
+ TEXTOUT << "Max number of epochs = " << number_of_training_epochs << "\n";
+ DATA error_level = 0;
+
+ checkpoint_writer checkpoints;
+ checkpoints.setup(checkpoint_file, checkpoint_epochs, checkpoint_seconds);
+
+ int first_epoch = 0;
+ if(resume)
+  {
+  if(NOT std::ifstream(checkpoint_file.c_str()))
+   TEXTOUT << "No checkpoint file found, training starts from first epoch.\n";
+  else
+   {
+   if(NOT load_checkpoint(ae, checkpoint_file, first_epoch, true)) return -1;
+   TEXTOUT << "Training resumes from checkpoint (" << first_epoch << " epochs completed).\n";
+   }
+  }
+
+ int rows;
+ DATA PTR chunk;
+
+ epoch_counter epochs_timed("Autoencoder");					// (rows/sec per epoch and progress records, see nnlib2_counters.h)
+ interval_timer interrupt_checks(NN_INTERRUPT_CHECK_SECONDS);
+ for(int i=first_epoch;(i<number_of_training_epochs) && ae.no_error();i++)
+  {
+    error_level = 0;
+    dataset.start_epoch(shuffle);                                 // (next chunk is read in background while current is used)
+    while((chunk=dataset.next_chunk(rows))!=NULL)
+      {
+      for(int r=0;r<rows;r++)
+        {
+        DATA * fp_v = chunk + (size_t) r * input_dimension;
+        error_level += ae.encode_s(fp_v, input_dimension, fp_v, input_dimension);
+        }
+      if(interrupt_checks.due()) checkUserInterrupt();            // (RCpp function to check if user pressed cancel)
+      }
+    if(NOT dataset.no_error()) return -1;
+
+    error_level = error_level/(DATA)(dataset.rows());				// compute MAE or MSE
+    epochs_timed.epoch_done(dataset.rows(), i+1, error_level);
+    checkpoints.checkpoint_if_due(ae, i+1);							// (written in background)
+
+    if(display_rate>0)
+    if(i%display_rate==0)
+      TEXTOUT << "Epoch = "<< i << " , error level = " << error_level << "\n";
+
+    if(error_level<=acceptable_error_level)
+      {
+      TEXTOUT << "Epoch = "<< i << " , error level = " << error_level << "\n";
+      TEXTOUT << "Training reached acceptable error level ( ";
+      TEXTOUT << error_type << " ";
+      TEXTOUT << error_level << " <= " << acceptable_error_level << " )\n";
+      break;
+      }
+  }
+
+ checkpoints.finish();
+
+ TEXTOUT << "Training ended , error level = " << error_level << "\n\n";
+
+ dataset_file_writer results;
+ dataset_file_format output_format;
+ dataset_file_format_from_name(format, output_format);            // (already checked)
+ if(NOT results.open(output_file, output_format, desired_new_dimension)) return -1;
+
+ std::vector<DATA> output;
+ dataset.start_epoch(false);                                      // (results are written in input order)
+ while((chunk=dataset.next_chunk(rows))!=NULL)
+   {
+   output.resize((size_t) rows * desired_new_dimension);
+   for(int r=0;r<rows;r++)
+     ae.recall(chunk + (size_t) r * input_dimension, input_dimension, output.data() + (size_t) r * desired_new_dimension, desired_new_dimension);
+   if(NOT results.write_rows(output.data(), rows)) return -1;
+   }
+ if(NOT dataset.no_error()) return -1;
+ if(NOT results.close()) return -1;
+
+ return (double) results.rows_written();
  }
 
 
+//--------------------------------------------------------------------------------
+// Autoencoder trained in the background: Autoencoder_async sets up the NN and
+// starts training in a separate thread, returning at once a job (R external
+// pointer of class "Autoencoder_job"). Use the other Autoencoder_job_ functions
+// below to get its status, cancel it, or wait for it and get the results.
+
+struct autoencoder_job
+ {
+ bpu_autoencoder_nn ae;
+ row_major_dataset dataset;                                         // (copied, R objects cannot be used by the job)
+ int desired_new_dimension;
+ double acceptable_error_level;
+ training_job job;                                                  // (last, so that it is stopped first when deleted)
+
+ autoencoder_job(NumericMatrix data_in) : dataset(data_in) { desired_new_dimension = 0; acceptable_error_level = 0; }
+
+ bool train(int number_of_training_epochs)                         // (runs in job's thread)
+  {
+  int input_dimension    = dataset.cols();
+  int num_training_cases = dataset.rows();
+
+  epoch_counter epochs_timed("Autoencoder");					// (rows/sec per epoch and progress records, see nnlib2_counters.h)
+  for(int i=0;(i<number_of_training_epochs) && ae.no_error() && NOT job.cancel_requested();i++)
+   {
+   DATA error_level = 0;
+   for(int r=0;r<num_training_cases;r++)
+     error_level += ae.encode_s(dataset.row(r), input_dimension, dataset.row(r), input_dimension);
+   error_level = error_level/(num_training_cases);				// compute MAE or MSE
+
+   epochs_timed.epoch_done(num_training_cases, i+1, error_level);
+   job.epoch_done(i+1, error_level);
+
+   if(error_level<=acceptable_error_level) break;
+   }
+  return ae.no_error();
+  }
+ };
+
+//--------------------------------------------------------------------------------
+
+static autoencoder_job PTR autoencoder_job_from(SEXP job)
+ {
+ if(NOT Rf_inherits(job,"Autoencoder_job"))
+  {
+  error(NN_NULLPT_ERR,"Not an Autoencoder job (see Autoencoder_async)");
+  return NULL;
+  }
+ XPtr<autoencoder_job> p(job);
+ return p.get();
+ }
+
+//--------------------------------------------------------------------------------
+
+// [[Rcpp::export]]
+SEXP Autoencoder_async  (
+                        NumericMatrix data_in,
+                        int desired_new_dimension,
+                        int number_of_training_epochs,            // (each presents all data)
+                        double learning_rate,
+                        int num_hidden_layers = 1,                // number of hidden layers on each side of special layer
+                        int hidden_layer_size = 5,                // number of nodes in each hidden layer
+                        std::string error_type = "MAE",
+                        double acceptable_error_level = 0,
+                        std::string weights_file_prefix = ""      // if not empty, store weights on disk (see bp_nn::store_weights_on_disk)
+                        )
+ {
+ int input_dimension    = data_in.cols();
+ int num_training_cases = data_in.rows();
+
+ if (input_dimension       <= 0) return R_NilValue;
+ if (num_training_cases    <= 0) return R_NilValue;
+ if (desired_new_dimension <= 0) return R_NilValue;
+
+ if((error_type!="MAE") AND
+    (error_type!="MSE"))
+ {
+ 	error_type="MAE";
+  	warning("Unsupported error type (must be 'MAE' or 'MSE'). Using and displaying Mean Absolute Error (MAE)");
+ }
+
+ autoencoder_job PTR p = new autoencoder_job(data_in);
+ XPtr<autoencoder_job> job(p, true);                               // (deleted when R no longer uses it, cancelling training)
+ job.attr("class") = "Autoencoder_job";
+
+ if(NOT weights_file_prefix.empty()) p->ae.store_weights_on_disk(weights_file_prefix);   // (before setup, so weights are created on disk)
+ if( p->ae.no_error()) p->ae.setup(input_dimension, learning_rate, num_hidden_layers, hidden_layer_size, desired_new_dimension);
+ if(NOT p->ae.no_error()) return R_NilValue;
+
+ p->ae.m_use_squared_error = (error_type=="MSE");
+ p->desired_new_dimension  = desired_new_dimension;
+ p->acceptable_error_level = (acceptable_error_level<0) ? 0 : acceptable_error_level;
+
+ if(NOT p->job.start(number_of_training_epochs, [p,number_of_training_epochs]() { return p->train(number_of_training_epochs); }))
+  {
+  error(NN_SYSTEM_ERR,"Cannot start background training");
+  return R_NilValue;
+  }
+
+ TEXTOUT << "Autoencoder training started in background (max number of epochs = " << number_of_training_epochs << ").\n";
+ return job;
+ }
+
+//--------------------------------------------------------------------------------
+// state ("running", "completed", "cancelled" or "failed"), epochs completed,
+// last error level and time elapsed.
+
+// [[Rcpp::export]]
+List Autoencoder_job_status(SEXP job)
+ {
+ autoencoder_job PTR p = autoencoder_job_from(job);
+ if(p==NULL) return List();
+ flush_pending_messages();
+ return training_job_status(p->job);
+ }
+
+//--------------------------------------------------------------------------------
+// request training to stop (after current epoch); true if it was running.
+
+// [[Rcpp::export]]
+bool Autoencoder_job_cancel(SEXP job)
+ {
+ autoencoder_job PTR p = autoencoder_job_from(job);
+ if(p==NULL) return false;
+ return p->job.cancel();
+ }
+
+//--------------------------------------------------------------------------------
+// wait for training to finish (up to wait_seconds, negative waits until it
+// finishes) and return the data encoded by the trained (or, if cancelled,
+// partially trained) NN. Returns NULL if still running, or if training failed.
+
+// [[Rcpp::export]]
+SEXP Autoencoder_job_result(SEXP job, double wait_seconds = -1)
+ {
+ autoencoder_job PTR p = autoencoder_job_from(job);
+ if(p==NULL) return R_NilValue;
+
+ if(NOT wait_for_training_job(p->job, wait_seconds)) return R_NilValue;
+ if(p->job.state()==job_failed) return R_NilValue;
+
+ int input_dimension    = p->dataset.cols();
+ int num_training_cases = p->dataset.rows();
+
+ row_major_dataset output(num_training_cases,p->desired_new_dimension);  // (copied to R matrix once, at the end)
+
+ for(int r=0;r<num_training_cases;r++)
+   p->ae.recall(p->dataset.row(r), input_dimension, output.row(r), p->desired_new_dimension);
+
+ return output.to_matrix();
+ }
+
+//--------------------------------------------------------------------------------
+
 #endif // NNLIB2_FOR_RCPP
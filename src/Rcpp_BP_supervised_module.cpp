@@ -11,8 +11,14 @@
 //--------------------------------------------------------------------------------
 
 #include "nn_bp.h"
+#include "nnlib2_checkpoint.h"
+#include "Rcpp_dataset.h"
+#include "Rcpp_profile.h"
+#include "Rcpp_training_job.h"
 #include <iostream>
 #include <fstream>
+#include <chrono>
+#include <memory>
 
 using namespace nnlib2;
 using namespace nnlib2::bp;
@@ -33,6 +39,49 @@ protected:
 
   bool m_mute_training_output;
 
+  checkpoint_writer m_checkpoints;
+  int m_resume_from_epoch;                              // next train_multiple continues from this epoch (set by resume)
+
+  snapshot_publisher m_published;                      // snapshot for recall_published (see publish), usable while training
+  int m_publish_every_epochs;                           // background training publishes a snapshot every this many epochs (0 disables)
+
+  training_job m_job;                                   // training in background (see train_async). Other methods wait for it to finish.
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // epoch loop of train_async, runs in the job's thread: no R objects, output or
+  // user interrupt checks here (progress is polled with training_status).
+
+  bool train_epochs_in_background(std::shared_ptr<row_major_dataset> dataset_in,
+                                  std::shared_ptr<row_major_dataset> dataset_out,
+                                  int first_epoch,
+                                  int training_epochs)
+  {
+    int num_training_cases = dataset_in->rows();
+
+    epoch_counter epochs_timed("BP");					// (rows/sec per epoch and progress records, see nnlib2_counters.h)
+    for(int i=first_epoch;i<training_epochs && bp.is_ready() && !m_job.cancel_requested();i++)
+    {
+      DATA mean_error_for_dataset = 0;
+
+      for(int r=0;r<num_training_cases;r++)
+        mean_error_for_dataset = mean_error_for_dataset + bp.encode_s(dataset_in->row(r), dataset_in->cols(), dataset_out->row(r), dataset_out->cols());
+
+      mean_error_for_dataset = mean_error_for_dataset / num_training_cases;
+
+      epochs_timed.epoch_done(num_training_cases, i+1, mean_error_for_dataset);
+      m_job.epoch_done(i+1, mean_error_for_dataset);
+      m_checkpoints.checkpoint_if_due(bp,i+1);          // (written in background)
+      if((m_publish_every_epochs>0) AND (((i+1-first_epoch)%m_publish_every_epochs)==0))
+        m_published.publish(bp.make_snapshot());
+
+      if(mean_error_for_dataset<=m_acceptable_error_level) break;
+    }
+
+    m_checkpoints.finish();
+    if(m_publish_every_epochs>0) m_published.publish(bp.make_snapshot());	// (final weights)
+    return bp.no_error();
+  }
+
 public:
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -43,6 +92,22 @@ public:
   bp.reset();
   set_error_level("MAE",0);
   m_mute_training_output = false;
+  m_resume_from_epoch = 0;
+  m_publish_every_epochs = 0;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // (used by clone, source must not be training)
+
+  BP(BP REF source)
+  {
+  bp.reset();
+  m_acceptable_error_level = source.m_acceptable_error_level;
+  m_error_type = source.m_error_type;
+  m_mute_training_output = source.m_mute_training_output;
+  m_resume_from_epoch = 0;
+  m_publish_every_epochs = source.m_publish_every_epochs;
+  if(!bp.clone_from(source.bp)) bp.reset();
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -55,6 +120,7 @@ public:
               int hidden_layers,
               int hidden_layer_size)
   {
+    finish_training_job(m_job,"BP");
     int input_dim  = data_in.cols();
     int output_dim = data_out.cols();
 
@@ -67,12 +133,14 @@ public:
 
   bool setup(int input_dim, int output_dim, double learning_rate, int hidden_layers, int hidden_layer_size)
   {
+    finish_training_job(m_job,"BP");
     if(!bp.setup(input_dim, output_dim, learning_rate, hidden_layers, hidden_layer_size))
       {
         error(NN_INTEGR_ERR,"Cannot setup BP NN");
         bp.reset();
         return false;
       }
+    m_resume_from_epoch = 0;
     return true;
   }
 
@@ -83,6 +151,7 @@ public:
                          NumericMatrix data_out,
                          int training_epochs)
   {
+    finish_training_job(m_job,"BP");
     if((data_in.rows()<=0) OR
          (data_in.rows()!=data_out.rows()))
     {
@@ -96,29 +165,37 @@ public:
 
     if(m_mute_training_output) TEXTOUT << "Training...\n";
 
-    for(int i=0;i<training_epochs && bp.is_ready();i++)
+    int first_epoch = m_resume_from_epoch;              // (skip epochs completed before checkpoint)
+    m_resume_from_epoch = 0;
+    m_checkpoints.start();
+
+    row_major_dataset dataset_in(data_in);              // (rows copied once, see Rcpp_dataset.h)
+    row_major_dataset dataset_out(data_out);
+
+    epoch_counter epochs_timed("BP");					// (rows/sec per epoch and progress records, see nnlib2_counters.h)
+    interval_timer interrupt_checks(NN_INTERRUPT_CHECK_SECONDS);
+    for(int i=first_epoch;i<training_epochs && bp.is_ready();i++)
     {
 
       DATA mean_error_for_dataset = 0;
 
       for(int r=0;r<num_training_cases;r++)
       {
-        NumericVector v_in  = data_in( r , _ );         // (interface with R)
-        NumericVector v_out = data_out( r , _ );        // (interface with R)
         // Encode a case item pair (supervised)
-        error_level = train_single (v_in,v_out);
+        error_level = bp.encode_s(dataset_in.row(r), dataset_in.cols(), dataset_out.row(r), dataset_out.cols());
 
         mean_error_for_dataset = mean_error_for_dataset +  error_level;
       }
 
       mean_error_for_dataset = mean_error_for_dataset / num_training_cases;
 
+      epochs_timed.epoch_done(num_training_cases, i+1, mean_error_for_dataset);
+      m_checkpoints.checkpoint_if_due(bp,i+1);          // (written in background)
+      if(interrupt_checks.due()) checkUserInterrupt();  // (RCpp function to check if user pressed cancel)
+
       if(NOT m_mute_training_output)
       if(i%1000==0)
-      {
         TEXTOUT << "Epoch = "<< i << " , error level = " << mean_error_for_dataset << "\n";
-        checkUserInterrupt();                           // (RCpp function to check if user pressed cancel)
-      }
 
       if(mean_error_for_dataset<=m_acceptable_error_level)
       {
@@ -131,6 +208,88 @@ public:
 
     }
 
+    m_checkpoints.finish();
+
+    TEXTOUT << "Training Finished, error level is " << error_level << " .\n";
+    return error_level;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // Encode input-output pairs read (in chunks, streamed) from a data set file,
+  // for data sets too large for memory. BP must be already set up; each row
+  // contains the input values followed by the desired output values. If shuffle
+  // is true, chunks are presented in different (random) order in each epoch.
+
+  double train_from_file (std::string filename,
+                          std::string format,
+                          int training_epochs,
+                          bool shuffle)
+  {
+    finish_training_job(m_job,"BP");
+    if(!bp.is_ready())
+    {
+      error(NN_INTEGR_ERR,"BP is not set up (use setup before training from file)");
+      return DATA_MAX;
+    }
+
+    int input_dim  = bp.input_dimension();
+    int output_dim = bp.output_dimension();
+
+    dataset_stream dataset;
+    if(!open_dataset_file(dataset,filename,format,input_dim+output_dim)) return DATA_MAX;
+
+    DATA error_level = DATA_MAX;
+
+    if(m_mute_training_output) TEXTOUT << "Training...\n";
+
+    int first_epoch = m_resume_from_epoch;              // (skip epochs completed before checkpoint)
+    m_resume_from_epoch = 0;
+    m_checkpoints.start();
+
+    epoch_counter epochs_timed("BP");					// (rows/sec per epoch and progress records, see nnlib2_counters.h)
+    interval_timer interrupt_checks(NN_INTERRUPT_CHECK_SECONDS);
+    for(int i=first_epoch;i<training_epochs && bp.is_ready();i++)
+    {
+      DATA mean_error_for_dataset = 0;
+      int64_t cases = 0;
+      int rows;
+      DATA PTR chunk;
+
+      dataset.start_epoch(shuffle);                      // (next chunk is read in background while current is used)
+      while((chunk=dataset.next_chunk(rows))!=NULL)
+      {
+        for(int r=0;r<rows;r++)
+        {
+          DATA PTR row = chunk + (size_t) r * (input_dim+output_dim);
+          error_level = bp.encode_s(row, input_dim, row+input_dim, output_dim);
+          mean_error_for_dataset = mean_error_for_dataset + error_level;
+        }
+        cases += rows;
+        if(interrupt_checks.due()) checkUserInterrupt();
+      }
+      if(!dataset.no_error()) break;
+
+      mean_error_for_dataset = mean_error_for_dataset / cases;
+
+      epochs_timed.epoch_done(cases, i+1, mean_error_for_dataset);
+      m_checkpoints.checkpoint_if_due(bp,i+1);          // (written in background)
+
+      if(NOT m_mute_training_output)
+      if(i%1000==0)
+        TEXTOUT << "Epoch = "<< i << " , error level = " << mean_error_for_dataset << "\n";
+
+      if(mean_error_for_dataset<=m_acceptable_error_level)
+      {
+      	TEXTOUT << "Epoch = "<< i << " , error level indication = " << mean_error_for_dataset << "\n";
+      	TEXTOUT << "Training reached acceptable error level ( ";
+      	TEXTOUT << m_error_type << " ";
+      	TEXTOUT << mean_error_for_dataset << " <= " << m_acceptable_error_level << " )\n";
+      	break;
+      }
+    }
+
+    m_checkpoints.finish();
+
     TEXTOUT << "Training Finished, error level is " << error_level << " .\n";
     return error_level;
   }
@@ -141,6 +300,7 @@ public:
   double train_single (NumericVector data_in,
                        NumericVector data_out)
   {
+    finish_training_job(m_job,"BP");
     if(!bp.is_ready())   return DATA_MAX;
 
     double *fpdata_in   = data_in.begin();             // (interface with R)
@@ -160,29 +320,127 @@ public:
 
   NumericMatrix recall(NumericMatrix data_in)
   {
-    NumericMatrix data_out;
+    finish_training_job(m_job,"BP");
+    row_major_dataset dataset_in(data_in);              // (rows copied once, see Rcpp_dataset.h)
+    row_major_dataset dataset_out(data_in.rows(),bp.output_dimension());
 
-    data_out= NumericMatrix(data_in.rows(),bp.output_dimension());
+    for(int r=0;r<dataset_in.rows();r++)
+      bp.recall(dataset_in.row(r), dataset_in.cols(), dataset_out.row(r), dataset_out.cols());
 
-    for(int r=0;r<data_in.rows();r++)
+    return dataset_out.to_matrix();
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // Get output for a data set file, writing it to another file (in the same
+  // format), for data sets too large for memory. Input rows are read and output
+  // rows written in chunks by background threads, while the BP recalls the
+  // current chunk. Returns number of rows written (-1 if failed).
+
+  double recall_file(std::string input_file, std::string output_file, std::string format)
+  {
+    finish_training_job(m_job,"BP");
+    if(!bp.is_ready())
     {
-      NumericVector v_in(data_in( r , _ ));               // my (lame?) way to interface with R. Remember, NumericMatrix stores data row-first, as R does.
-      double * fpdata_in = REAL(v_in);                    // my (lame?) way to interface with R, cont.)
-      NumericVector v_out = data_out( r , _ );            // my (lame?) way to interface with R, cont.)
-      double *fpdata_out = REAL(v_out);                   // my (lame?) way to interface with R, cont.)
+      error(NN_INTEGR_ERR,"BP is not ready (encode, setup or load it first)");
+      return -1;
+    }
+
+    int input_dim  = bp.input_dimension();
+    int output_dim = bp.output_dimension();
 
-      bp.recall(fpdata_in, data_in.cols(), fpdata_out, data_out.cols());
+    dataset_pipeline pipeline;
+    if(!open_dataset_pipeline(pipeline,input_file,output_file,format,input_dim,output_dim)) return -1;
 
-      data_out( r , _ ) = v_out;                          // my (lame?) way to interface with R. Copy result vector back to matrix. Remember, NumericMatrix stores data row-first, as R does.
+    dataset_chunk in, out;
+    while(pipeline.next(in))
+    {
+      out.rows = in.rows;
+      out.values.resize((size_t) in.rows * output_dim);
+      for(int r=0;r<in.rows;r++)
+        bp.recall(in.values.data() + (size_t) r * input_dim, input_dim, out.values.data() + (size_t) r * output_dim, output_dim);
+      if(!pipeline.put(out)) break;                     // (written in background)
+      checkUserInterrupt();
     }
 
+    if(!pipeline.finish()) return -1;
+    return (double) pipeline.rows_written();
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // per-component profile: when enabled, encode and recall of each component are
+  // timed (see nnlib2_profiler.h). Enabling also clears previous records.
+
+  bool set_profiling(bool enable)
+  {
+    finish_training_job(m_job,"BP");
+    if(enable) bp.profiler().reset();
+    bp.profiler().enable(enable);
+    return bp.profiler().enabled();
+  }
+
+  DataFrame get_profile()
+  {
+    finish_training_job(m_job,"BP");
+    return profile_data_frame(bp);
+  }
+
+  void reset_profile()
+  {
+    finish_training_job(m_job,"BP");
+    bp.profiler().reset();
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // Get output for a single input vector, using the fast (frozen) recall path.
+  // Falls back to regular recall if the fast path is not possible.
+
+  NumericVector recall_single(NumericVector data_in)
+  {
+    finish_training_job(m_job,"BP");
+    NumericVector data_out(bp.output_dimension());
+    if(data_out.length()<=0) return data_out;
+
+    if(!bp.recall_frozen(data_in.begin(), data_in.length(), data_out.begin(), data_out.length()))
+      bp.recall(data_in.begin(), data_in.length(), data_out.begin(), data_out.length());
+
     return data_out;
   }
 
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // Measure average time (in microseconds) of fast single vector recall (in C++,
+  // i.e. excluding R call overhead). Returns negative value if not possible.
+
+  double recall_single_latency(NumericVector data_in, int repetitions)
+  {
+    finish_training_job(m_job,"BP");
+    if(repetitions<=0) return -1;
+    NumericVector data_out(bp.output_dimension());
+    if(data_out.length()<=0) return -1;
+
+    double * fpdata_in  = data_in.begin();
+    double * fpdata_out = data_out.begin();
+    int input_dim  = data_in.length();
+    int output_dim = data_out.length();
+
+    if(!bp.recall_frozen(fpdata_in, input_dim, fpdata_out, output_dim))  // (also warms up)
+      {
+      warning("Fast recall is not possible for this NN (check input vector length)");
+      return -1;
+      }
+
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+    for(int i=0;i<repetitions;i++)
+      bp.recall_frozen(fpdata_in, input_dim, fpdata_out, output_dim);
+    std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double,std::micro>(t1-t0).count()/repetitions;
+  }
+
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
   bool set_error_level(std::string error_type, DATA acceptable_error_level)
   {
+    finish_training_job(m_job,"BP");
   	if((error_type!="MAE") AND
        (error_type!="MSE"))
   	{
@@ -213,6 +471,7 @@ public:
 
   bool mute(bool on)
   {
+    finish_training_job(m_job,"BP");
   	m_mute_training_output = on;
   	return on;
   }
@@ -221,6 +480,7 @@ public:
 
   bool save_to_file(std::string filename)
   {
+    finish_training_job(m_job,"BP");
     std::ofstream outfile;
     outfile.open(filename);
     bp.to_stream(outfile);
@@ -231,8 +491,26 @@ public:
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
+  bool save_binary_to_file(std::string filename)
+  {
+    finish_training_job(m_job,"BP");
+    if(!bp.save_binary(filename)) return false;
+    TEXTOUT << "BP NN saved to (binary) file " << filename << "\n";
+    return true;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
   bool load_from_file(std::string filename)
   {
+    finish_training_job(m_job,"BP");
+    if(binary_model_file::is_binary_model_file(filename))         // (format is detected automatically)
+    {
+      if(!bp.load_binary(filename)) return false;
+      TEXTOUT << "BP NN loaded from (binary) file " << filename << "\n";
+      return true;
+    }
+
     std::ifstream infile;
     infile.open(filename);
     if(!infile) {error(NN_IOFILE_ERR,"File cannot be opened");return false;}
@@ -242,10 +520,273 @@ public:
     return true;
   }
 
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // weights are not copied, but used in place from (memory-mapped) binary file,
+  // shared by all R processes that load it this way.
+
+  bool load_for_inference(std::string filename)
+  {
+    finish_training_job(m_job,"BP");
+    if(!binary_model_file::is_binary_model_file(filename))
+    {
+      warning("Not a binary BP file (use save_binary to create one)");
+      return false;
+    }
+    if(!bp.load_binary_in_place(filename)) return false;
+    TEXTOUT << "BP NN loaded from (binary) file " << filename << " (weights used in place)\n";
+    return true;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // take checkpoints (BP and training state) while training with train_multiple
+  // or encode, every_epochs and/or every_seconds (0 if not used). They are written
+  // to file in background. Empty filename disables checkpoints.
+
+  bool set_checkpoints(std::string filename, int every_epochs, double every_seconds)
+  {
+    finish_training_job(m_job,"BP");
+    if(!m_checkpoints.setup(filename,every_epochs,every_seconds))
+    {
+      TEXTOUT << "BP checkpoints are disabled\n";
+      return false;
+    }
+    TEXTOUT << "BP checkpoints will be saved to file " << filename << "\n";
+    return true;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // between full checkpoints, take up to max_deltas delta checkpoints, which only
+  // append the changed values to a file (checkpoint filename + ".delta"); useful
+  // if training changes few weights per epoch. 0 (default) disables them.
+
+  bool set_delta_checkpoints(int max_deltas)
+  {
+    finish_training_job(m_job,"BP");
+    m_checkpoints.set_max_deltas(max_deltas);
+    return max_deltas>0;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // restore BP and training state from checkpoint file, so that the next
+  // train_multiple continues the interrupted one (skipping completed epochs).
+  // Returns the number of epochs completed (negative if failed).
+
+  int resume(std::string filename)
+  {
+    finish_training_job(m_job,"BP");
+    m_checkpoints.finish();                             // (in case it is being written)
+    int completed_epochs = 0;
+    if(!load_checkpoint(bp,filename,completed_epochs)) return -1;
+    m_resume_from_epoch = completed_epochs;
+    TEXTOUT << "BP resumed from checkpoint file " << filename << " (" << completed_epochs << " epochs completed)\n";
+    return completed_epochs;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // store connection weights in (memory-mapped) files named <file_prefix>.<index>.weights
+  // so that BP nets larger than available memory can be trained. Empty prefix restores
+  // in-memory weights.
+
+  bool store_weights_on_disk(std::string file_prefix)
+  {
+    finish_training_job(m_job,"BP");
+    if(!bp.store_weights_on_disk(file_prefix)) return false;
+    if(file_prefix.empty()) TEXTOUT << "BP weights are stored in memory\n";
+    else TEXTOUT << "BP weights are stored on disk (files " << file_prefix << ".*.weights)\n";
+    return true;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // Encode input-output datasets in the background (BP must be set up): starts
+  // training in a separate thread and returns at once (true if started). Data is
+  // copied first. Use training_status, cancel_training and wait_training; other
+  // methods wait for training to finish before using the BP.
+
+  bool train_async(NumericMatrix data_in,
+                   NumericMatrix data_out,
+                   int training_epochs)
+  {
+    finish_training_job(m_job,"BP");
+
+    if(!bp.is_ready())
+    {
+      error(NN_INTEGR_ERR,"BP is not set up (use setup before training in background)");
+      return false;
+    }
+
+    if((data_in.rows()<=0) OR
+         (data_in.rows()!=data_out.rows()))
+    {
+      error(NN_DATAST_ERR,"Cannot train BP with these datasets");
+      return false;
+    }
+
+    std::shared_ptr<row_major_dataset> dataset_in  = std::make_shared<row_major_dataset>(data_in);
+    std::shared_ptr<row_major_dataset> dataset_out = std::make_shared<row_major_dataset>(data_out);
+
+    int first_epoch = m_resume_from_epoch;              // (skip epochs completed before checkpoint)
+    m_resume_from_epoch = 0;
+    m_checkpoints.start();
+
+    if(!m_job.start(training_epochs, [=]() { return train_epochs_in_background(dataset_in,dataset_out,first_epoch,training_epochs); }))
+    {
+      m_checkpoints.finish();
+      error(NN_SYSTEM_ERR,"Cannot start background training");
+      return false;
+    }
+
+    TEXTOUT << "BP training started in background.\n";
+    return true;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // Setup BP and encode input-output datasets in the background (as above)
+
+  bool encode_async(NumericMatrix data_in,
+                    NumericMatrix data_out,
+                    double learning_rate,
+                    int training_epochs,
+                    int hidden_layers,
+                    int hidden_layer_size)
+  {
+    if(!setup(data_in.cols(),data_out.cols(),learning_rate,hidden_layers,hidden_layer_size)) return false;
+    return train_async(data_in,data_out,training_epochs);
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // background training: state ("none", "running", "completed", "cancelled" or
+  // "failed"), epochs completed, last error level and time elapsed.
+
+  List training_status()
+  {
+    flush_pending_messages();
+    return training_job_status(m_job);
+  }
+
+  bool cancel_training()
+  {
+    return m_job.cancel();                              // (stops after current epoch)
+  }
+
+  // wait (up to given seconds, negative waits until finished), true if finished.
+
+  bool wait_training(double seconds)
+  {
+    return wait_for_training_job(m_job,seconds);
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // published snapshots: an immutable copy of the BP weights, used by
+  // recall_published without waiting for (or interrupting) background training.
+  // Background training publishes a new one every given number of epochs (and
+  // when it ends) if enabled; publish() does so at once. Returns the version.
+
+  void set_publishing(int every_epochs)
+  {
+    finish_training_job(m_job,"BP");
+    m_publish_every_epochs = (every_epochs>0) ? every_epochs : 0;
+  }
+
+  double publish()
+  {
+    finish_training_job(m_job,"BP");
+    bp_snapshot PTR p = bp.make_snapshot();
+    if(p==NULL)
+    {
+      error(NN_INTEGR_ERR,"Cannot publish a snapshot of this BP (is it set up?)");
+      return 0;
+    }
+    return (double) m_published.publish(p);
+  }
+
+  double published_version()
+  {
+    return (double) m_published.current_version();     // (0 if none)
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // recall using the latest published snapshot (does not wait for training). All
+  // rows are recalled using the same snapshot, even if a new one is published.
+
+  NumericMatrix recall_published(NumericMatrix data_in)
+  {
+    snapshot_reader reader(m_published);
+    const bp_snapshot PTR s = reader.get<bp_snapshot>();
+    if(s==NULL)
+    {
+      error(NN_INTEGR_ERR,"No BP snapshot is published (see publish and set_publishing)");
+      return NumericMatrix(0,0);
+    }
+    if(data_in.cols()!=s->input_dimension())
+    {
+      error(NN_DATAST_ERR,"Number of variables (columns) differs from published BP input");
+      return NumericMatrix(0,0);
+    }
+
+    row_major_dataset dataset(data_in);
+    std::vector<DATA> output(s->output_dimension());
+    NumericMatrix data_out(dataset.rows(),s->output_dimension());
+
+    for(int r=0;r<dataset.rows();r++)
+    {
+      s->recall(dataset.row(r),dataset.cols(),output.data(),(int)output.size());
+      for(int c=0;c<(int)output.size();c++) data_out(r,c) = output[c];
+    }
+    return data_out;
+  }
+
+  NumericVector recall_single_published(NumericVector data_in)
+  {
+    snapshot_reader reader(m_published);
+    const bp_snapshot PTR s = reader.get<bp_snapshot>();
+    if(s==NULL)
+    {
+      error(NN_INTEGR_ERR,"No BP snapshot is published (see publish and set_publishing)");
+      return NumericVector(0);
+    }
+
+    NumericVector data_out(s->output_dimension());
+    if(!s->recall(data_in.begin(), data_in.length(), data_out.begin(), data_out.length()))
+    {
+      error(NN_DATAST_ERR,"Input vector length differs from published BP input");
+      return NumericVector(0);
+    }
+    return data_out;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // a new BP with the same structure, weights and settings. Weights are shared
+  // (copy-on-write) until changed, so memory is only used for rows of weights
+  // that change when the clone or the original is trained.
+
+  SEXP clone()
+  {
+    finish_training_job(m_job,"BP");
+    if(!bp.is_ready())
+    {
+      error(NN_INTEGR_ERR,"BP is not set up, cannot clone it");
+      return R_NilValue;
+    }
+    if(bp.weights_are_on_disk())
+    {
+      error(NN_INTEGR_ERR,"BP weights are stored on disk, cannot clone it");
+      return R_NilValue;
+    }
+    BP PTR p = new BP(ATPTR this);
+    if(!p->bp.is_ready())
+    {
+      delete p;
+      error(NN_INTEGR_ERR,"Cannot clone BP NN");
+      return R_NilValue;
+    }
+    return Rcpp::internal::make_new_object(p);
+  }
+
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
   void print()
   {
+    finish_training_job(m_job,"BP");
     TEXTOUT << "------Network structure (BEGIN)--------\n";
     bp.to_stream(TEXTOUT);
     TEXTOUT << "--------Network structure (END)--------\n";
@@ -255,6 +796,11 @@ public:
 
   void show()
   {
+  if(m_job.is_running())
+    {
+    TEXTOUT << "Plain Backpropagation NN (Class BP), training in background (see training_status).\n";
+    return;
+    }
 	TEXTOUT << "Plain Backpropagation NN (Class BP):\n";
   	print();
   }
@@ -270,16 +816,40 @@ RCPP_MODULE(class_BP) {
   .constructor()
 //.constructor<NumericMatrix,NumericMatrix,double,int,int,int>()
   .method( "encode",          &BP::encode,          "Setup BP and encode input-output datasets in the NN" )
-  .method( "train_multiple",  &BP::train_single,    "Encode multiple input-output vector pairs stored in corresponding datasets" )
+  .method( "train_multiple",  &BP::train_multiple,    "Encode multiple input-output vector pairs stored in corresponding datasets" )
+  .method( "train_from_file", &BP::train_from_file, "Encode input-output vector pairs streamed (in chunks) from a data set file" )
   .method( "train_single",    &BP::train_single,    "Encode a single input-output vector pair in current BP NN" )
   .method( "setup",           &BP::setup,           "Setup the BP NN" )
   .method( "recall",          &BP::recall,          "Get output for a dataset using BP NN" )
+  .method( "recall_file",     &BP::recall_file,     "Get output for a data set file, written to another file (streamed in chunks)" )
+  .method( "recall_single",   &BP::recall_single,   "Get output for a single input vector using fast recall" )
+  .method( "recall_single_latency", &BP::recall_single_latency, "Average time (microseconds) of fast single vector recall" )
+  .method( "set_profiling",   &BP::set_profiling,   "Enable or disable timing of each component's encode and recall" )
+  .method( "get_profile",     &BP::get_profile,     "Get per-component timing profile (data frame)" )
+  .method( "reset_profile",   &BP::reset_profile,   "Clear per-component timing profile" )
   .method( "print",           &BP::print,           "Print BP NN details" )
   .method( "show",            &BP::show,            "Print BP NN details" )
   .method( "mute",            &BP::mute,            "Disable output of current error level during training" )
   .method( "load",            &BP::load_from_file,  "Load BP" )
   .method( "save",            &BP::save_to_file,    "Save BP" )
+  .method( "save_binary",     &BP::save_binary_to_file, "Save BP (binary format)" )
+  .method( "load_for_inference", &BP::load_for_inference, "Load BP from binary file, sharing its weights (memory-mapped)" )
+  .method( "store_weights_on_disk", &BP::store_weights_on_disk, "Store BP connection weights in (memory-mapped) disk files" )
+  .method( "set_checkpoints", &BP::set_checkpoints, "Take checkpoints periodically during training" )
+  .method( "set_delta_checkpoints", &BP::set_delta_checkpoints, "Take delta checkpoints (changed values only) between full ones" )
+  .method( "resume",          &BP::resume,          "Restore BP and training state from checkpoint file" )
   .method( "set_error_level" ,&BP::set_error_level, "Set parameters for acceptable error when training." )
+  .method( "encode_async",    &BP::encode_async,    "Setup BP and encode input-output datasets in the background" )
+  .method( "train_async",     &BP::train_async,     "Encode input-output datasets in the background" )
+  .method( "training_status", &BP::training_status, "State and progress of background training" )
+  .method( "cancel_training", &BP::cancel_training, "Stop background training (after current epoch)" )
+  .method( "wait_training",   &BP::wait_training,   "Wait for background training to finish" )
+  .method( "set_publishing",  &BP::set_publishing,  "Publish a snapshot every given number of epochs during background training" )
+  .method( "publish",         &BP::publish,         "Publish a snapshot of current BP, for recall_published" )
+  .method( "published_version", &BP::published_version, "Version of latest published snapshot (0 if none)" )
+  .method( "recall_published", &BP::recall_published, "Get output for a dataset using the latest published snapshot (also while training)" )
+  .method( "recall_single_published", &BP::recall_single_published, "Get output for a single input vector using the latest published snapshot" )
+  .method( "clone",           &BP::clone,           "Create a copy of this BP (weights are shared until changed)" )
 
   ;
 }
@@ -12,8 +12,14 @@
 
 #include "nn_lvq.h"
 #include "nnlib2_misc.h"                     // for which_max etc.
+#include "nnlib2_checkpoint.h"
+#include "Rcpp_dataset.h"
+#include "Rcpp_profile.h"
+#include "Rcpp_training_job.h"
 #include <iostream>
 #include <fstream>
+#include <limits>
+#include <memory>
 
 using namespace nnlib2;
 using namespace nnlib2::lvq;
@@ -29,6 +35,41 @@ protected:
 
   lvq_nn      lvq;
 
+  checkpoint_writer m_checkpoints;
+  int m_resume_from_epoch;                              // next encode continues from this epoch (set by resume)
+
+  snapshot_publisher m_published;                      // snapshot for recall_published (see publish), usable while training
+  int m_publish_every_epochs;                           // background training publishes a snapshot every this many epochs (0 disables)
+
+  training_job m_job;                                   // training in background (see encode_async). Other methods wait for it to finish.
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // epoch loop of encode_async, runs in the job's thread: no R objects, output or
+  // user interrupt checks here (progress is polled with training_status).
+
+  bool encode_epochs_in_background(std::shared_ptr<row_major_dataset> dataset,
+                                   std::shared_ptr< std::vector<int> > desired_class_ids,
+                                   int first_epoch,
+                                   int training_epochs)
+  {
+    epoch_counter epochs_timed("LVQs");						// (rows/sec per epoch and progress records, see nnlib2_counters.h)
+    for(int i=first_epoch;i<training_epochs && lvq.no_error() && !m_job.cancel_requested();i++)
+    {
+      for(int r=0;r<dataset->rows();r++)
+        lvq.encode_s(dataset->row(r),dataset->cols(),desired_class_ids->at(r),i);	// Encode supervised
+
+      epochs_timed.epoch_done(dataset->rows(),i+1);
+      m_job.epoch_done(i+1,std::numeric_limits<double>::quiet_NaN());
+      m_checkpoints.checkpoint_if_due(lvq,i+1);					// (written in background)
+      if((m_publish_every_epochs>0) AND (((i+1-first_epoch)%m_publish_every_epochs)==0))
+        m_published.publish(lvq.make_snapshot());
+    }
+
+    m_checkpoints.finish();
+    if(m_publish_every_epochs>0) m_published.publish(lvq.make_snapshot());	// (final weights)
+    return lvq.no_error();
+  }
+
 public:
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -37,6 +78,19 @@ public:
   {
   TEXTOUT << "LVQ created, now encode data (or load NN from file).\n";
   lvq.reset();
+  m_resume_from_epoch = 0;
+  m_publish_every_epochs = 0;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // (used by clone, source must not be training)
+
+  LVQs(LVQs REF source)
+  {
+  lvq.reset();
+  m_resume_from_epoch = 0;
+  m_publish_every_epochs = source.m_publish_every_epochs;
+  if(!lvq.clone_from(source.lvq)) lvq.reset();
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -44,6 +98,7 @@ public:
 
   int set_number_of_nodes_per_class(int n)
   {
+    finish_training_job(m_job,"LVQ");
   	if(lvq.is_ready())
   	{
   	if(lvq.get_number_of_output_nodes_per_class()!=n)
@@ -69,6 +124,7 @@ public:
 
   int get_number_of_nodes_per_class()
   {
+    finish_training_job(m_job,"LVQ");
   	return lvq.get_number_of_output_nodes_per_class();
   }
 
@@ -77,6 +133,7 @@ public:
 
  bool set_weight_limits(double min, double max)
  {
+   finish_training_job(m_job,"LVQ");
 
  	if(lvq.set_weight_limits(min,max))
  	{
@@ -91,6 +148,7 @@ public:
 
  bool set_encoding_coefficients(double reward, double punish)
 	{
+		finish_training_job(m_job,"LVQ");
 	return lvq.set_encoding_coefficients(reward, punish);
 	}
 
@@ -99,6 +157,7 @@ public:
 
  bool enable_punishment()
 	{
+		finish_training_job(m_job,"LVQ");
 		TEXTOUT << "LVQ will notify winner nodes with incorrect classification when encoding data.\n";
 		lvq.punish_enable(TRUE);
 		return lvq.punish_enabled();
@@ -106,6 +165,7 @@ public:
 
  bool disable_punishment()
 	{
+		finish_training_job(m_job,"LVQ");
 		TEXTOUT << "LVQ will NOT notify winner nodes with incorrect classification when encoding data.\n";
 		lvq.punish_enable(FALSE);
 		return lvq.punish_enabled();
@@ -116,6 +176,7 @@ public:
 
   bool setup(int input_length, int number_of_classes)
   {
+    finish_training_job(m_job,"LVQ");
   	return setup_extended(input_length,number_of_classes,lvq.get_number_of_output_nodes_per_class());
   }
 
@@ -124,6 +185,7 @@ public:
 
   bool setup_extended(int input_length, int number_of_classes, int number_of_nodes_per_class)
 	{
+		finish_training_job(m_job,"LVQ");
   	if(lvq.is_ready())
   		{
   		TEXTOUT << "Note: Current LVQ is reset.\n";
@@ -147,6 +209,94 @@ public:
   // recommended cluster ids should be in 0 to n-1 range (n the number of clusters)
 
   void encode(NumericMatrix data,IntegerVector desired_class_ids,int training_epochs)
+  {
+    finish_training_job(m_job,"LVQ");
+    if(!setup_for_encoding(data,desired_class_ids,training_epochs)) return;
+
+    // encode all data
+
+    int first_epoch = m_resume_from_epoch;              // (skip epochs completed before checkpoint)
+    m_resume_from_epoch = 0;
+    m_checkpoints.start();
+
+    row_major_dataset dataset(data);								// (rows copied once, see Rcpp_dataset.h)
+
+    epoch_counter epochs_timed("LVQs");						// (rows/sec per epoch and progress records, see nnlib2_counters.h)
+    interval_timer interrupt_checks(NN_INTERRUPT_CHECK_SECONDS);
+    for(int i=first_epoch;i<training_epochs;i++)
+    {
+      for(int r=0;r<dataset.rows();r++)
+      {
+        int desired_class_for_data = desired_class_ids.at(r);
+
+        lvq.encode_s(dataset.row(r),dataset.cols(),desired_class_for_data,i);	// Encode supervised
+      }
+      epochs_timed.epoch_done(dataset.rows(),i+1);
+      m_checkpoints.checkpoint_if_due(lvq,i+1);					// (written in background)
+      if(interrupt_checks.due()) checkUserInterrupt();				// (RCpp function to check if user pressed cancel)
+    }
+
+    m_checkpoints.finish();
+
+    TEXTOUT << "Training Finished.\n";
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // as encode, but training runs in the background: starts it in a separate
+  // thread and returns at once (true if started). Data is copied first. Use
+  // training_status, cancel_training and wait_training; other methods wait for
+  // training to finish before using the LVQ.
+
+  bool encode_async(NumericMatrix data,IntegerVector desired_class_ids,int training_epochs)
+  {
+    finish_training_job(m_job,"LVQ");
+    if(!setup_for_encoding(data,desired_class_ids,training_epochs)) return false;
+
+    std::shared_ptr<row_major_dataset> dataset = std::make_shared<row_major_dataset>(data);
+    std::shared_ptr< std::vector<int> > class_ids = std::make_shared< std::vector<int> >(desired_class_ids.begin(),desired_class_ids.end());
+
+    int first_epoch = m_resume_from_epoch;              // (skip epochs completed before checkpoint)
+    m_resume_from_epoch = 0;
+    m_checkpoints.start();
+
+    if(!m_job.start(training_epochs, [=]() { return encode_epochs_in_background(dataset,class_ids,first_epoch,training_epochs); }))
+    {
+      m_checkpoints.finish();
+      error(NN_SYSTEM_ERR,"Cannot start background training");
+      return false;
+    }
+
+    TEXTOUT << "LVQ training started in background.\n";
+    return true;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // background training: state ("none", "running", "completed", "cancelled" or
+  // "failed"), epochs completed and time elapsed (error level is not available).
+
+  List training_status()
+  {
+    flush_pending_messages();
+    return training_job_status(m_job);
+  }
+
+  bool cancel_training()
+  {
+    return m_job.cancel();                              // (stops after current epoch)
+  }
+
+  // wait (up to given seconds, negative waits until finished), true if finished.
+
+  bool wait_training(double seconds)
+  {
+    return wait_for_training_job(m_job,seconds);
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // checks data and class ids and sets up the LVQ for them (unless already set up
+  // for the same dimensions), before encoding. False if not possible.
+
+  bool setup_for_encoding(NumericMatrix data,IntegerVector desired_class_ids,int REF training_epochs)
   {
   	if(training_epochs<0)
   	{
@@ -171,13 +321,13 @@ public:
        (data.rows()!=desired_class_ids.size()))
     {
       error(NN_DATAST_ERR,"Cannot encode data on LVQ using these datasets");
-      return;
+      return false;
     }
 
     if((min_class_id<0) OR (min_class_id>max_class_id) OR (output_dim<1))
     {
       error(NN_DATAST_ERR,"Cannot encode data on LVQ using these classes");
-      return;
+      return false;
     }
 
 
@@ -194,11 +344,11 @@ public:
     	{
     		error(NN_INTEGR_ERR,"Cannot setup LVQ NN");
     		lvq.reset();
-    		return;
+    		return false;
     	}
     }
 
-    if(!lvq.no_error()) return;
+    if(!lvq.no_error()) return false;
 
     if(lvq.get_reward_coefficient() != 0.2)
     TEXTOUT << "LVQ reward coefficient = " << lvq.get_reward_coefficient() << " .\n";
@@ -212,23 +362,76 @@ public:
       TEXTOUT << "LVQ punishment disabled.\n";
 
     TEXTOUT << "Training LVQ to encode " << output_dim << " classes...\n";
+    return true;
+  }
 
-    // encode all data
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // encode data read (in chunks, streamed) from a data set file, for data sets too
+  // large for memory. LVQ must be already set up (see setup); each row contains
+  // the input values followed by the desired class id (0 to number of classes-1).
+  // If shuffle is true, chunks are presented in different order in each epoch.
 
-    for(int i=0;i<training_epochs;i++)
+  bool encode_from_file(std::string filename, std::string format, int training_epochs, bool shuffle)
+  {
+    finish_training_job(m_job,"LVQ");
+    if(!lvq.is_ready())
     {
-      for(int r=0;r<data.rows();r++)
-      {
-        NumericVector v(data( r , _ ));								// my (lame?) way to interface with R. Remember, NumericMatrix stores data row-first, as R does.
-        double * fpdata = REAL(v);									// my (lame?) way to interface with R, cont.)
-        int desired_class_for_data = desired_class_ids.at(r);
+      error(NN_INTEGR_ERR,"LVQ is not set up (use setup before encoding from file)");
+      return false;
+    }
+
+    if(training_epochs>LVQ_MAXITERATION)
+    {
+      training_epochs = LVQ_MAXITERATION;
+      warning("Number of epochs set to maximum allowed");
+    }
+
+    int input_dim = lvq.input_length();
+    int number_of_classes = lvq.output_length()/lvq.get_number_of_output_nodes_per_class();
+
+    dataset_stream dataset;
+    if(!open_dataset_file(dataset,filename,format,input_dim+1)) return false;
+
+    TEXTOUT << "Training LVQ to encode " << number_of_classes << " classes (streaming " << dataset.rows() << " cases from file)...\n";
 
-        lvq.encode_s(fpdata,data.cols(),desired_class_for_data,i);	// Encode supervised
+    int first_epoch = m_resume_from_epoch;              // (skip epochs completed before checkpoint)
+    m_resume_from_epoch = 0;
+    m_checkpoints.start();
+
+    bool ok = true;
+    epoch_counter epochs_timed("LVQs");						// (rows/sec per epoch and progress records, see nnlib2_counters.h)
+    interval_timer interrupt_checks(NN_INTERRUPT_CHECK_SECONDS);
+    for(int i=first_epoch;(i<training_epochs) AND ok;i++)
+    {
+      int rows;
+      DATA PTR chunk;
+
+      dataset.start_epoch(shuffle);                      // (next chunk is read in background while current is used)
+      while(ok AND ((chunk=dataset.next_chunk(rows))!=NULL))
+      {
+        for(int r=0;(r<rows) AND ok;r++)
+        {
+          DATA PTR row = chunk + (size_t) r * (input_dim+1);
+          int desired_class_for_data = (int) row[input_dim];
+          if((desired_class_for_data<0) OR (desired_class_for_data>=number_of_classes) OR (desired_class_for_data!=row[input_dim]))
+          {
+            error(NN_DATAST_ERR,"Data set file contains invalid class ids (must be 0 to number of classes-1)");
+            ok = false;
+          }
+          else
+            lvq.encode_s(row,input_dim,desired_class_for_data,i);	// Encode supervised
+        }
+        if(interrupt_checks.due()) checkUserInterrupt();
       }
-      checkUserInterrupt();											// (RCpp function to check if user pressed cancel)
+      ok = ok AND dataset.no_error();
+      if(ok) epochs_timed.epoch_done(dataset.rows(),i+1);
+      if(ok) m_checkpoints.checkpoint_if_due(lvq,i+1);		// (written in background)
     }
 
+    m_checkpoints.finish();
+
     TEXTOUT << "Training Finished.\n";
+    return ok;
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -237,6 +440,7 @@ public:
                        int desired_class_id,
                        int epoch)
 	{
+		finish_training_job(m_job,"LVQ");
 		double *fpdata_in   = data_in.begin();             // (interface with R)
 
 		// Encode a case (supervised)
@@ -252,6 +456,7 @@ public:
 
   IntegerVector recall(NumericMatrix data_in)
   {
+    finish_training_job(m_job,"LVQ");
   	return recall_rewarded(data_in,0);
   }
 
@@ -259,6 +464,7 @@ public:
 
   IntegerVector recall_rewarded (NumericMatrix data_in, int minimum_number_of_rewards)
   {
+    finish_training_job(m_job,"LVQ");
     IntegerVector returned_cluster_ids = rep(-1,data_in.rows());
 
     if(!lvq.is_ready()) return returned_cluster_ids;
@@ -269,23 +475,137 @@ public:
       return returned_cluster_ids;
     }
 
-    for(int r=0;r<data_in.rows();r++)
+    row_major_dataset dataset(data_in);                              // (rows copied once, see Rcpp_dataset.h)
+
+    for(int r=0;r<dataset.rows();r++)
+      returned_cluster_ids[r] = lvq.recall_class(dataset.row(r), dataset.cols(), minimum_number_of_rewards);
+
+    TEXTOUT << "Lvq returned " << unique(returned_cluster_ids).length() << " classes with ids: " << unique(returned_cluster_ids) << "\n";
+
+    return returned_cluster_ids;
+    }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // published snapshots: an immutable copy of the LVQ codebook vectors (and
+  // rewards), used by recall_published without waiting for (or interrupting)
+  // background training. encode_async publishes a new one every given number of
+  // epochs (and when it ends) if enabled; publish() does so at once.
+
+  void set_publishing(int every_epochs)
+  {
+    finish_training_job(m_job,"LVQ");
+    m_publish_every_epochs = (every_epochs>0) ? every_epochs : 0;
+  }
+
+  double publish()
+  {
+    finish_training_job(m_job,"LVQ");
+    lvq_snapshot PTR p = lvq.make_snapshot();
+    if(p==NULL)
     {
-      NumericVector v(data_in( r , _ ));                              // my (lame?) way to interface with R. Remember, NumericMatrix stores data row-first, as R does.
-      double * fpdata = REAL(v);                                      // my (lame?) way to interface with R, cont.)
+      error(NN_INTEGR_ERR,"Cannot publish a snapshot of this LVQ (is it set up?)");
+      return 0;
+    }
+    return (double) m_published.publish(p);
+  }
+
+  double published_version()
+  {
+    return (double) m_published.current_version();     // (0 if none)
+  }
+
+  // classify using the latest published snapshot (does not wait for training),
+  // the same snapshot for all rows. Class ids are -1 where no output node has
+  // the minimum number of rewards.
+
+  IntegerVector recall_published(NumericMatrix data_in, int minimum_number_of_rewards)
+  {
+    IntegerVector returned_cluster_ids = rep(-1,data_in.rows());
 
-      returned_cluster_ids[r] = lvq.recall_class(fpdata, data_in.cols(), minimum_number_of_rewards);
+    snapshot_reader reader(m_published);
+    const lvq_snapshot PTR s = reader.get<lvq_snapshot>();
+    if(s==NULL)
+    {
+      error(NN_INTEGR_ERR,"No LVQ snapshot is published (see publish and set_publishing)");
+      return returned_cluster_ids;
+    }
+    if(data_in.cols()!=s->input_dimension())
+    {
+      error(NN_DATAST_ERR,"Number of variables (columns) differs from published LVQ input");
+      return returned_cluster_ids;
     }
 
-    TEXTOUT << "Lvq returned " << unique(returned_cluster_ids).length() << " classes with ids: " << unique(returned_cluster_ids) << "\n";
+    row_major_dataset dataset(data_in);
+    for(int r=0;r<dataset.rows();r++)
+      returned_cluster_ids[r] = s->recall_class(dataset.row(r), dataset.cols(), minimum_number_of_rewards);
 
     return returned_cluster_ids;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // classify rows of a data set file, writing their class ids (-1 if none) to
+  // another file (in the same format), for data sets too large for memory. Rows
+  // are read and results written in chunks by background threads, while the
+  // LVQ classifies the current chunk. Returns number of rows written (-1 if failed).
+
+  double recall_file(std::string input_file, std::string output_file, std::string format, int minimum_number_of_rewards)
+  {
+    finish_training_job(m_job,"LVQ");
+    if(!lvq.is_ready())
+    {
+      error(NN_INTEGR_ERR,"LVQ is not ready (encode, setup or load it first)");
+      return -1;
     }
 
+    int input_dim = lvq.input_dimension();
+
+    dataset_pipeline pipeline;
+    if(!open_dataset_pipeline(pipeline,input_file,output_file,format,input_dim,1)) return -1;
+
+    dataset_chunk in, out;
+    while(pipeline.next(in))
+    {
+      out.rows = in.rows;
+      out.values.resize(in.rows);
+      for(int r=0;r<in.rows;r++)
+        out.values[r] = lvq.recall_class(in.values.data() + (size_t) r * input_dim, input_dim, minimum_number_of_rewards);
+      if(!pipeline.put(out)) break;                     // (written in background)
+      checkUserInterrupt();
+    }
+
+    if(!pipeline.finish()) return -1;
+    return (double) pipeline.rows_written();
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // per-component profile: when enabled, encode and recall of each component are
+  // timed (see nnlib2_profiler.h). Enabling also clears previous records.
+
+  bool set_profiling(bool enable)
+  {
+    finish_training_job(m_job,"LVQ");
+    if(enable) lvq.profiler().reset();
+    lvq.profiler().enable(enable);
+    return lvq.profiler().enabled();
+  }
+
+  DataFrame get_profile()
+  {
+    finish_training_job(m_job,"LVQ");
+    return profile_data_frame(lvq);
+  }
+
+  void reset_profile()
+  {
+    finish_training_job(m_job,"LVQ");
+    lvq.profiler().reset();
+  }
+
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
   bool save_to_file(std::string filename)
   {
+    finish_training_job(m_job,"LVQ");
     std::ofstream outfile;
     outfile.open(filename);
     lvq.to_stream(outfile);
@@ -296,8 +616,26 @@ public:
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
+  bool save_binary_to_file(std::string filename)
+  {
+    finish_training_job(m_job,"LVQ");
+    if(!lvq.save_binary(filename)) return false;
+    TEXTOUT << "LVQ NN saved to (binary) file " << filename << "\n";
+    return true;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
   bool load_from_file(std::string filename)
   {
+    finish_training_job(m_job,"LVQ");
+    if(binary_model_file::is_binary_model_file(filename))         // (format is detected automatically)
+    {
+      if(!lvq.load_binary(filename)) return false;
+      TEXTOUT << "LVQ NN loaded from (binary) file " << filename << "\n";
+      return true;
+    }
+
     std::ifstream infile;
     infile.open(filename);
     if(!infile) {error(NN_IOFILE_ERR,"File cannot be opened");return false;}
@@ -307,11 +645,57 @@ public:
     return true;
   }
 
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // take checkpoints (LVQ and training state) while encoding, every_epochs and/or
+  // every_seconds (0 if not used). They are written to file in background. Empty
+  // filename disables checkpoints.
+
+  bool set_checkpoints(std::string filename, int every_epochs, double every_seconds)
+  {
+    finish_training_job(m_job,"LVQ");
+    if(!m_checkpoints.setup(filename,every_epochs,every_seconds))
+    {
+      TEXTOUT << "LVQ checkpoints are disabled\n";
+      return false;
+    }
+    TEXTOUT << "LVQ checkpoints will be saved to file " << filename << "\n";
+    return true;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // between full checkpoints, take up to max_deltas delta checkpoints, which only
+  // append the changed values to a file (checkpoint filename + ".delta"); useful
+  // if training changes few weights per epoch. 0 (default) disables them.
+
+  bool set_delta_checkpoints(int max_deltas)
+  {
+    finish_training_job(m_job,"LVQ");
+    m_checkpoints.set_max_deltas(max_deltas);
+    return max_deltas>0;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // restore LVQ and training state from checkpoint file, so that the next encode
+  // continues the interrupted one (skipping completed epochs). Returns the number
+  // of epochs completed (negative if failed).
+
+  int resume(std::string filename)
+  {
+    finish_training_job(m_job,"LVQ");
+    m_checkpoints.finish();                             // (in case it is being written)
+    int completed_epochs = 0;
+    if(!load_checkpoint(lvq,filename,completed_epochs)) return -1;
+    m_resume_from_epoch = completed_epochs;
+    TEXTOUT << "LVQ resumed from checkpoint file " << filename << " (" << completed_epochs << " epochs completed)\n";
+    return completed_epochs;
+  }
+
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
   // Get weights (connection variable)
 
   NumericVector get_weights()
   {
+    finish_training_job(m_job,"LVQ");
   	// using R numbering, 1st is input layer, 2nd connections, 3rd output layer:
   	int pos = 2;
 
@@ -349,6 +733,7 @@ public:
 
 	bool set_weights(NumericVector data_in)
 	{
+		finish_training_job(m_job,"LVQ");
 		if(lvq.number_of_components_in_topology()!=3)
 		{
 			warning("The LVQ topology has not been defined yet.");
@@ -372,6 +757,7 @@ public:
 
 	NumericVector get_number_of_rewards()
 	{
+		finish_training_job(m_job,"LVQ");
 	// using R numbering, 1st is input layer, 2nd connections, 3rd output layer:
 	int pos = 3;
 
@@ -404,10 +790,32 @@ public:
 	return data_out;
 	}
 
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // a new LVQ with the same structure, weights (codebook vectors) and settings.
+
+  SEXP clone()
+  {
+    finish_training_job(m_job,"LVQ");
+    if(!lvq.is_ready())
+    {
+      error(NN_INTEGR_ERR,"LVQ is not set up, cannot clone it");
+      return R_NilValue;
+    }
+    LVQs PTR p = new LVQs(ATPTR this);
+    if(!p->lvq.is_ready())
+    {
+      delete p;
+      error(NN_INTEGR_ERR,"Cannot clone LVQ NN");
+      return R_NilValue;
+    }
+    return Rcpp::internal::make_new_object(p);
+  }
+
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
   void print()
   {
+    finish_training_job(m_job,"LVQ");
     TEXTOUT << "------Network structure (BEGIN)--------\n";
     lvq.to_stream(TEXTOUT);
     TEXTOUT << "--------Network structure (END)--------\n";
@@ -417,6 +825,11 @@ public:
 
   void show()
   {
+    if(m_job.is_running())
+    {
+      TEXTOUT << "Learning Vector Quantizer NN (Class LVQs), training in background (see training_status).\n";
+      return;
+    }
     TEXTOUT << "Learning Vector Quantizer NN (Class LVQs):\n";
     print();
   }
@@ -434,12 +847,27 @@ RCPP_MODULE(class_LVQs) {
   .method( "setup",				 (bool (LVQs::*)(int,int))&LVQs::setup,					"Setup an untrained supervised LVQ for given input data vector dimensions and number of classes" )
   .method( "setup",				 (bool (LVQs::*)(int,int,int))&LVQs::setup_extended,	"Setup an untrained supervised LVQ for given input data vector dimensions and number of classes" )
   .method( "encode",    						&LVQs::encode,							"Encode input and output (classification) for a dataset using LVQ NN" )
+  .method( "encode_async",						&LVQs::encode_async,					"Encode input and output (classification) for a dataset using LVQ NN, in the background" )
+  .method( "training_status",					&LVQs::training_status,					"State and progress of background training" )
+  .method( "cancel_training",					&LVQs::cancel_training,					"Stop background training (after current epoch)" )
+  .method( "wait_training",						&LVQs::wait_training,					"Wait for background training to finish" )
+  .method( "set_publishing",					&LVQs::set_publishing,					"Publish a snapshot every given number of epochs during background training" )
+  .method( "publish",							&LVQs::publish,							"Publish a snapshot of current LVQ, for recall_published" )
+  .method( "published_version",					&LVQs::published_version,				"Version of latest published snapshot (0 if none)" )
+  .method( "recall_published",					&LVQs::recall_published,				"Get output (classification) for a dataset using the latest published snapshot (also while training)" )
+  .method( "clone",								&LVQs::clone,							"Create a copy of this LVQ" )
+  .method( "encode_from_file",					&LVQs::encode_from_file,				"Encode input and class ids streamed (in chunks) from a data set file using LVQ NN" )
   .method( "recall", (IntegerVector (LVQs::*)(NumericMatrix))&LVQs::recall,				"Get output (classification) for a dataset using LVQ NN" )
   .method( "recall", (IntegerVector (LVQs::*)(NumericMatrix,int))&LVQs::recall_rewarded,"Get output (classification) for a dataset using LVQ NN" )
+  .method( "recall_file",						&LVQs::recall_file,						"Get output (classification) for a data set file, written to another file (streamed in chunks)" )
+  .method( "set_profiling",						&LVQs::set_profiling,					"Enable or disable timing of each component's encode and recall" )
+  .method( "get_profile",						&LVQs::get_profile,						"Get per-component timing profile (data frame)" )
+  .method( "reset_profile",						&LVQs::reset_profile,					"Clear per-component timing profile" )
   .method( "print",     						&LVQs::print,							"Print LVQ NN details" )
   .method( "show",      						&LVQs::show,							"Print LVQ NN details" )
   .method( "load",  						 	&LVQs::load_from_file,					"Load LVQ" )
   .method( "save",      						&LVQs::save_to_file,					"Save LVQ" )
+  .method( "save_binary",						&LVQs::save_binary_to_file,				"Save LVQ (binary format)" )
   .method( "get_weights",						&LVQs::get_weights,						"Get current weight values" )
   .method( "set_weights",						&LVQs::set_weights,						"Set current weight values" )
   .method( "set_number_of_nodes_per_class",		&LVQs::set_number_of_nodes_per_class,	"Set number of output PEs to be used per class" )
@@ -450,6 +878,9 @@ RCPP_MODULE(class_LVQs) {
   .method( "set_weight_limits",					&LVQs::set_weight_limits,				"Define minimum and maximum values allowed in weights" )
   .method( "set_encoding_coefficients",			&LVQs::set_encoding_coefficients,		"Define coefficients used for reward and punishment" )
   .method( "train_single",  					&LVQs::train_single,    				"Encode a single case in current LVQ NN" )
+  .method( "set_checkpoints",					&LVQs::set_checkpoints,					"Take checkpoints periodically during encoding" )
+  .method( "set_delta_checkpoints",			&LVQs::set_delta_checkpoints,			"Take delta checkpoints (changed values only) between full ones" )
+  .method( "resume",							&LVQs::resume,							"Restore LVQ and training state from checkpoint file" )
   ;
 }
 
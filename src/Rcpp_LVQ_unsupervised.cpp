@@ -13,6 +13,9 @@ using namespace Rcpp;
 
 #include "nnlib2_misc.h"                    // for which_max
 #include "nn_lvq.h"                         // for som_nn
+#include "nnlib2_checkpoint.h"
+#include "Rcpp_dataset.h"
+#include <fstream>
 
 using namespace nnlib2;
 using namespace nnlib2::lvq;
@@ -25,7 +28,12 @@ IntegerVector LVQu ( NumericMatrix data,
                      int max_number_of_desired_clusters,
                      int number_of_training_epochs,          // (each presents all data)
                      int neighborhood_size =1,               // should be odd.
-                     bool show_nn = false )
+                     bool show_nn = false,
+                     std::string checkpoint_file = "",       // if not empty, take checkpoints (to resume training) in this file...
+                     int checkpoint_epochs = 0,              // ...every this many epochs...
+                     double checkpoint_seconds = 0,          // ...and/or seconds.
+                     bool resume = false,                    // continue training from checkpoint_file (if it exists)
+                     int checkpoint_deltas = 0 )             // between full checkpoints, take up to this many delta checkpoints (only changed weights)
 {
    IntegerVector returned_cluster_ids = rep(-1,data.rows());
 
@@ -37,20 +45,39 @@ IntegerVector LVQu ( NumericMatrix data,
    if(som.no_error())   som.setup(input_data_dim,output_dim);
    if(NOT som.no_error())   return returned_cluster_ids;
 
-   // encode all data
+   checkpoint_writer checkpoints;
+   checkpoints.setup(checkpoint_file, checkpoint_epochs, checkpoint_seconds);
+   checkpoints.set_max_deltas(checkpoint_deltas);
 
-   for(int i=0;i<number_of_training_epochs;i++)
+   int first_epoch = 0;
+   if(resume)
    {
-   for(int r=0;r<data.rows();r++)
+      if(NOT std::ifstream(checkpoint_file.c_str()))
+         TEXTOUT << "No checkpoint file found, training starts from first epoch.\n";
+      else
       {
-      NumericVector v(data( r , _ ));                                   // my (lame?) way to interface with R. Remember, NumericMatrix stores data row-first, as R does.
-      double * fp_v = REAL(v);                                          // my (lame?) way to interface with R, cont.)
-
-      som.encode_u(fp_v,data.cols(),i);                                 // Encode a single item, unsupervised
+         if(NOT load_checkpoint(som, checkpoint_file, first_epoch, true)) return returned_cluster_ids;
+         TEXTOUT << "Training resumes from checkpoint (" << first_epoch << " epochs completed).\n";
       }
-   checkUserInterrupt();                                                // (RCpp function to check if user pressed cancel)
    }
 
+   // encode all data
+
+   row_major_dataset dataset(data);                                     // (rows copied once, see Rcpp_dataset.h)
+
+   epoch_counter epochs_timed("LVQu");                                  // (rows/sec per epoch and progress records, see nnlib2_counters.h)
+   interval_timer interrupt_checks(NN_INTERRUPT_CHECK_SECONDS);
+   for(int i=first_epoch;i<number_of_training_epochs;i++)
+   {
+   for(int r=0;r<dataset.rows();r++)
+      som.encode_u(dataset.row(r),dataset.cols(),i);                    // Encode a single item, unsupervised
+   epochs_timed.epoch_done(dataset.rows(),i+1);
+   checkpoints.checkpoint_if_due(som,i+1);                              // (written in background)
+   if(interrupt_checks.due()) checkUserInterrupt();                     // (RCpp function to check if user pressed cancel)
+   }
+
+   checkpoints.finish();
+
    if(show_nn)
    {
       TEXTOUT << "------Network structure (BEGIN)--------\n";
@@ -63,12 +90,9 @@ IntegerVector LVQu ( NumericMatrix data,
 
    DATA * output_vector = new DATA [output_dim];
 
-   for(int r=0;r<data.rows();r++)
+   for(int r=0;r<dataset.rows();r++)
      {
-     NumericVector v(data( r , _ ));                                   // my (lame?) way to interface with R. Remember, NumericMatrix stores data row-first, as R does.
-     double * fp_v = REAL(v);                                          // my (lame?) way to interface with R, cont.)
-
-     som.recall(fp_v, data.cols(), output_vector, output_dim);
+     som.recall(dataset.row(r), dataset.cols(), output_vector, output_dim);
 
      // now find which element in the output vector has the smallest value and use it as the winner id.
      returned_cluster_ids[r] = which_min(output_vector,output_dim);
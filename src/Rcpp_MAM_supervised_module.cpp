@@ -11,6 +11,8 @@
 //--------------------------------------------------------------------------------
 
 #include "nn_mam.h"
+#include "Rcpp_dataset.h"
+#include "Rcpp_profile.h"
 #include <iostream>
 #include <fstream>
 
@@ -57,14 +59,12 @@ public:
     // ... and encode data:
 
     if(mam.is_ready())
-    for(int r=0;r<num_train_items;r++)
     {
-      NumericVector v1(data_in( r , _ ));                         // my (lame?) way to interface with R. Remember, NumericMatrix stores data row-first, as R does.
-      double * fpdata_in = REAL(v1);                              // my (lame?) way to interface with R, cont.)
-      NumericVector v2(data_out( r , _ ));                        // my (lame?) way to interface with R, cont.)
-      double *fpdata_out = v2.begin();                            // my (lame?) way to interface with R, cont.)
+      row_major_dataset dataset_in(data_in);                      // (rows copied once, see Rcpp_dataset.h)
+      row_major_dataset dataset_out(data_out);
 
-      mam.encode_s(fpdata_in,data_in.cols(),fpdata_out,data_out.cols());
+      for(int r=0;r<num_train_items;r++)
+        mam.encode_s(dataset_in.row(r),dataset_in.cols(),dataset_out.row(r),dataset_out.cols());
     }
   TEXTOUT << "Training Finished.\n";
   }
@@ -97,20 +97,64 @@ public:
   if(!mam.is_ready()) return data_out;
 
   int num_test_items  = data.rows();
-  data_out = NumericMatrix(num_test_items,mam.output_dimension());
+  row_major_dataset dataset_in(data);                           // (rows copied once, see Rcpp_dataset.h)
+  row_major_dataset dataset_out(num_test_items,mam.output_dimension());
 
   for(int r=0;r<num_test_items;r++)
-    {
-      NumericVector v1(data( r , _ ));                          // my (lame?) way to interface with R. Remember, NumericMatrix stores data row-first, as R does.
-      double * fpdata = REAL(v1);                               // my (lame?) way to interface with R, cont.)
-      NumericVector v2(data_out( r , _ ));                      // my (lame?) way to interface with R, cont.)
-      double *fpdata_out = v2.begin();                          // my (lame?) way to interface with R, cont.)
+    mam.recall(dataset_in.row(r),dataset_in.cols(),dataset_out.row(r),dataset_out.cols());
+
+  data_out = dataset_out.to_matrix();
+  return (data_out);
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // get output for a data set file, writing it to another file (in the same
+  // format), streamed in chunks. Returns number of rows written (-1 if failed).
+
+  double recall_file(std::string input_file, std::string output_file, std::string format)
+  {
+  if(!mam.is_ready()) return -1;
 
-      mam.recall(fpdata,data.cols(),fpdata_out,data_out.cols());
+  int input_dim  = mam.input_dimension();
+  int output_dim = mam.output_dimension();
 
-      data_out( r , _ ) = v2;                                   // my (lame?) way to interface with R. Copy result vector back to matrix. Remember, NumericMatrix stores data row-first, as R does.
+  dataset_pipeline pipeline;
+  if(!open_dataset_pipeline(pipeline,input_file,output_file,format,input_dim,output_dim)) return -1;
+
+  dataset_chunk in, out;
+  while(pipeline.next(in))
+    {
+    out.rows = in.rows;
+    out.values.resize((size_t) in.rows * output_dim);
+    for(int r=0;r<in.rows;r++)
+      mam.recall(in.values.data() + (size_t) r * input_dim, input_dim, out.values.data() + (size_t) r * output_dim, output_dim);
+    if(!pipeline.put(out)) break;                               // (written in background)
+    checkUserInterrupt();
     }
-  return (data_out);
+
+  if(!pipeline.finish()) return -1;
+  return (double) pipeline.rows_written();
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // per-component profile: when enabled, encode and recall of each component are
+  // timed (see nnlib2_profiler.h). Enabling also clears previous records.
+
+  bool set_profiling(bool enable)
+  {
+  if(enable) mam.profiler().reset();
+  mam.profiler().enable(enable);
+  return mam.profiler().enabled();
+  }
+
+  DataFrame get_profile()
+  {
+  return profile_data_frame(mam);
+  }
+
+  void reset_profile()
+  {
+  mam.profiler().reset();
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -127,8 +171,24 @@ public:
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
+  bool save_binary_to_file(std::string filename)
+  {
+    if(!mam.save_binary(filename)) return false;
+    TEXTOUT << "MAM NN saved to (binary) file " << filename << "\n";
+    return true;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
   bool load_from_file(std::string filename)
   {
+    if(binary_model_file::is_binary_model_file(filename))         // (format is detected automatically)
+    {
+      if(!mam.load_binary(filename)) return false;
+      TEXTOUT << "MAM NN loaded from (binary) file " << filename << "\n";
+      return true;
+    }
+
     std::ifstream infile;
     infile.open(filename);
     if(!infile) {error(NN_IOFILE_ERR,"File cannot be opened");return false;}
@@ -168,10 +228,15 @@ RCPP_MODULE(class_MAM) {
   .method( "encode",      &MAM::encode,        "Encode input and corresponding output" )
   .method( "train_single",&MAM::train_single,  "Encode a single input-output vector pair in current MAM NN" )
   .method( "recall",      &MAM::recall,        "Get output for a dataset using MAM NN" )
+  .method( "recall_file", &MAM::recall_file,   "Get output for a data set file, written to another file (streamed in chunks)" )
+  .method( "set_profiling", &MAM::set_profiling, "Enable or disable timing of each component's encode and recall" )
+  .method( "get_profile", &MAM::get_profile,   "Get per-component timing profile (data frame)" )
+  .method( "reset_profile", &MAM::reset_profile, "Clear per-component timing profile" )
   .method( "print",       &MAM::print,         "Print MAM NN details" )
   .method( "show",        &MAM::show,          "Print MAM NN details" )
   .method( "load",        &MAM::load_from_file,"Load MAM" )
   .method( "save",        &MAM::save_to_file,  "Save MAM" )
+  .method( "save_binary", &MAM::save_binary_to_file, "Save MAM (binary format)" )
   ;
 }
 
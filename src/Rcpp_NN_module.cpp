@@ -9,8 +9,15 @@
 #ifdef NNLIB2_FOR_RCPP
 
 #include "nn.h"
+#include "nnlib2_checkpoint.h"
+#include "Rcpp_dataset.h"
+#include "Rcpp_profile.h"
+#include "Rcpp_training_job.h"
 #include <iostream>
 #include <fstream>
+#include <limits>
+#include <memory>
+#include <functional>
 
 #include "nn_lvq.h"
 #include "nn_bp.h"
@@ -31,6 +38,20 @@ protected:
 
 	nn    m_nn;					// the internal NN
 
+	checkpoint_writer m_checkpoints;
+	int m_resume_from_epoch;	// next encode_dataset(s) continues from this epoch (set by resume)
+
+	training_job m_job;			// training in background (see encode_..._async). Other methods wait for it to finish.
+
+	std::vector< std::function<bool(NN REF)> > m_construction_steps;	// successful calls that changed topology, replayed by clone
+
+	struct textout_muted		// (TEXTOUT output is discarded while in scope)
+	{
+		std::streambuf PTR m_saved;
+		textout_muted()  { m_saved = TEXTOUT.rdbuf(NULL); }
+		~textout_muted() { TEXTOUT.rdbuf(m_saved); }
+	};
+
 	// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 	// generate layer for further use later (note: name is also used as type selector)
 
@@ -204,6 +225,7 @@ protected:
 
 		if(m_nn.connect_layers_at_topology_indexes(source_pos-1,destin_pos-1,p,fully_connect,min_random_weight,max_random_weight))
 		{
+			m_construction_steps.push_back([=](NN REF n){ return n.add_connection_set_for(source_pos,destin_pos,parameters,fully_connect,0,0); });	// (weights are copied by clone)
 			TEXTOUT << "Topology changed:\n";
 			outline();
 			return true;
@@ -221,6 +243,133 @@ protected:
 		Rcpp::warning("(NN module) "+message);
 	}
 
+	// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+	// send a data set row (see Rcpp_dataset.h) to component at given position
+	// (R to Cpp index converted), as input, output (layers) or misc values.
+
+	bool input_row_at(int pos, DATA PTR row, int dimension)
+	{
+		if(m_nn.set_component_for_input(pos-1))
+			return m_nn.input_data_from_vector(row,dimension);
+		return false;
+	}
+
+	bool send_row_at(int pos, DATA PTR row, int dimension, int destination_selector)
+	{
+		if(destination_selector==0) return input_row_at(pos,row,dimension);
+		if(destination_selector==1) return m_nn.set_output_at_component(pos-1,row,dimension);
+		if(destination_selector==2) return m_nn.set_misc_at_component(pos-1,row,dimension);
+		return false;
+	}
+
+	int size_of_component_at(int pos)						// (R to Cpp index converted), -1 if not found
+	{
+		component PTR p = m_nn.component_from_topology_index(pos-1);
+		return (p==NULL) ? -1 : p->size();
+	}
+
+	// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+	// true if topology contains components that call R (these cannot be used by
+	// other threads, so the NN cannot be trained in the background).
+
+	bool has_R_components()
+	{
+		for(int c=0;c<m_nn.size();c++)
+		{
+			component PTR pc = m_nn.component_from_topology_index(c);
+			if(dynamic_cast<R_layer PTR>(pc)!=NULL) return true;
+			if(dynamic_cast<R_connection_matrix PTR>(pc)!=NULL) return true;
+			if(dynamic_cast<aux_control_R PTR>(pc)!=NULL) return true;
+		}
+		return false;
+	}
+
+	// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+	// checks before starting a background training job, false if not possible.
+
+	bool can_train_in_background()
+	{
+		if(NOT m_nn.is_ready())
+		{
+			error(NN_INTEGR_ERR,"NN is not ready, cannot train it in the background");
+			return false;
+		}
+		if(has_R_components())
+		{
+			error(NN_INTEGR_ERR,"NN contains R components (R functions, layers or connections), cannot train it in the background");
+			return false;
+		}
+		return true;
+	}
+
+	// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+	// epoch loops of encode_..._async, run in the job's thread: no R objects, output
+	// or user interrupt checks here (progress is polled with training_status).
+
+	bool encode_epochs_in_background(
+			std::shared_ptr<row_major_dataset> i_dataset,
+			int i_pos,
+			std::shared_ptr<row_major_dataset> j_dataset,		// (NULL if unsupervised)
+			int j_pos,
+			int j_destination_selector,
+			int first_epoch,
+			int epochs,
+			bool fwd)
+	{
+		epoch_counter epochs_timed("NN");						// (rows/sec per epoch and progress records, see nnlib2_counters.h)
+		for(int e=first_epoch;(e<epochs) AND (NOT m_job.cancel_requested());e++)
+		{
+			if(NOT m_nn.is_ready()) break;
+
+			for(int r=0;r<i_dataset->rows();r++)
+			{
+				bool data_sent = input_row_at(i_pos, i_dataset->row(r), i_dataset->cols());
+				if(j_dataset) data_sent = data_sent AND send_row_at(j_pos, j_dataset->row(r), j_dataset->cols(), j_destination_selector);
+
+				if(NOT data_sent)
+				{
+					error(NN_INTEGR_ERR,"Error sending the data to NN, training failed");
+					m_checkpoints.finish();
+					return false;
+				}
+
+				m_nn.call_component_encode_all(fwd);
+			}
+			epochs_timed.epoch_done(i_dataset->rows(),e+1);
+			m_job.epoch_done(e+1,std::numeric_limits<double>::quiet_NaN());
+			m_checkpoints.checkpoint_if_due(m_nn,e+1);			// (written in background)
+		}
+
+		m_checkpoints.finish();
+		return m_nn.is_ready();
+	}
+
+	// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+	bool start_background_training(
+			std::shared_ptr<row_major_dataset> i_dataset,
+			int i_pos,
+			std::shared_ptr<row_major_dataset> j_dataset,
+			int j_pos,
+			int j_destination_selector,
+			int epochs,
+			bool fwd)
+	{
+		int first_epoch = m_resume_from_epoch;					// (skip epochs completed before checkpoint)
+		m_resume_from_epoch = 0;
+		m_checkpoints.start();
+
+		if(NOT m_job.start(epochs, [=]() { return encode_epochs_in_background(i_dataset,i_pos,j_dataset,j_pos,j_destination_selector,first_epoch,epochs,fwd); }))
+		{
+			m_checkpoints.finish();
+			error(NN_SYSTEM_ERR,"Cannot start background training");
+			return false;
+		}
+
+		TEXTOUT << "Encoding started in background.\n";
+		return true;
+	}
+
 
 	// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
@@ -232,6 +381,48 @@ public:
 	{
 		TEXTOUT << "NN module created, now add components.\n";
 		m_nn.reset();
+		m_resume_from_epoch = 0;
+	}
+
+	// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+	// (used by clone) the topology is created by repeating (quietly) the calls that
+	// created the source's, then values are copied (see nn::copy_values_from).
+
+	NN(NN REF source)
+	{
+		m_nn.reset();
+		m_resume_from_epoch = 0;
+
+		bool ok = true;
+		{
+			textout_muted muted;
+			for(size_t i=0;(i<source.m_construction_steps.size()) AND ok;i++)
+				ok = source.m_construction_steps[i](ATPTR this);
+		}
+
+		if(ok AND (m_nn.size()==source.m_nn.size()) AND m_nn.copy_values_from(source.m_nn))
+			m_nn.change_is_ready_flag(source.m_nn.is_ready());
+		else
+			m_nn.change_is_ready_flag(false);
+	}
+
+	// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+	// a new NN with the same topology and values. Weights in matrices are shared
+	// (copy-on-write) until changed, other connection sets are copied. (Named so as
+	// not to hide Rcpp::clone, used by other methods.)
+
+	SEXP clone_nn()
+	{
+		finish_training_job(m_job,"NN");
+
+		NN PTR p = new NN(ATPTR this);
+		if((p->m_nn.size()!=m_nn.size()) OR (m_nn.is_ready() AND NOT p->m_nn.is_ready()))
+		{
+			delete p;
+			error(NN_INTEGR_ERR,"Cannot clone NN");
+			return R_NilValue;
+		}
+		return Rcpp::internal::make_new_object(p);
 	}
 
 	// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -247,6 +438,7 @@ public:
                 int output_to,
                 bool ignore_result )
 	{
+		finish_training_job(m_job,"NN");
 		bool active_on_encode = false;
 		bool active_on_recall = false;
 
@@ -318,6 +510,7 @@ public:
 				if(m_nn.add_aux_control(paR))
 				{
 					m_nn.change_is_ready_flag(true);   // patch, not checked, but this component should be ready for processing no matter what.
+					m_construction_steps.push_back([=](NN REF n){ return n.add_R_function(trigger,FUN,i_mode,input_from,o_mode,output_to,ignore_result); });
 					TEXTOUT << "Topology changed:\n";
 					outline();
 					return true;
@@ -341,6 +534,7 @@ public:
                       int output_to)
 
 	{
+		finish_training_job(m_job,"NN");
 		return add_R_function(
 			trigger,
 			FUN,
@@ -354,6 +548,7 @@ public:
 
 	bool add_R_pipelining ( string trigger, string FUN, bool fwd )
 	{
+		finish_training_job(m_job,"NN");
 		if(fwd) return add_R_function(
 						trigger,
 						FUN,
@@ -373,6 +568,7 @@ public:
 
 	bool add_R_forwarding ( string trigger, string FUN)
 	{
+		finish_training_job(m_job,"NN");
 	return 	add_R_pipelining(trigger, FUN, true);
 	}
 
@@ -381,6 +577,7 @@ public:
 
 	bool add_R_ignoring( string trigger, string FUN, string i_mode, int input_from )
 	{
+		finish_training_job(m_job,"NN");
 		return add_R_function(
 						trigger,FUN,
                 		i_mode, input_from,
@@ -396,6 +593,7 @@ public:
 
 	bool add_layer_1xp(string name, int size, DATA optional_parameter)
 	{
+		finish_training_job(m_job,"NN");
 		List parameters = List::create(	Named("name")=name,
                                 		Named("size")=size,
                                 		Named("optional_parameter")=optional_parameter);
@@ -407,6 +605,7 @@ public:
 
 	bool add_layer_0xp(string name, int size)
 	{
+		finish_training_job(m_job,"NN");
 		return add_layer_1xp(name,size,DATA_MIN);
 	}
 
@@ -414,6 +613,7 @@ public:
 
 	bool add_layer_Mxp(List parameters)
 	{
+		finish_training_job(m_job,"NN");
 		string name = parameters["name"];
 		int size	= parameters["size"];
 
@@ -426,6 +626,7 @@ public:
 		{
 			if(m_nn.add_layer(p))
 			{
+				m_construction_steps.push_back([=](NN REF n){ return n.add_layer_Mxp(parameters); });
 				TEXTOUT << "Topology changed:\n";
 				outline();
 				return true;
@@ -450,6 +651,7 @@ public:
 
 	bool add_connection_set_1xp(string name, DATA optional_parameter=DATA_MIN)
 	{
+		finish_training_job(m_job,"NN");
 		List parameters = List::create(	Named("name")=name,
                                   Named("optional_parameter")=optional_parameter);
 
@@ -461,6 +663,7 @@ public:
 
 	bool add_connection_set_Mxp(List parameters)
 	{
+		finish_training_job(m_job,"NN");
 		if(parameters.length()==1) return add_connection_set_1xp(parameters[0]);			// i.e. name. Takes advantage of how Rcpp handles a a single string...
 
 		string name = parameters["name"];
@@ -480,6 +683,7 @@ public:
 		{
 			if(m_nn.add_connection_set(p))
 			{
+				m_construction_steps.push_back([=](NN REF n){ return n.add_connection_set_Mxp(parameters); });
 				TEXTOUT << "Topology changed:\n";
 				outline();
 				return true;
@@ -498,8 +702,10 @@ public:
 
 	bool create_connections_in_sets(DATA min_random_weight, DATA max_random_weight)
 	{
+		finish_training_job(m_job,"NN");
 		if(m_nn.connect_consecutive_layers(true,true,min_random_weight,max_random_weight))
 		{
+			m_construction_steps.push_back([](NN REF n){ return n.create_connections_in_sets(0,0); });	// (weights are copied by clone)
 			TEXTOUT << "Connections added, you can now encode data.\n";
 			return true;
 		}
@@ -521,6 +727,7 @@ public:
                             	string name,
                             	DATA optional_parameter)
 	{
+		finish_training_job(m_job,"NN");
 		List parameters = List::create(	Named("name")=name,
                                 		Named("optional_parameter")=optional_parameter);
 
@@ -534,6 +741,7 @@ public:
                             	int destin_pos,
                             	List parameters)
 	{
+		finish_training_job(m_job,"NN");
 		string name;
 
 		if(parameters.length()==1) return connect_layers_at_1xp( source_pos,
@@ -557,6 +765,7 @@ public:
                                 		DATA max_random_weight,
                                 		DATA optional_parameter )
 	{
+		finish_training_job(m_job,"NN");
 		List parameters = List::create(	Named("name")=name,
                                 		Named("optional_parameter")=optional_parameter);
 
@@ -571,6 +780,7 @@ public:
                                 		DATA min_random_weight,
                                 		DATA max_random_weight )
 	{
+		finish_training_job(m_job,"NN");
 		string name;
 
 		if(parameters.length()==1) return fully_connect_layers_at_1xp(	source_pos,
@@ -588,7 +798,10 @@ public:
 
 	bool add_single_connection(int pos, int source_pe, int destin_pe, DATA weight)
 	{
-		return m_nn.add_connection(pos-1,source_pe-1,destin_pe-1,weight);
+		finish_training_job(m_job,"NN");
+		if(NOT m_nn.add_connection(pos-1,source_pe-1,destin_pe-1,weight)) return false;
+		m_construction_steps.push_back([=](NN REF n){ return n.add_single_connection(pos,source_pe,destin_pe,weight); });
+		return true;
 	}
 
 
@@ -597,7 +810,10 @@ public:
 
 	bool remove_single_connection(int pos, int con)
 	{
-		return m_nn.remove_connection(pos-1,con);
+		finish_training_job(m_job,"NN");
+		if(NOT m_nn.remove_connection(pos-1,con)) return false;
+		m_construction_steps.push_back([=](NN REF n){ return n.remove_single_connection(pos,con); });
+		return true;
 	}
 
 	// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -608,6 +824,7 @@ public:
 
 	IntegerVector component_ids()
 	{
+		finish_training_job(m_job,"NN");
 		IntegerVector x;
 		if(m_nn.size()<=0) return x;
 		x = IntegerVector(m_nn.size());
@@ -620,6 +837,7 @@ public:
 
 	IntegerVector sizes()
 	{
+		finish_training_job(m_job,"NN");
 		IntegerVector x;
 		if(m_nn.size()<=0) return x;
 		x = IntegerVector(m_nn.size());
@@ -633,6 +851,7 @@ public:
 
 	bool input_at(int pos, NumericVector data_in)
 	{
+		finish_training_job(m_job,"NN");
 		double * fpdata_in  = REAL(data_in);                    // my (lame?) way to interface with R, cont.)
 
 		if(m_nn.set_component_for_input(pos-1))
@@ -643,6 +862,7 @@ public:
 
 	bool set_input_at(int pos, NumericVector data_in)
 	{
+		finish_training_job(m_job,"NN");
 		return input_at(pos,data_in);
 	}
 
@@ -651,6 +871,7 @@ public:
 
 	bool encode_at(int pos)
 	{
+		finish_training_job(m_job,"NN");
 		return m_nn.call_component_encode(pos-1);
 	}
 
@@ -659,6 +880,7 @@ public:
 
 	bool recall_at(int pos)
 	{
+		finish_training_job(m_job,"NN");
 		return m_nn.call_component_recall(pos-1);
 	}
 
@@ -667,16 +889,19 @@ public:
 
 	bool encode_all(bool fwd = true)
 	{
+		finish_training_job(m_job,"NN");
 		return m_nn.call_component_encode_all(fwd);
 	}
 
 	bool encode_all_fwd()
 	{
+		finish_training_job(m_job,"NN");
 		return encode_all(true);
 	}
 
 	bool encode_all_bwd()
 	{
+		finish_training_job(m_job,"NN");
 		return encode_all(false);
 	}
 
@@ -685,16 +910,19 @@ public:
 
 	bool recall_all(bool fwd = true)
 	{
+		finish_training_job(m_job,"NN");
 		return m_nn.call_component_recall_all(fwd);
 	}
 
 	bool recall_all_fwd()
 	{
+		finish_training_job(m_job,"NN");
 		return recall_all(true);
 	}
 
 	bool recall_all_bwd()
 	{
+		finish_training_job(m_job,"NN");
 		return recall_all(false);
 	}
 
@@ -708,6 +936,7 @@ public:
 			bool fwd = true					// processing direction (order) for components in NN
 	)
 	{
+		finish_training_job(m_job,"NN");
 		if(data.rows()<=0)
 		{
 			error(NN_DATAST_ERR,"Cannot perform unsupervised training, dataset empty");
@@ -715,10 +944,17 @@ public:
 		}
 
 		int num_training_cases=data.rows();
+		row_major_dataset dataset(data);						// (rows copied once, see Rcpp_dataset.h)
 
 		TEXTOUT << "Encoding (unsupervised)...\n";
 
-		for(int i=0;i<epochs;i++)
+		int first_epoch = m_resume_from_epoch;					// (skip epochs completed before checkpoint)
+		m_resume_from_epoch = 0;
+		m_checkpoints.start();
+
+		epoch_counter epochs_timed("NN");						// (rows/sec per epoch and progress records, see nnlib2_counters.h)
+		interval_timer interrupt_checks(NN_INTERRUPT_CHECK_SECONDS);
+		for(int i=first_epoch;i<epochs;i++)
 		{
 			if(NOT m_nn.is_ready())
 			{
@@ -728,16 +964,118 @@ public:
 
 			for(int r=0;r<num_training_cases;r++)
 			{
-				if(NOT input_at(pos, data( r , _ ) ))
+				if(NOT input_row_at(pos, dataset.row(r), dataset.cols()))
 				{
 					error(NN_INTEGR_ERR,"Training failed");
 					return false;
 				}
-				encode_all(fwd);
+				m_nn.call_component_encode_all(fwd);
+			}
+			epochs_timed.epoch_done(num_training_cases,i+1);
+			m_checkpoints.checkpoint_if_due(m_nn,i+1);			// (written in background)
+			flush_pending_messages();							// display any messages raised by other threads
+			if(interrupt_checks.due()) checkUserInterrupt();	// (RCpp function to check if user pressed cancel)
+		}
+
+		m_checkpoints.finish();
+
+		TEXTOUT << "Finished.\n";
+		return true;
+	}
+
+	// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+	// as encode_dataset_unsupervised, but training runs in the background: starts
+	// it in a separate thread and returns at once (true if started). Data is copied
+	// first. Not possible if the NN contains R components. Use training_status,
+	// cancel_training and wait_training; other methods wait for training to finish.
+
+	bool encode_dataset_unsupervised_async(
+			NumericMatrix data,
+			int pos,							// input component position
+			int epochs,							// training epochs (presentations of all data)
+			bool fwd							// processing direction (order) for components in NN
+	)
+	{
+		finish_training_job(m_job,"NN");
+
+		if(data.rows()<=0)
+		{
+			error(NN_DATAST_ERR,"Cannot perform unsupervised training, dataset empty");
+			return false;
+		}
+
+		if(NOT can_train_in_background()) return false;
+
+		std::shared_ptr<row_major_dataset> dataset = std::make_shared<row_major_dataset>(data);
+		return start_background_training(dataset,pos,std::shared_ptr<row_major_dataset>(),0,0,epochs,fwd);
+	}
+
+	// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+	// Encode multiple input vectors read (in chunks, streamed) from a data set
+	// file, for data sets too large for memory. Each row must have as many values
+	// as the size of the input component.
+
+	bool encode_file_unsupervised(
+			std::string filename,				// data set file...
+			std::string format,					// ...in "csv" or "binary" format
+			int pos,							// input component position
+			int epochs = 1000,					// training epochs (presentations of all data)
+			bool fwd = true,					// processing direction (order) for components in NN
+			bool shuffle = false				// present chunks in different (random) order in each epoch
+	)
+	{
+		finish_training_job(m_job,"NN");
+		int cols = size_of_component_at(pos);
+		if(cols<=0)
+		{
+			error(NN_INTEGR_ERR,"Cannot perform unsupervised training, invalid input component");
+			return false;
+		}
+
+		dataset_stream dataset;
+		if(NOT open_dataset_file(dataset,filename,format,cols)) return false;
+
+		TEXTOUT << "Encoding (unsupervised, streaming " << dataset.rows() << " rows from file)...\n";
+
+		int first_epoch = m_resume_from_epoch;					// (skip epochs completed before checkpoint)
+		m_resume_from_epoch = 0;
+		m_checkpoints.start();
+
+		epoch_counter epochs_timed("NN");						// (rows/sec per epoch and progress records, see nnlib2_counters.h)
+		interval_timer interrupt_checks(NN_INTERRUPT_CHECK_SECONDS);
+		for(int i=first_epoch;i<epochs;i++)
+		{
+			if(NOT m_nn.is_ready())
+			{
+				error(NN_DATAST_ERR,"Training failed");
+				return false;
+			}
+
+			int rows;
+			DATA PTR chunk;
+			dataset.start_epoch(shuffle);						// (next chunk is read in background while current is used)
+			while((chunk=dataset.next_chunk(rows))!=NULL)
+			{
+				for(int r=0;r<rows;r++)
+				{
+					if(NOT input_row_at(pos, chunk+(size_t)r*cols, cols))
+					{
+						error(NN_INTEGR_ERR,"Training failed");
+						return false;
+					}
+					m_nn.call_component_encode_all(fwd);
+				}
+				if(interrupt_checks.due()) checkUserInterrupt();	// (RCpp function to check if user pressed cancel)
 			}
-			if(i%100==0) checkUserInterrupt();					// (RCpp function to check if user pressed cancel)
+			if(NOT dataset.no_error()) return false;
+
+			epochs_timed.epoch_done(dataset.rows(),i+1);
+			m_checkpoints.checkpoint_if_due(m_nn,i+1);			// (written in background)
+			flush_pending_messages();							// display any messages raised by other threads
 		}
 
+		m_checkpoints.finish();
+
 		TEXTOUT << "Finished.\n";
 		return true;
 	}
@@ -755,6 +1093,7 @@ public:
 			bool fwd = true						// processing direction (order) for components in NN
 	)
 	{
+		finish_training_job(m_job,"NN");
 		if( (i_data.rows()<=0) OR
           (j_data.rows()<=0) OR
           (i_data.rows()!=j_data.rows()) )
@@ -764,10 +1103,18 @@ public:
 		}
 
 		int num_training_pairs=i_data.rows();
+		row_major_dataset i_dataset(i_data);					// (rows copied once, see Rcpp_dataset.h)
+		row_major_dataset j_dataset(j_data);
 
 		TEXTOUT << "Encoding (supervised)...\n";
 
-		for(int e=0;e<epochs;e++)
+		int first_epoch = m_resume_from_epoch;					// (skip epochs completed before checkpoint)
+		m_resume_from_epoch = 0;
+		m_checkpoints.start();
+
+		epoch_counter epochs_timed("NN");						// (rows/sec per epoch and progress records, see nnlib2_counters.h)
+		interval_timer interrupt_checks(NN_INTERRUPT_CHECK_SECONDS);
+		for(int e=first_epoch;e<epochs;e++)
 		{
 			if(NOT m_nn.is_ready())
 			{
@@ -780,11 +1127,8 @@ public:
 
 			for(int r=0;r<num_training_pairs;r++)
 			{
-				i_data_sent = input_at(i_pos, i_data( r , _ ));
-
-				if(j_destination_selector==0) j_data_sent = input_at(j_pos, j_data( r , _ ));
-				if(j_destination_selector==1) j_data_sent = set_output_at(j_pos, j_data( r , _ ));
-				if(j_destination_selector==2) j_data_sent = set_misc_values_at(j_pos, j_data( r , _ ));
+				i_data_sent = input_row_at(i_pos, i_dataset.row(r), i_dataset.cols());
+				j_data_sent = send_row_at(j_pos, j_dataset.row(r), j_dataset.cols(), j_destination_selector);
 
 				if(NOT(i_data_sent AND j_data_sent))
 				{
@@ -792,15 +1136,197 @@ public:
 					return false;
 				}
 
-				encode_all(fwd);
+				m_nn.call_component_encode_all(fwd);
 			}
-			if(e%100==0) checkUserInterrupt();					// (RCpp function to check if user pressed cancel)
+			epochs_timed.epoch_done(num_training_pairs,e+1);
+			m_checkpoints.checkpoint_if_due(m_nn,e+1);			// (written in background)
+			flush_pending_messages();							// display any messages raised by other threads
+			if(interrupt_checks.due()) checkUserInterrupt();	// (RCpp function to check if user pressed cancel)
 		}
 
+		m_checkpoints.finish();
+
 		TEXTOUT << "Finished.\n";
 		return true;
 	}
 
+	// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+	// as encode_datasets_supervised, but training runs in the background (see
+	// encode_dataset_unsupervised_async).
+
+	bool encode_datasets_supervised_async (
+			NumericMatrix i_data,				// data set, each row is a vector i of vector-pair (i,j)
+			int i_pos,							// position (in topology) of component to receive i.
+			NumericMatrix j_data,				// data set, each row is the corresponding vector j of vector-pair (i,j)
+			int j_pos,							// position (in topology) of component to receive j.
+			int j_destination_selector,			// vector j will be sent to pe internal registers: 'input' if 0, to 'output' if 1, 'misc' if 2.
+			int epochs,							// training epochs (presentations of all data)
+			bool fwd							// processing direction (order) for components in NN
+	)
+	{
+		finish_training_job(m_job,"NN");
+
+		if( (i_data.rows()<=0) OR
+          (j_data.rows()<=0) OR
+          (i_data.rows()!=j_data.rows()) )
+		{
+			error(NN_DATAST_ERR,"Cannot perform supervised training, invalid dataset size(s)");
+			return false;
+		}
+
+		if(NOT can_train_in_background()) return false;
+
+		std::shared_ptr<row_major_dataset> i_dataset = std::make_shared<row_major_dataset>(i_data);
+		std::shared_ptr<row_major_dataset> j_dataset = std::make_shared<row_major_dataset>(j_data);
+		return start_background_training(i_dataset,i_pos,j_dataset,j_pos,j_destination_selector,epochs,fwd);
+	}
+
+	// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+	// background training: state ("none", "running", "completed", "cancelled" or
+	// "failed"), epochs completed and time elapsed (error level is not available).
+
+	List training_status()
+	{
+		flush_pending_messages();
+		return training_job_status(m_job);
+	}
+
+	bool cancel_training()
+	{
+		return m_job.cancel();									// (stops after current epoch)
+	}
+
+	// wait (up to given seconds, negative waits until finished), true if finished.
+
+	bool wait_training(double seconds)
+	{
+		return wait_for_training_job(m_job,seconds);
+	}
+
+	// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+	// Encode multiple (i,j) vector pairs read (in chunks, streamed) from a data set
+	// file. Each row contains vector i (as many values as the size of component
+	// at i_pos) followed by vector j (as many values as the size of component at j_pos).
+
+	bool encode_file_supervised	(
+			std::string filename,				// data set file...
+			std::string format,					// ...in "csv" or "binary" format
+			int i_pos,							// position (in topology) of component to receive i.
+			int j_pos,							// position (in topology) of component to receive j.
+			int j_destination_selector = 0,		// vector j will be sent to pe internal registers: 'input' if 0, to 'output' if 1, 'misc' if 2.
+			int epochs = 1000,					// training epochs (presentations of all data)
+			bool fwd = true,					// processing direction (order) for components in NN
+			bool shuffle = false				// present chunks in different (random) order in each epoch
+	)
+	{
+		finish_training_job(m_job,"NN");
+		int i_cols = size_of_component_at(i_pos);
+		int j_cols = size_of_component_at(j_pos);
+		if((i_cols<=0) OR (j_cols<=0))
+		{
+			error(NN_INTEGR_ERR,"Cannot perform supervised training, invalid component(s)");
+			return false;
+		}
+
+		dataset_stream dataset;
+		if(NOT open_dataset_file(dataset,filename,format,i_cols+j_cols)) return false;
+
+		TEXTOUT << "Encoding (supervised, streaming " << dataset.rows() << " rows from file)...\n";
+
+		int first_epoch = m_resume_from_epoch;					// (skip epochs completed before checkpoint)
+		m_resume_from_epoch = 0;
+		m_checkpoints.start();
+
+		epoch_counter epochs_timed("NN");						// (rows/sec per epoch and progress records, see nnlib2_counters.h)
+		interval_timer interrupt_checks(NN_INTERRUPT_CHECK_SECONDS);
+		for(int e=first_epoch;e<epochs;e++)
+		{
+			if(NOT m_nn.is_ready())
+			{
+				error(NN_DATAST_ERR,"Training failed");
+				return false;
+			}
+
+			int rows;
+			DATA PTR chunk;
+			dataset.start_epoch(shuffle);						// (next chunk is read in background while current is used)
+			while((chunk=dataset.next_chunk(rows))!=NULL)
+			{
+				for(int r=0;r<rows;r++)
+				{
+					DATA PTR row = chunk+(size_t)r*(i_cols+j_cols);
+					bool i_data_sent = input_row_at(i_pos, row, i_cols);
+					bool j_data_sent = send_row_at(j_pos, row+i_cols, j_cols, j_destination_selector);
+
+					if(NOT(i_data_sent AND j_data_sent))
+					{
+						error(NN_INTEGR_ERR,"Error sending the data to NN, training failed");
+						return false;
+					}
+
+					m_nn.call_component_encode_all(fwd);
+				}
+				if(interrupt_checks.due()) checkUserInterrupt();	// (RCpp function to check if user pressed cancel)
+			}
+			if(NOT dataset.no_error()) return false;
+
+			epochs_timed.epoch_done(dataset.rows(),e+1);
+			m_checkpoints.checkpoint_if_due(m_nn,e+1);			// (written in background)
+			flush_pending_messages();							// display any messages raised by other threads
+		}
+
+		m_checkpoints.finish();
+
+		TEXTOUT << "Finished.\n";
+		return true;
+	}
+
+	// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+	// take checkpoints (NN state and training epoch) while encoding datasets,
+	// every_epochs and/or every_seconds (0 if not used). They are written to file
+	// in background. Empty filename disables checkpoints.
+
+	bool set_checkpoints(std::string filename, int every_epochs, double every_seconds)
+	{
+		finish_training_job(m_job,"NN");
+		if(NOT m_checkpoints.setup(filename,every_epochs,every_seconds))
+		{
+			TEXTOUT << "NN checkpoints are disabled\n";
+			return false;
+		}
+		TEXTOUT << "NN checkpoints will be saved to file " << filename << "\n";
+		return true;
+	}
+
+	// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+	// between full checkpoints, take up to max_deltas delta checkpoints, which only
+	// append the changed values to a file (checkpoint filename + ".delta"); useful
+	// if training changes few weights per epoch. 0 (default) disables them.
+
+	bool set_delta_checkpoints(int max_deltas)
+	{
+		finish_training_job(m_job,"NN");
+		m_checkpoints.set_max_deltas(max_deltas);
+		return max_deltas>0;
+	}
+
+	// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+	// restore NN state from checkpoint file into current topology (which must be
+	// the same as when checkpoint was taken), so that the next encode_dataset(s)
+	// continues the interrupted one. Returns the number of epochs completed
+	// (negative if failed). Note: components defined in R are not restored.
+
+	int resume(std::string filename)
+	{
+		finish_training_job(m_job,"NN");
+		m_checkpoints.finish();									// (in case it is being written)
+		int completed_epochs = 0;
+		if(NOT load_checkpoint(m_nn,filename,completed_epochs,true)) return -1;
+		m_resume_from_epoch = completed_epochs;
+		TEXTOUT << "NN resumed from checkpoint file " << filename << " (" << completed_epochs << " epochs completed)\n";
+		return completed_epochs;
+	}
+
 	// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 	// Decode multiple input vectors stored in data set and get output.
 
@@ -810,6 +1336,7 @@ public:
                               bool fwd = true				// processing direction (order) for components in NN
 	)
 	{
+		finish_training_job(m_job,"NN");
 		NumericMatrix data_out;
 
 		if((input_pos<1) OR (input_pos>size()) OR
@@ -838,27 +1365,91 @@ public:
 
 		data_out= NumericMatrix(num_cases,out_component_size);
 
+		row_major_dataset dataset_in(data_in);					// (rows copied once, see Rcpp_dataset.h)
+		row_major_dataset dataset_out(num_cases,out_component_size);
+
 		for(int r=0;r<num_cases;r++)
 		{
-			if(NOT input_at(input_pos, data_in( r , _ ) ))
+			if(NOT input_row_at(input_pos, dataset_in.row(r), dataset_in.cols()))
 			{
 				error(NN_INTEGR_ERR,"Recall failed");
-				return data_out;
+				return dataset_out.to_matrix();					// (rows recalled so far)
 			}
-			recall_all(fwd);
-			NumericVector v_out = get_output_from(output_pos);
-			data_out( r , _ ) = v_out;                          //a lame way to interface with R. Copy result vector back to matrix. Remember, NumericMatrix stores data row-first, as R does.
+			m_nn.call_component_recall_all(fwd);
+			if(m_nn.set_component_for_output(output_pos-1))
+				if(NOT m_nn.output_data_to_vector(dataset_out.row(r),out_component_size))
+					warning("Cannot retreive output from specified component");
 		}
+		data_out = dataset_out.to_matrix();
+
+		flush_pending_messages();								// display any messages raised by other threads
 
 		return data_out;
 	}
 
 
+	// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+	// Recall a data set file, writing output to another file (in the same format),
+	// for data sets too large for memory. Input rows are read and output rows
+	// written in chunks by background threads, while the NN recalls the current
+	// chunk. Returns number of rows written (-1 if failed).
+
+	double recall_file(std::string input_file,			// data set file...
+                       std::string output_file,			// ...and file for results,
+                       std::string format,				// both in "csv" or "binary" format
+                       int input_pos,					// input component position
+                       int output_pos,					// output component position
+                       bool fwd = true					// processing direction (order) for components in NN
+	)
+	{
+		finish_training_job(m_job,"NN");
+		int in_component_size = size_of_component_at(input_pos);
+		int out_component_size = size_of_component_at(output_pos);
+
+		if((in_component_size<=0) OR (out_component_size<=0))
+		{
+			error(NN_INTEGR_ERR,"Invalid component position or size");
+			return -1;
+		}
+
+		dataset_pipeline pipeline;
+		if(NOT open_dataset_pipeline(pipeline,input_file,output_file,format,in_component_size,out_component_size)) return -1;
+
+		dataset_chunk in, out;
+		bool ok = true;
+		while(ok AND pipeline.next(in))
+		{
+			out.rows = in.rows;
+			out.values.assign((size_t) in.rows * out_component_size, 0);
+			for(int r=0;(r<in.rows) AND ok;r++)
+			{
+				if(NOT input_row_at(input_pos, in.values.data() + (size_t) r * in_component_size, in_component_size))
+				{
+					error(NN_INTEGR_ERR,"Recall failed");
+					out.rows = r;								// (rows recalled so far)
+					ok = false;
+					break;
+				}
+				m_nn.call_component_recall_all(fwd);
+				if(m_nn.set_component_for_output(output_pos-1))
+					if(NOT m_nn.output_data_to_vector(out.values.data() + (size_t) r * out_component_size,out_component_size))
+						warning("Cannot retreive output from specified component");
+			}
+			if(NOT pipeline.put(out)) break;					// (written in background)
+			flush_pending_messages();							// display any messages raised by other threads
+			checkUserInterrupt();
+		}
+
+		if(NOT pipeline.finish()) return -1;
+		return ok ? (double) pipeline.rows_written() : -1;
+	}
+
 	// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 	// get output (R to Cpp index converted)
 
 	NumericVector get_output_from(int pos)
 	{
+		finish_training_job(m_job,"NN");
 		NumericVector data_out;
 		if(m_nn.set_component_for_output(pos-1))
 			if(m_nn.output_dimension()>0)
@@ -876,6 +1467,7 @@ public:
 
 	NumericVector get_output_at(int pos)
 	{
+		finish_training_job(m_job,"NN");
 		return get_output_from(pos);
 	}
 
@@ -885,6 +1477,7 @@ public:
 
 	NumericVector get_input_at(int pos)
 	{
+		finish_training_job(m_job,"NN");
 		NumericVector data_out;
 
 		component PTR pc;
@@ -908,6 +1501,7 @@ public:
 
 	NumericVector get_weights_at(int pos)
 	{
+		finish_training_job(m_job,"NN");
 		NumericVector data_out;
 
 		component PTR pc;
@@ -936,6 +1530,7 @@ public:
 
 	bool set_weights_at(int pos, NumericVector data_in)
 	{
+		finish_training_job(m_job,"NN");
 		double * fpdata_in  = REAL(data_in);                    // my (lame?) way to interface with R, cont.)
 		if(!m_nn.set_weights_at_component(pos-1,fpdata_in,data_in.length()))
 		{
@@ -950,6 +1545,7 @@ public:
 
 	DATA get_weight_at(int pos, int connection)
 	{
+		finish_training_job(m_job,"NN");
 		return m_nn.get_weight_at_component(pos-1,connection);
 	}
 
@@ -958,6 +1554,7 @@ public:
 
 	bool set_weight_at(int pos, int connection, DATA value)
 	{
+		finish_training_job(m_job,"NN");
 		return m_nn.set_weight_at_component(pos-1,connection,value);
 	}
 
@@ -966,6 +1563,7 @@ public:
 
 	NumericVector get_misc_values_at(int pos)
 	{
+		finish_training_job(m_job,"NN");
 		NumericVector data_out;
 
 		component PTR pc;
@@ -989,6 +1587,7 @@ public:
 
 	bool set_misc_values_at(int pos, NumericVector data_in)
 	{
+		finish_training_job(m_job,"NN");
 		double * fpdata_in  = REAL(data_in);                    // my (lame?) way to interface with R, cont.)
 		return m_nn.set_misc_at_component(pos-1,fpdata_in,data_in.length());
 	}
@@ -998,6 +1597,7 @@ public:
 
 	bool set_output_at(int pos, NumericVector data_in)
 	{
+		finish_training_job(m_job,"NN");
 		double * fpdata_in  = REAL(data_in);                    // my (lame?) way to interface with R, cont.)
 		return m_nn.set_output_at_component(pos-1,fpdata_in,data_in.length());
 	}
@@ -1008,6 +1608,7 @@ public:
 
 	NumericVector get_biases_at(int pos)
 	{
+		finish_training_job(m_job,"NN");
 		NumericVector data_out;
 
 		component PTR pc;
@@ -1037,6 +1638,7 @@ public:
 
 	DATA get_bias_at(int pos, int pe)
 	{
+		finish_training_job(m_job,"NN");
 		return m_nn.get_bias_at_component(pos-1,pe);
 	}
 
@@ -1045,6 +1647,7 @@ public:
 
 	bool set_biases_at(int pos, NumericVector data_in)
 	{
+		finish_training_job(m_job,"NN");
 		double * fpdata_in  = REAL(data_in);                    // my (lame?) way to interface with R, cont.)
 		return m_nn.set_biases_at_component(pos-1,fpdata_in,data_in.length());
 	}
@@ -1054,6 +1657,7 @@ public:
 
 	bool set_bias_at(int pos, int pe, DATA value)
 	{
+		finish_training_job(m_job,"NN");
 		return m_nn.set_bias_at_component(pos-1,pe,value);
 	}
 
@@ -1061,6 +1665,7 @@ public:
 
 	void print()
 	{
+		finish_training_job(m_job,"NN");
 		TEXTOUT << "------Network structure (BEGIN)--------\n";
 		m_nn.to_stream(TEXTOUT);
 		TEXTOUT << "--------Network structure (END)--------\n";
@@ -1070,6 +1675,11 @@ public:
 
 	void show()
 	{
+		if(m_job.is_running())
+		{
+			TEXTOUT << "User-defined NN type (Class NN), training in background (see training_status).\n";
+			return;
+		}
 		TEXTOUT << "User-defined NN type (Class NN):\n\n";
 		outline();
 		TEXTOUT << "\n";
@@ -1080,6 +1690,7 @@ public:
 
 	void outline()
 	{
+		finish_training_job(m_job,"NN");
 		TEXTOUT << "------Network outline (BEGIN)--------\n";
 		TEXTOUT << m_nn.outline(true);
 		TEXTOUT << "--------Network outline (END)--------\n";
@@ -1089,6 +1700,7 @@ public:
 
 	DataFrame get_topology_info()
 	{
+		finish_training_job(m_job,"NN");
 		DataFrame result;
 
 		if(m_nn.size()<=0)
@@ -1132,6 +1744,64 @@ public:
 	}
 
 	// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+	// per-component profile: when enabled, encode and recall of each component are
+	// timed (see nnlib2_profiler.h). Enabling also clears previous records.
+
+	bool set_profiling(bool enable)
+	{
+		finish_training_job(m_job,"NN");
+		if(enable) m_nn.profiler().reset();
+		m_nn.profiler().enable(enable);
+		return m_nn.profiler().enabled();
+	}
+
+	DataFrame get_profile()
+	{
+		finish_training_job(m_job,"NN");
+		if(m_nn.size()<=0) warning("The NN is empty");
+		return profile_data_frame(m_nn);
+	}
+
+	void reset_profile()
+	{
+		finish_training_job(m_job,"NN");
+		m_nn.profiler().reset();
+	}
+
+	// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+	// approximate memory used by each component (data frame, aligned with
+	// get_topology_info); attribute "total_bytes" also includes the NN itself.
+
+	DataFrame memory_usage()
+	{
+		finish_training_job(m_job,"NN");
+		int components = m_nn.size();
+		if(components<=0) warning("The NN is empty");
+		if(components<0) components = 0;
+
+		IntegerVector position(components);
+		StringVector  name(components);
+		IntegerVector size(components);
+		NumericVector bytes(components);
+
+		for(int c=0;c<components;c++)
+		{
+			component PTR pc = m_nn.component_from_topology_index(c);
+			position[c] = c+1;
+			name[c]     = (pc!=NULL) ? pc->name() : "No Name";
+			size[c]     = (pc!=NULL) ? pc->size() : NA_INTEGER;
+			bytes[c]    = (pc!=NULL) ? (double) pc->memory_usage() : NA_REAL;
+		}
+
+		DataFrame result = DataFrame::create( Named("Position") = position,
+		                                      Named("Name")     = name,
+		                                      Named("Size")     = size,
+		                                      Named("Bytes")    = bytes );
+		result.attr("total_bytes") = (double) m_nn.memory_usage();
+		return result;
+	}
+
+	// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
 };
 
@@ -1181,7 +1851,18 @@ RCPP_MODULE(class_NN) {
      .method( "recall_all_bwd",    						&NN::recall_all_bwd,	   											"Trigger recall for entire topology, backward direction" )
      .method( "encode_dataset_unsupervised",     		&NN::encode_dataset_unsupervised,	   								"Encode a data set using unsupervised training" )
      .method( "encode_datasets_supervised",     		&NN::encode_datasets_supervised,	   								"Encode multiple (i,j) vector pairs using supervised training" )
+     .method( "encode_dataset_unsupervised_async",		&NN::encode_dataset_unsupervised_async,								"Encode a data set using unsupervised training, in the background" )
+     .method( "encode_datasets_supervised_async",		&NN::encode_datasets_supervised_async,								"Encode multiple (i,j) vector pairs using supervised training, in the background" )
+     .method( "training_status",						&NN::training_status,												"State and progress of background training" )
+     .method( "cancel_training",						&NN::cancel_training,												"Stop background training (after current epoch)" )
+     .method( "wait_training",							&NN::wait_training,													"Wait for background training to finish" )
+     .method( "encode_file_unsupervised",     		&NN::encode_file_unsupervised,	   									"Encode a data set streamed (in chunks) from a file using unsupervised training" )
+     .method( "encode_file_supervised",     			&NN::encode_file_supervised,	   									"Encode multiple (i,j) vector pairs streamed (in chunks) from a file using supervised training" )
+     .method( "set_checkpoints",     					&NN::set_checkpoints,				   								"Take checkpoints periodically when encoding data sets" )
+     .method( "set_delta_checkpoints",					&NN::set_delta_checkpoints,			   								"Take delta checkpoints (changed values only) between full ones" )
+     .method( "resume",     							&NN::resume,						   								"Restore NN state from checkpoint file (into current topology)" )
      .method( "recall_dataset",     					&NN::recall_dataset,				   								"Recall (i.e decode,map) a data set" )
+     .method( "recall_file",     						&NN::recall_file,				   									"Recall (i.e decode,map) a data set file, writing output to another file (streamed in chunks)" )
      .method( "get_output_from",     					&NN::get_output_from,    											"Output vector from specified topology index" )
      .method( "get_output_at",	     					&NN::get_output_at,    												"Output vector from specified topology index" )
      .method( "get_input_at",     						&NN::get_input_at,		   											"Get input (pe variable value or connection input) at specified topology index" )
@@ -1199,7 +1880,12 @@ RCPP_MODULE(class_NN) {
      .method( "print",     								&NN::print,         												"Print internal NN state" )
      .method( "show",     								&NN::show,         													"Print internal NN state" )
      .method( "outline",     							&NN::outline,         												"Show outline of the NN topology" )
+     .method( "clone",       							&NN::clone_nn,        												"Create a copy of this NN (weights in matrices are shared until changed)" )
      .method( "get_topology_info", 						&NN::get_topology_info,         									"Get NN topology information" )
+     .method( "set_profiling", 							&NN::set_profiling,         										"Enable or disable timing of each component's encode and recall" )
+     .method( "get_profile", 							&NN::get_profile,         											"Get per-component timing profile (data frame, aligned with get_topology_info)" )
+     .method( "reset_profile", 							&NN::reset_profile,         										"Clear per-component timing profile" )
+     .method( "memory_usage", 							&NN::memory_usage,         											"Get approximate memory used by each component (data frame, aligned with get_topology_info)" )
 	;
 }
 
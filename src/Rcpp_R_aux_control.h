@@ -146,6 +146,8 @@ void aux_control_R::do_R_magic()
 	if(m_R_function!="")	// this "" indicates, just transfer the original unchanged...
 	{
 	Function caller_of_R_function(m_R_function);
+	NN_COUNT(cnt_R_callbacks,1);
+	trace_scope traced("R callback",m_R_function.c_str());
 	if(m_ignore_result) caller_of_R_function(m_data);
 	else m_data = caller_of_R_function(m_data);
 	}
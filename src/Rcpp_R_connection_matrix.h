@@ -189,6 +189,8 @@ void R_connection_matrix::encode()
 	// Call the R function...
 
 	Function f(m_R_function_encode);
+	NN_COUNT(cnt_R_callbacks,1);
+	trace_scope traced("R callback",m_R_function_encode.c_str());
 	List ret_vals = f(	Named("WEIGHTS")=weights,
             			Named("SOURCE_INPUT")=v_source_in,
             			Named("SOURCE_OUTPUT")=v_source_out,
@@ -215,8 +217,15 @@ void R_connection_matrix::encode()
 		// only connection set weights (and possibly misc) are modified during a connection set "encode".
 
 		for(int d=0;d<destin_size;d++)
-			for(int s=0;s<source_size;s++)
-				m_weights[d][s]=weights(s,d);	// transposed (see note above).
+		{
+			int s=0;
+			while((s<source_size) AND (m_weights[d][s]==weights(s,d))) s++;
+			if(s>=source_size) continue;		// (unchanged rows stay shared with any clones)
+			DATA PTR row = writable_row(d);
+			if(row==NULL) return;
+			for(s=0;s<source_size;s++)
+				row[s]=weights(s,d);			// transposed (see note above).
+		}
 	}
 
 	if(uses_misc())
@@ -262,6 +271,8 @@ void R_connection_matrix::recall()
 	// Call the R function...
 
 	Function f(m_R_function_recall);
+	NN_COUNT(cnt_R_callbacks,1);
+	trace_scope traced("R callback",m_R_function_recall.c_str());
 
 	NumericMatrix out_vals = f(	Named("WEIGHTS")=weights,
             					Named("SOURCE_INPUT")=v_source_in,
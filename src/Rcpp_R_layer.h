@@ -128,6 +128,8 @@ void R_layer::encode()
 		// Call the R function...
 
 		Function f(m_R_function_encode);
+		NN_COUNT(cnt_R_callbacks,1);
+		trace_scope traced("R callback",m_R_function_encode.c_str());
 
 		List ret_vals = f(	Named("INPUT")=input,
 	                        Named("INPUT_Q")=input_q,
@@ -214,6 +216,8 @@ void R_layer::recall()
 	    // Call the R function...
 
 	    Function f(m_R_function_recall);
+	    NN_COUNT(cnt_R_callbacks,1);
+	    trace_scope traced("R callback",m_R_function_recall.c_str());
 
 	    NumericVector ret_vals = f(	Named("INPUT")=input,
 	                                Named("INPUT_Q")=input_q,
@@ -54,6 +54,7 @@ public:
                bool ignore_result );
 
 	int size();															   // size of m_data (input and output). NOTE: this changes dynamically!
+	size_t memory_usage();												   // approximate bytes used (including m_data buffer)
 
 	bool input_data_from_vector(DATA * data, int dimension);               // overrides virtual method in data_receiver, sets values for m_data
 	bool output_data_to_vector(DATA * buffer, int dimension);              // overrides virtual method in data_provider, gets values from m_data
@@ -147,6 +148,8 @@ void aux_control_R::do_R_magic()
 	if(m_R_function!="")	// this "" indicates, just transfer the original unchanged...
 	{
 	Function caller_of_R_function(m_R_function);
+	NN_COUNT(cnt_R_callbacks,1);
+	trace_scope traced("R callback",m_R_function.c_str());
 	if(m_ignore_result) caller_of_R_function(m_data);
 	else m_data = caller_of_R_function(m_data);
 	}
@@ -162,6 +165,14 @@ int aux_control_R::size() {return m_data.length();}
 
 //--------------------------------------------------------------------------------
 
+size_t aux_control_R::memory_usage()
+{
+	return sizeof(aux_control_R) + (size_t) m_data.length() * sizeof(double) +
+	       m_R_function.capacity() + m_input_mode.capacity() + m_output_mode.capacity();
+}
+
+//--------------------------------------------------------------------------------
+
 void aux_control_R::encode ()
 {
 	if(m_active_on_encode) do_R_magic();
@@ -0,0 +1,56 @@
+//		----------------------------------------------------------
+//		(c)2026  Vasilis.N.Nikolaidis          All rights reserved.
+//		-----------------------------------------------------------
+//    Rcpp glue code for hot path performance counters (see nnlib2_counters.h)
+//		-----------------------------------------------------------
+
+#include "nnlib2.h"
+
+#ifdef NNLIB2_FOR_RCPP
+using namespace Rcpp;
+
+//--------------------------------------------------------------------------------
+
+#include "nnlib2_counters.h"
+
+using namespace nnlib2;
+
+//--------------------------------------------------------------------------------
+// snapshot of all counters (named numeric vector), plus derived throughput
+// (rows per second) for the last completed epoch and for all training so far.
+
+// [[Rcpp::export]]
+NumericVector performance_counters()
+{
+	NumericVector values(NN_NUMBER_OF_COUNTERS+2);
+	CharacterVector names(NN_NUMBER_OF_COUNTERS+2);
+
+	for(int c=0;c<NN_NUMBER_OF_COUNTERS;c++)
+	{
+		values[c] = (double) hot_path_counters.value((nn_counter)c);
+		names[c]  = nn_counters::name((nn_counter)c);
+	}
+
+	double ns = values[cnt_last_epoch_nanoseconds];
+	values[NN_NUMBER_OF_COUNTERS] = (ns>0) ? values[cnt_last_epoch_rows] * 1e9 / ns : NA_REAL;
+	names[NN_NUMBER_OF_COUNTERS] = "last_epoch_rows_per_second";
+
+	ns = values[cnt_training_nanoseconds];
+	values[NN_NUMBER_OF_COUNTERS+1] = (ns>0) ? values[cnt_training_rows] * 1e9 / ns : NA_REAL;
+	names[NN_NUMBER_OF_COUNTERS+1] = "training_rows_per_second";
+
+	values.names() = names;
+	return values;
+}
+
+//--------------------------------------------------------------------------------
+
+// [[Rcpp::export]]
+void reset_performance_counters()
+{
+	hot_path_counters.reset();
+}
+
+//--------------------------------------------------------------------------------
+
+#endif // NNLIB2_FOR_RCPP
@@ -0,0 +1,131 @@
+//		----------------------------------------------------------
+//		(c)2026  Vasilis.N.Nikolaidis          All rights reserved.
+//		-----------------------------------------------------------
+//    	row-major data sets for Rcpp glue code (nnlib2Rcpp)
+//		-----------------------------------------------------------
+//		R matrices are stored column-major, so taking a row (as in
+//		data(r,_)) allocates a new NumericVector and gathers values
+//		that are apart in memory, for every row in every epoch.
+//		Instead, a data set is copied once (per call) to a contiguous
+//		row-major buffer, whose rows are passed (as DATA pointers) to
+//		NN functions. Results can be collected in the same way and
+//		copied to an R matrix once, at the end.
+//		Data sets too large for memory can be streamed from files
+//		instead (see nnlib2_dataset_stream.h, open_dataset_file below),
+//		and processed from file to file (open_dataset_pipeline below).
+//		-----------------------------------------------------------
+
+#include "nnlib2.h"
+
+#ifdef NNLIB2_FOR_RCPP
+
+#ifndef RCPP_NN_DATASET
+#define RCPP_NN_DATASET
+
+#include "nnlib2_dataset_stream.h"
+#include <vector>
+
+using namespace nnlib2;
+
+//--------------------------------------------------------------------------------
+
+class row_major_dataset
+{
+private:
+
+	std::vector<DATA> m_values;
+	int m_rows;
+	int m_cols;
+
+public:
+
+	row_major_dataset(int rows, int cols)			// (values are 0)
+	{
+		m_rows = (rows>0) ? rows : 0;
+		m_cols = (cols>0) ? cols : 0;
+		m_values.assign((size_t) m_rows * m_cols, 0);
+	}
+
+	row_major_dataset(NumericMatrix m)				// copy of (column-major) R matrix
+	{
+		m_rows = m.rows();
+		m_cols = m.cols();
+		m_values.resize((size_t) m_rows * m_cols);
+
+		const double PTR source = REAL(m);
+		const int block_rows = 64;					// (transpose in blocks of rows, so that writes stay in cache)
+		for(int first=0;first<m_rows;first+=block_rows)
+		{
+			int last = (first+block_rows<m_rows) ? first+block_rows : m_rows;
+			for(int c=0;c<m_cols;c++)
+			{
+				const double PTR column = source + (size_t) c * m_rows;
+				for(int r=first;r<last;r++)
+					m_values[(size_t) r * m_cols + c] = (DATA) column[r];
+			}
+		}
+	}
+
+	int rows()			{ return m_rows; }
+	int cols()			{ return m_cols; }
+	DATA PTR row(int r)	{ return m_values.data() + (size_t) r * m_cols; }		// (r is not checked)
+
+	NumericMatrix to_matrix()						// copy to new (column-major) R matrix
+	{
+		NumericMatrix m(m_rows,m_cols);
+		double PTR destination = REAL(m);
+		for(int r=0;r<m_rows;r++)
+		{
+			const DATA PTR values = row(r);
+			for(int c=0;c<m_cols;c++)
+				destination[(size_t) c * m_rows + r] = (double) values[c];
+		}
+		return m;
+	}
+};
+
+//--------------------------------------------------------------------------------
+// open data set file for streaming; format is "csv" or "binary" (which requires
+// cols). If cols is given (>0), the file must have this number of columns.
+
+inline bool open_dataset_file(dataset_stream REF s, std::string filename, std::string format, int cols)
+{
+	dataset_file_format f;
+	if(!dataset_file_format_from_name(format,f))
+	{
+		error(NN_DATAST_ERR,"Unknown data set file format (use \"csv\" or \"binary\")");
+		return false;
+	}
+	if(!s.open(filename,f,cols))
+	{
+		s.reset_error();								// (already reported)
+		return false;
+	}
+	return true;
+}
+
+//--------------------------------------------------------------------------------
+// open input and output data set files (in the same format, "csv" or "binary")
+// for file-to-file processing (s.a. recall).
+
+inline bool open_dataset_pipeline(dataset_pipeline REF p, std::string input_filename, std::string output_filename,
+                                  std::string format, int input_cols, int output_cols)
+{
+	dataset_file_format f;
+	if(!dataset_file_format_from_name(format,f))
+	{
+		error(NN_DATAST_ERR,"Unknown data set file format (use \"csv\" or \"binary\")");
+		return false;
+	}
+	if(!p.open(input_filename,f,input_cols,output_filename,output_cols))
+	{
+		p.reset_error();								// (already reported)
+		return false;
+	}
+	return true;
+}
+
+//--------------------------------------------------------------------------------
+
+#endif // RCPP_NN_DATASET
+#endif // NNLIB2_FOR_RCPP
@@ -0,0 +1,71 @@
+//		----------------------------------------------------------
+//		(c)2026  Vasilis.N.Nikolaidis          All rights reserved.
+//		-----------------------------------------------------------
+//    	per-component profile of NNs for Rcpp glue code (nnlib2Rcpp)
+//		-----------------------------------------------------------
+//		Converts the timing records of a nn (see nnlib2_profiler.h)
+//		to an R data frame, one row per component in topology (in
+//		the same order as NN$get_topology_info()).
+//		-----------------------------------------------------------
+
+#include "nnlib2.h"
+
+#ifdef NNLIB2_FOR_RCPP
+
+#ifndef RCPP_NN_PROFILE
+#define RCPP_NN_PROFILE
+
+#include "nn.h"
+
+using namespace nnlib2;
+
+//--------------------------------------------------------------------------------
+
+inline DataFrame profile_data_frame(nn REF n)
+{
+	int components = n.size();
+	if(components<0) components = 0;
+
+	IntegerVector position(components);
+	StringVector  name(components);
+	IntegerVector size(components);
+	NumericVector encode_calls(components);
+	NumericVector encode_seconds(components);
+	NumericVector encode_max_seconds(components);
+	NumericVector recall_calls(components);
+	NumericVector recall_seconds(components);
+	NumericVector recall_max_seconds(components);
+	NumericVector items(components);
+
+	for(int c=0;c<components;c++)
+	{
+		component PTR pc = n.component_from_topology_index(c);
+		component_profile p = n.profiler().record(c);
+		position[c]           = c+1;
+		name[c]               = (pc!=NULL) ? pc->name() : "No Name";
+		size[c]               = (pc!=NULL) ? pc->size() : NA_INTEGER;
+		encode_calls[c]       = (double) p.encode_calls;
+		encode_seconds[c]     = (double) p.encode_nanoseconds / 1e9;
+		encode_max_seconds[c] = (double) p.encode_max_nanoseconds / 1e9;
+		recall_calls[c]       = (double) p.recall_calls;
+		recall_seconds[c]     = (double) p.recall_nanoseconds / 1e9;
+		recall_max_seconds[c] = (double) p.recall_max_nanoseconds / 1e9;
+		items[c]              = (double) p.items_processed;
+	}
+
+	return DataFrame::create( Named("Position")           = position,
+	                          Named("Name")               = name,
+	                          Named("Size")               = size,
+	                          Named("Encode_Calls")       = encode_calls,
+	                          Named("Encode_Seconds")     = encode_seconds,
+	                          Named("Encode_Max_Seconds") = encode_max_seconds,
+	                          Named("Recall_Calls")       = recall_calls,
+	                          Named("Recall_Seconds")     = recall_seconds,
+	                          Named("Recall_Max_Seconds") = recall_max_seconds,
+	                          Named("Items_Processed")    = items );
+}
+
+//--------------------------------------------------------------------------------
+
+#endif // RCPP_NN_PROFILE
+#endif // NNLIB2_FOR_RCPP
@@ -0,0 +1,72 @@
+//		----------------------------------------------------------
+//		(c)2026  Vasilis.N.Nikolaidis          All rights reserved.
+//		-----------------------------------------------------------
+//    Rcpp glue code for training progress records (see nnlib2_progress.h)
+//		-----------------------------------------------------------
+
+#include "nnlib2.h"
+
+#ifdef NNLIB2_FOR_RCPP
+using namespace Rcpp;
+
+//--------------------------------------------------------------------------------
+
+#include "nnlib2_progress.h"
+#include <cmath>
+
+using namespace nnlib2;
+
+//--------------------------------------------------------------------------------
+// records (still kept) added after the one with given sequence number, as a
+// data frame (oldest first). To poll, pass the last sequence number seen.
+
+// [[Rcpp::export]]
+DataFrame get_training_progress(double since = 0)
+{
+	if(since<0) since = 0;
+	std::vector<progress_record> records = progress_channel.records_after((uint64_t) since);
+	int n = (int) records.size();
+
+	NumericVector   sequence(n);
+	IntegerVector   run(n);
+	CharacterVector model(n);
+	IntegerVector   epoch(n);
+	NumericVector   rows(n);
+	NumericVector   error_level(n);
+	NumericVector   rows_per_second(n);
+	NumericVector   elapsed_seconds(n);
+
+	for(int i=0;i<n;i++)
+	{
+		progress_record REF p = records[i];
+		sequence[i]        = (double) p.sequence;
+		run[i]             = p.run;
+		model[i]           = (p.model==NULL) ? "" : p.model;
+		epoch[i]           = p.epoch;
+		rows[i]            = (double) p.rows;
+		error_level[i]     = std::isnan(p.error_level) ? NA_REAL : p.error_level;
+		rows_per_second[i] = p.rows_per_second;
+		elapsed_seconds[i] = p.elapsed_seconds;
+	}
+
+	return DataFrame::create(	Named("sequence") = sequence,
+								Named("run") = run,
+								Named("model") = model,
+								Named("epoch") = epoch,
+								Named("rows") = rows,
+								Named("error_level") = error_level,
+								Named("rows_per_second") = rows_per_second,
+								Named("elapsed_seconds") = elapsed_seconds );
+}
+
+//--------------------------------------------------------------------------------
+
+// [[Rcpp::export]]
+void reset_training_progress()
+{
+	progress_channel.reset();
+}
+
+//--------------------------------------------------------------------------------
+
+#endif // NNLIB2_FOR_RCPP
@@ -0,0 +1,68 @@
+//		----------------------------------------------------------
+//		(c)2026  Vasilis.N.Nikolaidis          All rights reserved.
+//		-----------------------------------------------------------
+//    Rcpp glue code for event tracing (see nnlib2_trace.h)
+//		-----------------------------------------------------------
+
+#include "nnlib2.h"
+
+#ifdef NNLIB2_FOR_RCPP
+using namespace Rcpp;
+
+//--------------------------------------------------------------------------------
+
+#include "nnlib2_trace.h"
+#include "nnlib2_error.h"
+#include <fstream>
+
+using namespace nnlib2;
+
+//--------------------------------------------------------------------------------
+// enable or disable tracing (of all NNs). Returns previous setting.
+
+// [[Rcpp::export]]
+bool set_tracing(bool on = true)
+{
+#ifndef NN_TRACING
+	if(on) warning("Tracing is not available (NN_TRACING was not defined when package was compiled)");
+#endif
+	bool was_on = event_tracer.enabled();
+	event_tracer.enable(on);
+	return was_on;
+}
+
+//--------------------------------------------------------------------------------
+// write recorded events to a Chrome trace (JSON) file, for viewing in
+// https://ui.perfetto.dev or chrome://tracing. Returns the number of events
+// written (-1 if failed).
+
+// [[Rcpp::export]]
+int write_trace(std::string filename)
+{
+	std::ofstream f(filename.c_str(), std::ios::trunc);
+	if(NOT f.good())
+	{
+		error(NN_IOFILE_ERR,"Cannot create trace file " + filename);
+		return -1;
+	}
+	int events = event_tracer.write_chrome_trace(f);
+	f.close();
+	if(f.fail())
+	{
+		error(NN_IOFILE_ERR,"Cannot write trace file " + filename);
+		return -1;
+	}
+	return events;
+}
+
+//--------------------------------------------------------------------------------
+
+// [[Rcpp::export]]
+void reset_trace()
+{
+	event_tracer.reset();
+}
+
+//--------------------------------------------------------------------------------
+
+#endif // NNLIB2_FOR_RCPP
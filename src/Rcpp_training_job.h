@@ -0,0 +1,77 @@
+//		----------------------------------------------------------
+//		(c)2026  Vasilis.N.Nikolaidis          All rights reserved.
+//		-----------------------------------------------------------
+//    	background training jobs for Rcpp glue code (nnlib2Rcpp)
+//		-----------------------------------------------------------
+//		Helpers for R classes that train their NN in the background
+//		(see nnlib2_training_job.h): job status as an R list, and
+//		waiting for a job while still responding to user interrupts
+//		and displaying any messages (errors, warnings) from the job.
+//		-----------------------------------------------------------
+
+#include "nnlib2.h"
+
+#ifdef NNLIB2_FOR_RCPP
+
+#ifndef RCPP_NN_TRAINING_JOB
+#define RCPP_NN_TRAINING_JOB
+
+#include "nnlib2_training_job.h"
+#include "nnlib2_progress.h"
+#include <cmath>
+
+using namespace nnlib2;
+
+//--------------------------------------------------------------------------------
+
+inline List training_job_status(training_job REF job)
+{
+	double error_level = job.error_level();
+
+	return List::create( Named("state")            = training_job::state_name(job.state()),
+	                     Named("epochs")           = job.epochs(),
+	                     Named("epochs_completed") = job.epochs_completed(),
+	                     Named("error_level")      = std::isnan(error_level) ? NA_REAL : error_level,
+	                     Named("elapsed_seconds")  = job.elapsed_seconds() );
+}
+
+//--------------------------------------------------------------------------------
+// wait up to given seconds (negative waits until job finishes), true if finished.
+
+inline bool wait_for_training_job(training_job REF job, double seconds)
+{
+	bool finished = false;
+	std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+	for(;;)
+	{
+		double slice = NN_INTERRUPT_CHECK_SECONDS;
+		if(seconds>=0)
+		{
+			double left = seconds - std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+			if(left<slice) slice = (left>0) ? left : 0;
+		}
+		finished = job.wait(slice);
+		flush_pending_messages();							// (errors or warnings from job)
+		if(finished OR (slice<NN_INTERRUPT_CHECK_SECONDS)) break;
+		checkUserInterrupt();								// (job continues if user cancels waiting)
+	}
+	return finished;
+}
+
+//--------------------------------------------------------------------------------
+// called before using a NN that may be trained in the background.
+
+inline void finish_training_job(training_job REF job, const char PTR nn_name)
+{
+	if(job.is_running())
+	{
+		TEXTOUT << "Waiting for background training of " << nn_name << " to finish...\n";
+		wait_for_training_job(job,-1);
+	}
+	flush_pending_messages();
+}
+
+//--------------------------------------------------------------------------------
+
+#endif // RCPP_NN_TRAINING_JOB
+#endif // NNLIB2_FOR_RCPP
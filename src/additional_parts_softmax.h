@@ -21,6 +21,7 @@ public:
 	{
 		if(no_error())
 		{
+			NN_COUNT(cnt_exp_evaluations,2*size());						// (exp is computed twice per PE)
 			DATA denom=0;
 			for(int i=0;i<size();i++)
 			{
@@ -57,6 +58,7 @@ public:
 	{
 		if(no_error())
 		{
+			NN_COUNT(cnt_exp_evaluations,2*size());						// (exp is computed twice per PE)
 			DATA denom=0;
 			for(int i=0;i<size();i++)
 			{
@@ -93,6 +95,7 @@ public:
 	{
 		if(no_error())
 		{
+			NN_COUNT(cnt_exp_evaluations,2*size());						// (exp is computed twice per PE)
 			DATA denom=0;
 			for(int i=0;i<size();i++)
 			{
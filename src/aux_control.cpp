@@ -30,7 +30,7 @@ aux_control::aux_control()
 // example of	component for misc functionality
 /*-----------------------------------------------------------------------*/
 
-aux_txt_printer::aux_txt_printer(bool PTR error_flag_to_use)
+aux_txt_printer::aux_txt_printer(error_flag_t PTR error_flag_to_use)
 {
 	mp_layer=NULL;
 	m_name="Print component";
@@ -39,7 +39,7 @@ aux_txt_printer::aux_txt_printer(bool PTR error_flag_to_use)
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-aux_txt_printer::aux_txt_printer(layer PTR p_layer, bool PTR error_flag_to_use)
+aux_txt_printer::aux_txt_printer(layer PTR p_layer, error_flag_t PTR error_flag_to_use)
 		{
 		mp_layer=NULL;
 		m_name="Print component";
@@ -48,7 +48,7 @@ aux_txt_printer::aux_txt_printer(layer PTR p_layer, bool PTR error_flag_to_use)
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-void aux_txt_printer::setup(layer PTR p_layer, bool PTR error_flag_to_use)
+void aux_txt_printer::setup(layer PTR p_layer, error_flag_t PTR error_flag_to_use)
 {
 	mp_layer=p_layer;
 	set_error_flag(error_flag_to_use);
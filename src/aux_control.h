@@ -49,9 +49,9 @@ private:
 protected:
 	void print();
 public:
-	aux_txt_printer(bool PTR error_flag_to_use=NULL);
-	aux_txt_printer(layer PTR p_layer, bool PTR error_flag_to_use=NULL);
-	void setup(layer PTR p_layer, bool PTR error_flag_to_use=NULL);
+	aux_txt_printer(error_flag_t PTR error_flag_to_use=NULL);
+	aux_txt_printer(layer PTR p_layer, error_flag_t PTR error_flag_to_use=NULL);
+	void setup(layer PTR p_layer, error_flag_t PTR error_flag_to_use=NULL);
 	void encode ();
 	void recall ();
 };
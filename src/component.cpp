@@ -8,6 +8,8 @@
 
 
 #include "component.h"
+#include "nnlib2_binary.h"
+#include "nnlib2_text_reader.h"
 
 // implementation follows:
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -84,6 +86,16 @@ void component::from_stream (std::istream REF s)
  s >> comment >> m_auxiliary_parameter;
  }
 
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// input it (from text model reader, same format as above):
+
+void component::from_text (text_model_reader REF r)
+ {
+ if(r.skip() AND r.read(m_name))						// name
+  if(r.skip(4))											// id and type (not used)
+   if(r.skip()) r.read(m_auxiliary_parameter);
+ }
+
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 // output it :
 
@@ -101,6 +113,25 @@ void component::to_stream (std::ostream REF s)
   s << "Aux.Param: " 	<< m_auxiliary_parameter  << "\n";
  }
 
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// output it (binary):
+
+bool component::to_binary (binary_writer REF w)
+ {
+ return w.begin_component(*this,bin_header_only,0,0) AND w.end_component();
+ }
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// input it (binary):
+
+bool component::from_binary (binary_component_block REF b)
+ {
+ if(b.type()!=m_type) {error(NN_IOFILE_ERR,"Stored component is of different type"); return false;}
+ m_name = b.name;
+ m_auxiliary_parameter = (DATA) b.header->auxiliary_parameter;
+ return true;
+ }
+
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
 }   // end of namespace nnlib2
@@ -18,6 +18,11 @@
 
 namespace nnlib2 {
 
+class binary_writer;					// see nnlib2_binary.h
+class binary_component_block;
+class binary_delta_writer;
+class text_model_reader;				// see nnlib2_text_reader.h
+
 //-----------------------------------------------------------------------
 
 enum component_type    {cmpnt_unknown,                   // no type.
@@ -60,12 +65,18 @@ class component
 
  virtual void from_stream ( std::istream REF s );
  virtual void to_stream   ( std::ostream REF s );
+ virtual void from_text   ( text_model_reader REF r );					// faster alternative to from_stream (same format); this only reads the header, override to retrieve data.
+
+ virtual bool to_binary   ( binary_writer REF w );						// write to binary model file; this only writes a header, override to store data.
+ virtual bool from_binary ( binary_component_block REF b );				// read from block of binary model file; this only reads header info (name etc), override to retrieve data.
+ virtual bool write_changes ( binary_delta_writer PTR w ) {return true;}	// write values changed since last call (for delta checkpoints); if w is NULL, only (re)start tracking changes. Return false if changes cannot be written this way (s.a. sizes changed). Override if to_binary stores data.
 
  int id()                       { return m_id; }
  component_type type()          { return m_type; }
  DATA auxiliary_parameter()     { return m_auxiliary_parameter; }
 
  virtual int size () {return 0;};
+ virtual size_t memory_usage () {return sizeof(component);}	// approximate bytes used by component (object and data it allocates). Override if component allocates data.
  };
 
 //-----------------------------------------------------------------------
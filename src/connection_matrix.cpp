@@ -14,8 +14,11 @@
 
 #include "connection_matrix.h"
 #include "nnlib2_memory.h"
+#include "nnlib2_text_reader.h"
 
 #include <sstream>
+#include <cstring>
+#include <cstdlib>
 
 namespace nnlib2 {
 
@@ -41,6 +44,9 @@ generic_connection_matrix::generic_connection_matrix()
 	m_allocated_cols_source_layer_size = 0;
 
 	m_requires_misc = false;
+	m_weights_in_place = false;
+	mp_disk_weights = NULL;
+	mp_disk_misc = NULL;
 
 	m_weights = NULL;
 	m_misc = NULL;
@@ -101,6 +107,31 @@ bool generic_connection_matrix::sizes_are_consistent()
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
+size_t generic_connection_matrix::memory_usage()
+{
+	size_t bytes = sizeof(generic_connection_matrix);
+	size_t rows = (size_t) m_allocated_rows_destin_layer_size;
+	size_t values = rows * (size_t) m_allocated_cols_source_layer_size;
+
+	if(m_weights!=NULL)
+	{
+		if(mp_disk_weights==NULL) bytes += rows * sizeof(DATA PTR);		// (rows in disk files are not counted, only mapped)
+		if(NOT m_shared_rows.empty())
+		{
+			size_t row_bytes = (size_t) m_allocated_cols_source_layer_size * sizeof(DATA);
+			for(size_t r=0;r<m_shared_rows.size();r++)						// (shared rows are counted in proportion)
+				bytes += row_bytes / (size_t) m_shared_rows[r].use_count() + sizeof(std::shared_ptr<DATA>);
+		}
+		else
+		if((mp_disk_weights==NULL) AND (NOT m_weights_in_place)) bytes += values * sizeof(DATA);
+	}
+	if((m_misc!=NULL) AND (mp_disk_misc==NULL))
+		bytes += rows * sizeof(DATA PTR) + values * sizeof(DATA);
+	return bytes;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
 int generic_connection_matrix::size()
 {
 
@@ -124,24 +155,263 @@ int generic_connection_matrix::size()
 
 void generic_connection_matrix::reset_matrices()
 {
-	if(m_weights!=NULL)
-	{
-		if(m_allocated_rows_destin_layer_size<=0) warning("Inconsistent  sizes");
-		free_2d(m_weights,m_allocated_rows_destin_layer_size);
-		m_weights=NULL;
-	}
+	if(((m_weights!=NULL) OR (m_misc!=NULL)) AND (m_allocated_rows_destin_layer_size<=0))
+		warning("Inconsistent  sizes");
 
-	if(m_misc!=NULL)
+	if(NOT m_shared_rows.empty())
 	{
-		if(m_allocated_rows_destin_layer_size<=0) warning("Inconsistent  sizes");
-		free_2d(m_misc,m_allocated_rows_destin_layer_size);
-		m_misc=NULL;
+		if(m_weights!=NULL) free(m_weights);					// (only the array of row pointers, rows are released with m_shared_rows)
+		m_weights = NULL;
+		m_shared_rows.clear();
 	}
 
+	release_rows(m_weights,m_allocated_rows_destin_layer_size,m_weights_in_place,mp_disk_weights);
+	release_rows(m_misc,m_allocated_rows_destin_layer_size,false,mp_disk_misc);
+
+	m_weights = NULL;
+	m_misc = NULL;
+	mp_disk_weights = NULL;
+	mp_disk_misc = NULL;
+	m_weights_in_place = false;
+
 	m_allocated_rows_destin_layer_size = 0;
 	m_allocated_cols_source_layer_size = 0;
 }
 
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// frees a matrix, as allocated by allocate_rows (or used in place)
+
+void generic_connection_matrix::release_rows(DATA ** rows, int number_of_rows, bool in_place, disk_matrix PTR p_disk)
+{
+	if(p_disk!=NULL) {delete p_disk; return;}					// (rows are in disk file)
+	if(rows==NULL) return;
+	if(in_place) free(rows);									// (rows are not owned)
+	else free_2d(rows,number_of_rows);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// allocates a matrix in memory, or in given disk file (returns NULL if failed)
+
+DATA ** generic_connection_matrix::allocate_rows(int rows, int cols, string filename, disk_matrix PTR REF p_disk)
+{
+	p_disk = NULL;
+	if(filename.empty()) return malloc_2d(rows,cols);
+	p_disk = new disk_matrix;
+	return p_disk->create(filename,rows,cols);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// (re)allocates matrices for given sizes (contents are set to 0)
+
+bool generic_connection_matrix::allocate_matrices(int rows, int cols)
+{
+	reset_matrices();
+
+	if((rows<=0) OR (cols<=0)) {error(NN_INTEGR_ERR,"Invalid connections matrix size");return false;}
+
+	m_allocated_rows_destin_layer_size = rows;
+	m_allocated_cols_source_layer_size = cols;
+
+	m_weights = allocate_rows(rows,cols,m_weights_filename,mp_disk_weights);
+
+	if(m_requires_misc AND (m_weights!=NULL))
+		m_misc = allocate_rows(rows,cols,m_weights_filename.empty() ? "" : m_weights_filename + ".misc",mp_disk_misc);
+
+	if((m_weights==NULL) OR (m_requires_misc AND (m_misc==NULL)))
+	{
+		reset_matrices();
+		error(NN_INTEGR_ERR,"Cannot allocate memory for connections matrix");
+		return false;
+	}
+
+	return true;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// store matrices in (memory-mapped) disk file, or (if filename is empty) in
+// memory. Can be set before matrices are created (s.a. by fully_connect) or
+// later, in which case current values are moved to the new storage.
+
+bool generic_connection_matrix::set_weights_file(string filename)
+{
+	if(filename==m_weights_filename) return true;
+
+	int rows = m_allocated_rows_destin_layer_size;
+	int cols = m_allocated_cols_source_layer_size;
+
+	if((m_weights==NULL) OR (rows<=0) OR (cols<=0))
+	{
+		m_weights_filename = filename;
+		return true;
+	}
+
+	// keep current matrices and allocate new ones...
+
+	DATA ** old_weights = m_weights;
+	DATA ** old_misc = m_misc;
+	disk_matrix PTR old_disk_weights = mp_disk_weights;
+	disk_matrix PTR old_disk_misc = mp_disk_misc;
+	bool old_weights_in_place = m_weights_in_place;
+	string old_weights_filename = m_weights_filename;
+	std::vector< std::shared_ptr<DATA> > old_shared_rows;
+	old_shared_rows.swap(m_shared_rows);
+
+	m_weights = NULL;
+	m_misc = NULL;
+	mp_disk_weights = NULL;
+	mp_disk_misc = NULL;
+	m_weights_in_place = false;
+	m_weights_filename = filename;
+
+	if(NOT allocate_matrices(rows,cols))
+	{
+		// ...restore old ones if failed...
+
+		m_weights = old_weights;
+		m_misc = old_misc;
+		mp_disk_weights = old_disk_weights;
+		mp_disk_misc = old_disk_misc;
+		m_weights_in_place = old_weights_in_place;
+		m_weights_filename = old_weights_filename;
+		m_shared_rows.swap(old_shared_rows);
+		m_allocated_rows_destin_layer_size = rows;
+		m_allocated_cols_source_layer_size = cols;
+		return false;
+	}
+
+	// ...otherwise copy values (row by row) and free old matrices.
+
+	for(int r=0;r<rows;r++)
+	{
+		row_access_hint(r,true);
+		memcpy(m_weights[r], old_weights[r], sizeof(DATA) * cols);
+		if(old_misc!=NULL) memcpy(m_misc[r], old_misc[r], sizeof(DATA) * cols);
+	}
+
+	if(NOT old_shared_rows.empty()) free(old_weights);			// (rows are released with old_shared_rows)
+	else release_rows(old_weights,rows,old_weights_in_place,old_disk_weights);
+	release_rows(old_misc,rows,false,old_disk_misc);
+	return true;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// copy-on-write sharing of weight rows (see share_weights_from): each row is
+// owned by a shared pointer, and a matrix copies a row before changing it
+// unless no other matrix uses it.
+
+bool generic_connection_matrix::begin_sharing_rows()
+{
+	if(NOT m_shared_rows.empty()) return true;
+	if((m_weights==NULL) OR (mp_disk_weights!=NULL) OR m_weights_in_place) return false;
+
+	int rows = m_allocated_rows_destin_layer_size;
+	m_shared_rows.resize(rows);
+	for(int r=0;r<rows;r++) m_shared_rows[r] = std::shared_ptr<DATA>(m_weights[r],free);	// (rows were allocated by malloc_2d)
+	return true;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+bool generic_connection_matrix::make_row_private(int row)
+{
+	std::shared_ptr<DATA> REF p = m_shared_rows[row];
+
+	if(p.use_count()<=1)										// no other matrix uses it (and none can start to)...
+	{
+		std::shared_ptr<DATA>(p).reset();						// ...and their reads of it are done (releasing a reference synchronizes with their releases).
+		return true;
+	}
+
+	int cols = m_allocated_cols_source_layer_size;
+	DATA PTR copy = (DATA PTR) malloc(sizeof(DATA) * cols);
+	if(copy==NULL) {error(NN_MEMORY_ERR,"No memory for row of weights"); return false;}
+	memcpy(copy, p.get(), sizeof(DATA) * cols);
+	p = std::shared_ptr<DATA>(copy,free);
+	m_weights[row] = copy;
+	return true;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// use the weights of another matrix of the same size; rows are shared until
+// changed by either matrix. Matrices stored on disk or used in place are
+// copied instead. Layers are not changed (use setup to connect them).
+
+bool generic_connection_matrix::share_weights_from(generic_connection_matrix REF source)
+{
+	if(&source==this) return true;
+	if(NOT no_error()) return false;
+
+	int rows = source.m_allocated_rows_destin_layer_size;
+	int cols = source.m_allocated_cols_source_layer_size;
+
+	if((source.m_weights==NULL) OR (rows<=0) OR (cols<=0))
+	{
+		reset_matrices();											// (source is empty)
+		return true;
+	}
+
+	if((NOT m_weights_filename.empty()) OR (NOT source.begin_sharing_rows()))
+	{
+		if(NOT allocate_matrices(rows,cols)) return false;		// copy (row by row)
+		for(int r=0;r<rows;r++)
+		{
+			row_access_hint(r,true);
+			source.row_access_hint(r,false);
+			memcpy(m_weights[r], source.m_weights[r], sizeof(DATA) * cols);
+		}
+	}
+	else
+	{
+		reset_matrices();
+		m_weights = (DATA**) malloc(sizeof(DATA *) * rows);
+		if(m_weights==NULL) {error(NN_MEMORY_ERR,"No memory for pointers to rows."); return false;}
+		m_shared_rows = source.m_shared_rows;
+		for(int r=0;r<rows;r++) m_weights[r] = m_shared_rows[r].get();
+		m_allocated_rows_destin_layer_size = rows;
+		m_allocated_cols_source_layer_size = cols;
+
+		if(m_requires_misc)
+		{
+			m_misc = allocate_rows(rows,cols,"",mp_disk_misc);
+			if(m_misc==NULL) {reset_matrices(); error(NN_MEMORY_ERR,"No memory for misc values"); return false;}
+		}
+	}
+
+	if((m_misc!=NULL) AND (source.m_misc!=NULL))
+		for(int r=0;r<rows;r++) memcpy(m_misc[r], source.m_misc[r], sizeof(DATA) * cols);
+
+	return no_error();
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+bool generic_connection_matrix::copy_weights_from(connection_set REF source)
+{
+	generic_connection_matrix PTR p_source = dynamic_cast<generic_connection_matrix PTR>(&source);
+	if(p_source==NULL) return connection_set::copy_weights_from(source);
+	return share_weights_from(ATPTR p_source);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+int generic_connection_matrix::number_of_shared_rows()
+{
+	int n = 0;
+	for(size_t r=0;r<m_shared_rows.size();r++)
+		if(m_shared_rows[r].use_count()>1) n++;
+	return n;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+bool generic_connection_matrix::sync_weights_file()
+{
+	bool ok = true;
+	if(mp_disk_weights!=NULL) ok = mp_disk_weights->sync();
+	if(mp_disk_misc!=NULL)    ok = mp_disk_misc->sync() AND ok;
+	return ok;
+}
+
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 // returns mp_destin_layer as a reference to layer (or to dummy_layer if error)
 
@@ -236,6 +506,14 @@ return 0;
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
+const DATA PTR generic_connection_matrix::in_place_weights()
+{
+	if((NOT m_weights_in_place) OR (m_weights==NULL)) return NULL;
+	return m_weights[0];
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
 DATA generic_connection_matrix::get_connection_weight(int connection)
 {
 	if((connection>=0) AND (connection<size()))
@@ -258,7 +536,9 @@ bool generic_connection_matrix::set_connection_weight(int source_pe, int destin_
 				if(source_pe>=0)
 					if(source_pe<m_allocated_cols_source_layer_size)
 					{
-						m_weights[destin_pe][source_pe] = value;
+						DATA PTR row = writable_row(destin_pe);
+						if(row==NULL) return false;
+						row[source_pe] = value;
 						return true;
 					}
 	error(NN_INTEGR_ERR,"Cannot set connection weight in matrix");
@@ -364,7 +644,7 @@ bool generic_connection_matrix::setup (string name, layer PTR source_layer, laye
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-bool generic_connection_matrix::setup (layer PTR source_layer, layer PTR destin_layer, bool PTR error_flag_to_use, bool fully_connect_layers)
+bool generic_connection_matrix::setup (layer PTR source_layer, layer PTR destin_layer, error_flag_t PTR error_flag_to_use, bool fully_connect_layers)
 {
 
 	if(!setup(source_layer,destin_layer)) return false;
@@ -375,7 +655,7 @@ bool generic_connection_matrix::setup (layer PTR source_layer, layer PTR destin_
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-bool generic_connection_matrix::setup (string name, layer PTR source_layer, layer PTR destin_layer, bool PTR error_flag_to_use, bool fully_connect_layers)
+bool generic_connection_matrix::setup (string name, layer PTR source_layer, layer PTR destin_layer, error_flag_t PTR error_flag_to_use, bool fully_connect_layers)
 {
 	m_name = name;
     return setup(source_layer, destin_layer, error_flag_to_use, fully_connect_layers);
@@ -383,7 +663,7 @@ bool generic_connection_matrix::setup (string name, layer PTR source_layer, laye
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-bool generic_connection_matrix::setup (string name, layer PTR source_layer, layer PTR destin_layer, bool PTR error_flag_to_use, bool fully_connect_layers, DATA min_random_weight, DATA max_random_weight)
+bool generic_connection_matrix::setup (string name, layer PTR source_layer, layer PTR destin_layer, error_flag_t PTR error_flag_to_use, bool fully_connect_layers, DATA min_random_weight, DATA max_random_weight)
 {
 	if (setup(name, source_layer, destin_layer, error_flag_to_use, fully_connect_layers))
 	{
@@ -410,34 +690,9 @@ bool generic_connection_matrix::fully_connect (bool group_by_source)
 	if(mp_destin_layer==NULL)		{error(NN_INTEGR_ERR,"Invalid destination layer");return false;}
 	if(mp_destin_layer->size()<=0)	{error(NN_INTEGR_ERR,"Invalid destination layer size");return false;}
 
-	reset_matrices();
-
 	// create new matrices
 
-	int source_layer_size = mp_source_layer->size();
-	int destin_layer_size = mp_destin_layer->size();
-
-	m_weights = malloc_2d(destin_layer_size,source_layer_size);
-	if(m_weights==NULL)
-	{
-		error(NN_INTEGR_ERR,"Cannot allocate memory for connections matrix");
-		return false;
-	}
-
-	if(m_requires_misc)
-	{
-		m_misc = malloc_2d(destin_layer_size,source_layer_size);
-		if(m_misc==NULL)
-		{
-			free_2d(m_weights,destin_layer_size);
-			m_weights = NULL;
-			error(NN_INTEGR_ERR,"Cannot allocate memory for connections matrix");
-			return false;
-		}
-	}
-
-	m_allocated_rows_destin_layer_size = destin_layer_size;
-	m_allocated_cols_source_layer_size = source_layer_size;
+	if(NOT allocate_matrices(mp_destin_layer->size(),mp_source_layer->size())) return false;
 
 	m_name = m_name + " (Fully Connected)";
 
@@ -465,14 +720,24 @@ void generic_connection_matrix::set_connection_weights_random(DATA min_random_va
 	if (rmin == rmax)
 	{
 		for(int r=0;r<m_allocated_rows_destin_layer_size;r++)
+		{
+			row_access_hint(r,true);
+			DATA PTR row = writable_row(r);
+			if(row==NULL) return;
 			for(int c=0;c<m_allocated_cols_source_layer_size;c++)
-				m_weights[r][c]=rmax;
+				row[c]=rmax;
+		}
 		return;
 	}
 
 	for(int r=0;r<m_allocated_rows_destin_layer_size;r++)
+	{
+		row_access_hint(r,true);
+		DATA PTR row = writable_row(r);
+		if(row==NULL) return;
 		for(int c=0;c<m_allocated_cols_source_layer_size;c++)
-			m_weights[r][c]= random(rmin, rmax);
+			row[c]= random(rmin, rmax);
+	}
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -550,80 +815,208 @@ void generic_connection_matrix::from_stream (std::istream REF s)
 		s >> comment >> comment;		// original_source_layer_id;
 		s >> comment >> comment;		// original_destin_layer_id;
 
-		// This is a patch, attempting to be similar to current Connection_Set.
-
-		dllist <connection> stored_connections;
+		if(NOT no_error()) return;
 
-		if(no_error()) stored_connections.from_stream(s);		// changed for VC7 port,was	s >> connections;
+		s >> comment;
 
-		int max_stored_source_pe_id = -1;
-		int max_stored_destin_pe_id = -1;
-
-		// read store info as usual and TRY to determine proper matrix sizes
+		if(comment=="ListSize(elements):")		// older format (list of connections, as in Connection_Set)
+		{
+			from_stream_connection_list(s);
+			return;
+		}
 
-		if(no_error())
-		for(int i=0;i<stored_connections.size();i++)
+		if(comment!="MatrixSize(rows,cols):")
 		{
-			connection a = stored_connections[i];
-			if(a.source_pe_id()>max_stored_source_pe_id) max_stored_source_pe_id=a.source_pe_id();
-			if(a.destin_pe_id()>max_stored_destin_pe_id) max_stored_destin_pe_id=a.destin_pe_id();
+			error(NN_IOFILE_ERR,"Error loading connections (unknown format)");
+			return;
 		}
 
-		int stored_source_layer_size = max_stored_source_pe_id + 1;
-		int stored_destin_layer_size = max_stored_destin_pe_id + 1;
+		int rows = 0;
+		int cols = 0;
+		s >> rows >> cols;
 
-		if((stored_source_layer_size<=0) OR (stored_destin_layer_size<=0))
-			{
+		if((NOT s.good()) OR (rows<0) OR (cols<0))
+		{
 			error(NN_IOFILE_ERR,"Error loading connections");
 			return;
-			}
-
-		// now try to allocate matrices using stored sizes (and hope for the best) <- sad I wrote this a few days before the terrible 'pame kai opou vgei' accident [or it would be if Greece was run half-decently at any point in the past 200 years; now you can call it a crime]
-
-		reset_matrices();
+		}
 
-		m_weights = malloc_2d(stored_destin_layer_size,stored_source_layer_size);
-		if(m_weights==NULL)
+		if((rows==0) OR (cols==0))				// (empty, no connections)
 		{
-			error(NN_INTEGR_ERR,"Cannot allocate memory for connections matrix");
+			reset_matrices();
 			return;
 		}
 
-		if(m_requires_misc)
+		if(NOT allocate_matrices(rows,cols)) return;
+
+		// read rows directly into matrix
+
+		for(int r=0;r<rows;r++)
 		{
-			m_misc = malloc_2d(stored_destin_layer_size,stored_source_layer_size);
-			if(m_misc==NULL)
+			row_access_hint(r,true);
+			s >> comment;						// row label
+			for(int c=0;c<cols;c++) s >> m_weights[r][c];
+			if(s.fail())
 			{
-				free_2d(m_weights,stored_destin_layer_size);
-				m_weights = NULL;
-				error(NN_INTEGR_ERR,"Cannot allocate memory for connections matrix");
+				error(NN_IOFILE_ERR,"Error loading connections (matrix row)");
 				return;
 			}
 		}
+	}
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// input older format (used before version 0.3.0), a list of connections
+// (from_stream already read the "ListSize(elements):" label) that contains
+// all matrix elements. Matrix sizes are not stored, so items are kept until
+// they are all read (in compact temporary buffers).
+
+void generic_connection_matrix::from_stream_connection_list (std::istream REF s)
+{
+	string comment;
+	int stored_items = 0;
+
+	s >> stored_items;
+	if(stored_items<=0) {error(NN_IOFILE_ERR,"Error loading connections"); return;}
 
-		m_allocated_rows_destin_layer_size = stored_destin_layer_size;
-		m_allocated_cols_source_layer_size = stored_source_layer_size;
+	std::vector<int>  stored_source_pe_ids;
+	std::vector<int>  stored_destin_pe_ids;
+	std::vector<DATA> stored_weights;
+	stored_source_pe_ids.reserve(stored_items);
+	stored_destin_pe_ids.reserve(stored_items);
+	stored_weights.reserve(stored_items);
 
-		int r=0;
-		int c=0;
-		int num_items = 0;
+	int source_pe_id, destin_pe_id;
+	DATA weight;
 
-		if(stored_connections.size()==size())
-			num_items = stored_connections.size();
+	for(int i=0;i<stored_items;i++)
+	{
+		s >> comment >> comment												// item number and "CON"
+		  >> comment >> source_pe_id
+		  >> comment >> destin_pe_id
+		  >> comment >> weight;
+		if(s.fail()) {error(NN_IOFILE_ERR,"Error loading connections"); return;}
+		stored_source_pe_ids.push_back(source_pe_id);
+		stored_destin_pe_ids.push_back(destin_pe_id);
+		stored_weights.push_back(weight);
+	}
+
+	set_from_connection_list(stored_source_pe_ids,stored_destin_pe_ids,stored_weights);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// as above, from text model reader (which already read "ListSize(elements):")
+
+void generic_connection_matrix::from_text_connection_list (text_model_reader REF r)
+{
+	int stored_items = 0;
+
+	if(NOT r.read(stored_items)) return;
+	if(stored_items<=0) {error(NN_IOFILE_ERR,"Error loading connections"); return;}
+
+	std::vector<int>  stored_source_pe_ids(stored_items);
+	std::vector<int>  stored_destin_pe_ids(stored_items);
+	std::vector<DATA> stored_weights(stored_items);
+
+	for(int i=0;i<stored_items;i++)
+		if(NOT (r.skip(3) AND r.read(stored_source_pe_ids[i]) AND			// item number, "CON", "FR:" and source PE,
+		        r.skip()  AND r.read(stored_destin_pe_ids[i]) AND			// "TO:" and destination PE,
+		        r.skip()  AND r.read(stored_weights[i])))					// "WGT:" and weight.
+			return;
+
+	set_from_connection_list(stored_source_pe_ids,stored_destin_pe_ids,stored_weights);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// create matrices (sized to fit the PE ids found) from a list of connections
+
+void generic_connection_matrix::set_from_connection_list(const std::vector<int> REF source_pe_ids, const std::vector<int> REF destin_pe_ids, const std::vector<DATA> REF weights)
+{
+	int stored_items = (int) weights.size();
 
-		for(int i=0;i<num_items;i++)
+	int max_stored_source_pe_id = -1;
+	int max_stored_destin_pe_id = -1;
+
+	for(int i=0;i<stored_items;i++)
+	{
+		if((source_pe_ids[i]<0) OR (destin_pe_ids[i]<0)) {error(NN_IOFILE_ERR,"Error loading connections"); return;}
+		if(source_pe_ids[i]>max_stored_source_pe_id) max_stored_source_pe_id=source_pe_ids[i];
+		if(destin_pe_ids[i]>max_stored_destin_pe_id) max_stored_destin_pe_id=destin_pe_ids[i];
+	}
+
+	int stored_source_layer_size = max_stored_source_pe_id + 1;
+	int stored_destin_layer_size = max_stored_destin_pe_id + 1;
+
+	if((stored_source_layer_size<=0) OR (stored_destin_layer_size<=0))
 		{
-			connection a = stored_connections[i];
-			r = a.destin_pe_id();
-			c = a.source_pe_id();
-			m_weights[r][c]=a.weight();
+		error(NN_IOFILE_ERR,"Error loading connections");
+		return;
 		}
+
+	if(NOT allocate_matrices(stored_destin_layer_size,stored_source_layer_size)) return;
+
+	if(stored_items!=size()) return;				// (as before, weights are only used if matrix was full)
+
+	for(int i=0;i<stored_items;i++)
+		m_weights[destin_pe_ids[i]][source_pe_ids[i]]=weights[i];
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// input it (from text model reader, same format as from_stream):
+
+void generic_connection_matrix::from_text (text_model_reader REF r)
+{
+	if(NOT no_error()) return;
+
+	component::from_text(r);
+
+	string label;
+	if(NOT (r.skip(4) AND r.read(label))) return;					// original source and destination layer ids (not used), format label
+
+	if(label=="ListSize(elements):")								// older format (list of connections, as in Connection_Set)
+	{
+		from_text_connection_list(r);
+		return;
+	}
+
+	if(label!="MatrixSize(rows,cols):")
+	{
+		error(NN_IOFILE_ERR,"Error loading connections (unknown format)");
+		return;
+	}
+
+	int rows = 0;
+	int cols = 0;
+	if(NOT (r.read(rows) AND r.read(cols))) return;
+
+	if((rows<0) OR (cols<0))
+	{
+		error(NN_IOFILE_ERR,"Error loading connections");
+		return;
+	}
+
+	if((rows==0) OR (cols==0))										// (empty, no connections)
+	{
+		reset_matrices();
+		return;
+	}
+
+	if(NOT allocate_matrices(rows,cols)) return;
+
+	// read rows directly into matrix
+
+	for(int row=0;row<rows;row++)
+	{
+		row_access_hint(row,true);
+		if(NOT r.skip()) return;									// row label
+		for(int c=0;c<cols;c++)
+			if(NOT r.read(m_weights[row][c])) return;
 	}
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-// output it :
-// very inefficient but somewhat compatible with Connection_Set<CONNECTION_TYPE>
+// output it : a header with matrix size, followed by matrix rows (one per
+// destination PE), written directly from the matrix.
 
 void generic_connection_matrix::to_stream (std::ostream REF s)
 {
@@ -634,19 +1027,116 @@ void generic_connection_matrix::to_stream (std::ostream REF s)
 		s << "SourceCom: " << mp_source_layer->id() << "\n";		// this is the id, not the original pointer.
 		s << "DestinCom: " << mp_destin_layer->id() << "\n";		// this is the id, not the original pointer.
 
-		dllist <connection> connections_to_store;
+		int rows = (m_weights==NULL) ? 0 : m_allocated_rows_destin_layer_size;
+		int cols = (m_weights==NULL) ? 0 : m_allocated_cols_source_layer_size;
 
-		connection temp_connection;									// there is a much simpler and efficient way to do this, but lets follow what Connection_Set does.
+		s << "MatrixSize(rows,cols): " << rows << " " << cols << "\n";
 
-		for(int r=0;r<m_allocated_rows_destin_layer_size;r++)
-			for(int c=0;c<m_allocated_cols_source_layer_size;c++)
-			{
-				temp_connection.setup(this, c, r, m_weights[r][c]);
-				connections_to_store.append(temp_connection);
-			}
+		for(int r=0;r<rows;r++)
+		{
+			row_access_hint(r,false);
+			s << "R" << r << ":";
+			for(int c=0;c<cols;c++) s << " " << m_weights[r][c];
+			s << "\n";
+		}
+	}
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// output it (binary): rows (one per destination PE) are written directly.
+
+bool generic_connection_matrix::to_binary (binary_writer REF w)
+{
+	if(NOT no_error()) return false;
+	int source_id = (mp_source_layer==NULL) ? -1 : mp_source_layer->id();
+	int destin_id = (mp_destin_layer==NULL) ? -1 : mp_destin_layer->id();
+	int rows = (m_weights==NULL) ? 0 : m_allocated_rows_destin_layer_size;
+	int cols = (m_weights==NULL) ? 0 : m_allocated_cols_source_layer_size;
+	if(NOT w.begin_component(*this,bin_connection_matrix,rows,cols,source_id,destin_id)) return false;
+	for(int r=0;r<rows;r++) w.write_data(m_weights[r],cols);
+	w.end_block();
+	return w.end_component();
+}
 
-		connections_to_store.to_stream(s);
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// output changes (binary): blocks of rows (of about NN_DIRTY_BLOCK_VALUES
+// weights) whose values changed since last call.
+
+bool generic_connection_matrix::write_changes (binary_delta_writer PTR w)
+{
+	if(NOT no_error()) return false;
+	int rows = (m_weights==NULL) ? 0 : m_allocated_rows_destin_layer_size;
+	int cols = (m_weights==NULL) ? 0 : m_allocated_cols_source_layer_size;
+	int rows_per_block = (cols>0) ? (NN_DIRTY_BLOCK_VALUES/cols) : 1;
+	if(rows_per_block<1) rows_per_block = 1;
+
+	if(w==NULL) m_dirty_rows.start(rows,rows_per_block);
+	else
+		if(NOT m_dirty_rows.is_tracking(rows,rows_per_block)) return false;
+
+	for(int b=0;b<m_dirty_rows.number_of_blocks();b++)
+	{
+		int first_row = m_dirty_rows.first_item(b);
+		int number_of_rows = m_dirty_rows.items_in_block(b);
+
+		uint64_t h = dirty_block_tracker::empty_fingerprint;
+		for(int r=first_row;r<first_row+number_of_rows;r++)
+			h = dirty_block_tracker::fingerprint(m_weights[r],cols,h);
+
+		if((w!=NULL) AND m_dirty_rows.is_dirty(b,h))
+		{
+			if(NOT w->begin_range(delta_weights,(int64_t)first_row*cols,(int64_t)number_of_rows*cols)) return false;
+			for(int r=first_row;r<first_row+number_of_rows;r++) w->write_data(m_weights[r],cols);
+			if(NOT w->end_range()) return false;
+		}
+		m_dirty_rows.set_clean(b,h);
+	}
+	return true;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// input it (binary): allocates matrices using stored sizes and copies rows.
+
+bool generic_connection_matrix::from_binary (binary_component_block REF b)
+{
+	if(NOT no_error()) return false;
+	if(b.kind()!=bin_connection_matrix) {error(NN_IOFILE_ERR,"Stored component is not a connection matrix"); return false;}
+	if(NOT component::from_binary(b)) return false;
+
+	int rows = b.rows();
+	int cols = b.cols();
+	const DATA PTR stored_weights = b.weights();
+
+	if((rows<=0) OR (cols<=0))										// (empty, no connections)
+	{
+		reset_matrices();
+		return true;
 	}
+
+	// if possible, use weights in place (only an array of pointers to rows is allocated)
+
+	DATA PTR weights_in_place = b.weights_in_place();
+	if((weights_in_place!=NULL) AND (NOT m_requires_misc) AND (m_weights_filename.empty()))
+	{
+		reset_matrices();
+		m_weights = (DATA**) malloc(sizeof(DATA *) * rows);
+		if(m_weights==NULL) {error(NN_MEMORY_ERR,"No memory for pointers to rows."); return false;}
+		for(int r=0;r<rows;r++) m_weights[r] = weights_in_place + (size_t)r * cols;
+		m_weights_in_place = true;
+		m_allocated_rows_destin_layer_size = rows;
+		m_allocated_cols_source_layer_size = cols;
+		return true;
+	}
+
+	if(NOT allocate_matrices(rows,cols)) return false;
+
+	for(int r=0;r<rows;r++)
+	{
+		row_access_hint(r,true);
+		memcpy(m_weights[r], stored_weights + (size_t)r * cols, sizeof(DATA) * cols);
+	}
+
+	return true;
 }
 
 
@@ -16,6 +16,10 @@
 #define NN_CONNECTION_MATRIX_H
 
 #include "connection_set.h"
+#include "nnlib2_memory.h"
+
+#include <vector>
+#include <memory>
 
 namespace nnlib2 {
 
@@ -34,6 +38,20 @@ private:
 	int m_allocated_cols_source_layer_size;
 
 	bool m_requires_misc;										   // misc (stored in m_misc) is an optional extra value (besides weight) stored per connection (and associated to it) for its own temporary use (not saved)
+	bool m_weights_in_place;									   // if true, m_weights rows point into a binary model file opened for in-place use (only the array of row pointers is owned)
+
+	string m_weights_filename;									   // if not empty, matrices are stored in (memory-mapped) disk files (see set_weights_file)
+	disk_matrix PTR mp_disk_weights;							   // disk file used for m_weights (NULL if in memory)
+	disk_matrix PTR mp_disk_misc;								   // disk file used for m_misc (NULL if in memory)
+
+	dirty_block_tracker m_dirty_rows;							   // blocks of weight rows changed since last write_changes
+
+	std::vector< std::shared_ptr<DATA> > m_shared_rows;			   // if not empty, owns the rows of m_weights, which may be shared (copy-on-write) with other matrices (see share_weights_from)
+
+	DATA ** allocate_rows(int rows, int cols, string filename, disk_matrix PTR REF p_disk);
+	static void release_rows(DATA ** rows, int number_of_rows, bool in_place, disk_matrix PTR p_disk);
+	bool begin_sharing_rows();									   // move ownership of rows (in memory) to m_shared_rows
+	bool make_row_private(int row);								   // copy row if it is shared
 
 protected:
 
@@ -44,6 +62,20 @@ protected:
 
 	bool sizes_are_consistent();
 	void reset_matrices();
+	bool allocate_matrices(int rows, int cols);					   // (re)allocate matrices (rows are destination PEs, columns source PEs)
+	void row_access_hint(int row, bool writing)					   // call when processing rows in order (helps if matrices are stored on disk)
+		{
+		if(mp_disk_weights!=NULL) mp_disk_weights->row_access_hint(row,writing);
+		if(mp_disk_misc!=NULL)    mp_disk_misc->row_access_hint(row,writing);
+		}
+	DATA PTR writable_row(int row)								   // call before changing weights in a row (if shared, it is copied first). NULL if failed.
+		{
+		if(m_shared_rows.empty()) return m_weights[row];
+		return make_row_private(row) ? m_weights[row] : NULL;
+		}
+	void from_stream_connection_list(std::istream REF s);		   // read older (pre 0.3.0) format...
+	void from_text_connection_list(text_model_reader REF r);	   // ...(from text model reader)...
+	void set_from_connection_list(const std::vector<int> REF source_pe_ids, const std::vector<int> REF destin_pe_ids, const std::vector<DATA> REF weights);	// ...and create matrix from it.
 
 public:
 
@@ -53,6 +85,7 @@ public:
 	~generic_connection_matrix();
 ;
 	int size ();
+	size_t memory_usage();										   // approximate bytes used (weights and misc in memory, row pointers)
 
 	layer REF source_layer();
 	layer REF destin_layer();
@@ -60,6 +93,10 @@ public:
 	bool has_destin_layer();
 	pe REF source_pe(int c);
 	pe REF destin_pe(int c);
+	bool set_weights_file(string filename);						   // store weights (and misc) in given (memory-mapped) disk file, for matrices larger than available memory; empty string to store in memory. Current values are moved.
+	bool weights_on_disk()			{ return mp_disk_weights!=NULL; }
+	bool sync_weights_file();									   // write all changes to disk file (if used)
+	const DATA PTR in_place_weights();							   // contiguous (row-major) weights if they are used in place (from binary model file), NULL otherwise
 	DATA get_connection_weight(int connection);
 	DATA get_connection_weight(int source_pe, int destin_pe);
 	bool set_connection_weight(int connection, DATA value);
@@ -68,9 +105,9 @@ public:
 	bool get_misc(DATA * buffer, int dimension);
 	bool setup (layer PTR source_layer, layer PTR destin_layer);
 	bool setup (string name, layer PTR source_layer, layer PTR destin_layer);
-	bool setup (layer PTR source_layer, layer PTR destin_layer, bool PTR error_flag_to_use, bool fully_connect_layers = false);
-	bool setup (string name, layer PTR source_layer, layer PTR destin_layer, bool PTR error_flag_to_use, bool fully_connect_layers = false);
-	bool setup (string name, layer PTR source_layer, layer PTR destin_layer, bool PTR error_flag_to_use, bool fully_connect_layers, DATA min_random_weight, DATA max_random_weight);
+	bool setup (layer PTR source_layer, layer PTR destin_layer, error_flag_t PTR error_flag_to_use, bool fully_connect_layers = false);
+	bool setup (string name, layer PTR source_layer, layer PTR destin_layer, error_flag_t PTR error_flag_to_use, bool fully_connect_layers = false);
+	bool setup (string name, layer PTR source_layer, layer PTR destin_layer, error_flag_t PTR error_flag_to_use, bool fully_connect_layers, DATA min_random_weight, DATA max_random_weight);
 	bool add_connection(const int source_pe, const int destin_pe, const DATA initial_weight);
 	bool remove_connection(int connection_number);
 	bool connection_properties( int connection,int REF source_component_id,int REF source_item,int REF destin_component_id,int REF destin_item, DATA REF weight);
@@ -78,6 +115,13 @@ public:
 	bool fully_connect (bool group_by_source = false);
 	void from_stream (std::istream REF s);
 	void to_stream (std::ostream REF s);
+	void from_text (text_model_reader REF r);					   // read matrix from text model reader (faster, same format as from_stream)
+	bool to_binary (binary_writer REF w);						   // write weights matrix (row-major) to binary model file
+	bool from_binary (binary_component_block REF b);			   // read weights matrix from block of binary model file (set must then be setup to connect layers)
+	bool write_changes (binary_delta_writer PTR w);				   // write blocks of weight rows changed since last call
+	bool share_weights_from(generic_connection_matrix REF source); // use weights of source (same size), sharing rows copy-on-write (copied if on disk or in place); misc values are copied. Not thread-safe with source's changes.
+	int  number_of_shared_rows();								   // weight rows currently shared with other matrices
+	bool copy_weights_from(connection_set REF source);			   // (virtual in connection_set) shares weights if source is a matrix (see share_weights_from)
 };
 
 } // end of namespace nnlib2
@@ -18,6 +18,7 @@
 #include "nnlib2_memory.h"
 
 #include <sstream>
+#include <typeinfo>
 
 namespace nnlib2 {
 
@@ -40,11 +41,26 @@ public:
 	virtual bool set_connection_weight(int connection, DATA value) = 0;
 	virtual bool set_misc(DATA * data, int dimension) = 0;
 	virtual bool get_misc(DATA * buffer, int dimension) = 0;							// added for nnlib2Rcpp 0.1.11
-	virtual	bool setup (layer PTR source_layer, layer PTR destin_layer, bool PTR error_flag_to_use, bool fully_connect_layers = false) = 0;
-	virtual	bool setup (string name, layer PTR source_layer, layer PTR destin_layer, bool PTR error_flag_to_use, bool fully_connect_layers = false) = 0;
-    virtual	bool setup (string name, layer PTR source_layer, layer PTR destin_layer, bool PTR error_flag_to_use, bool fully_connect_layers, DATA min_random_weight, DATA max_random_weight) = 0;
+	virtual	bool setup (layer PTR source_layer, layer PTR destin_layer, error_flag_t PTR error_flag_to_use, bool fully_connect_layers = false) = 0;
+	virtual	bool setup (string name, layer PTR source_layer, layer PTR destin_layer, error_flag_t PTR error_flag_to_use, bool fully_connect_layers = false) = 0;
+    virtual	bool setup (string name, layer PTR source_layer, layer PTR destin_layer, error_flag_t PTR error_flag_to_use, bool fully_connect_layers, DATA min_random_weight, DATA max_random_weight) = 0;
 	virtual bool add_connection(const int source_pe, const int destin_pe, const DATA initial_weight) = 0;
 	virtual bool remove_connection(int connection_number) = 0;
+
+	// optional: some sets can perform their recall and that of the next component (usually their destination layer)
+	// in a single pass (fused). If so, override these (used by nn execution plan):
+	virtual bool can_fuse_recall_with(component PTR p_next) { return false; }
+	virtual void recall_fused_with(component PTR p_next) { recall(); if(p_next!=NULL) p_next->recall(); }
+
+	// copy weights from a set with the same connections (s.a. in a cloned nn, see nn::copy_values_from).
+	// The default copies them one by one; sets may override it (to copy faster, or share them).
+	virtual bool copy_weights_from(connection_set REF source)
+		{
+		if(source.size()!=size()) return false;
+		for(int c=0;c<size();c++)
+			if(NOT set_connection_weight(c,source.get_connection_weight(c))) return false;
+		return true;
+		}
 };
 
 /*-----------------------------------------------------------------------*/
@@ -61,6 +77,8 @@ class Connection_Set : public connection_set
  layer PTR mp_source_layer;                                     // note: this is not PE_TYPE specific (layer)
  layer PTR mp_destin_layer;                                     // note: this is not PE_TYPE specific (layer)
 
+ dirty_block_tracker m_dirty_connections;                       // blocks of connections (in list order) whose weights changed since last write_changes
+
  protected:
 
  dllist <CONNECTION_TYPE> connections;                          // connections in connection_set.
@@ -69,16 +87,16 @@ class Connection_Set : public connection_set
 
  Connection_Set();
  Connection_Set(string name);
- Connection_Set(string name, bool PTR error_flag_to_use);
+ Connection_Set(string name, error_flag_t PTR error_flag_to_use);
  Connection_Set(string name, layer PTR source_layer, layer PTR destin_layer);
- Connection_Set(string name, layer PTR source_layer, layer PTR destin_layer, bool PTR error_flag_to_use,bool fully_connect_layers = false);
+ Connection_Set(string name, layer PTR source_layer, layer PTR destin_layer, error_flag_t PTR error_flag_to_use,bool fully_connect_layers = false);
  ~Connection_Set();
 
  bool setup (layer PTR source_layer, layer PTR destin_layer);
- bool setup (layer PTR source_layer, layer PTR destin_layer, bool PTR error_flag_to_use, bool fully_connect_layers = false);
+ bool setup (layer PTR source_layer, layer PTR destin_layer, error_flag_t PTR error_flag_to_use, bool fully_connect_layers = false);
  bool setup (string name, layer PTR source_layer, layer PTR destin_layer);
- bool setup (string name, layer PTR source_layer, layer PTR destin_layer, bool PTR error_flag_to_use, bool fully_connect_layers = false);
- bool setup (string name, layer PTR source_layer, layer PTR destin_layer, bool PTR error_flag_to_use, bool fully_connect_layers, DATA min_random_weight, DATA max_random_weight);
+ bool setup (string name, layer PTR source_layer, layer PTR destin_layer, error_flag_t PTR error_flag_to_use, bool fully_connect_layers = false);
+ bool setup (string name, layer PTR source_layer, layer PTR destin_layer, error_flag_t PTR error_flag_to_use, bool fully_connect_layers, DATA min_random_weight, DATA max_random_weight);
 
  bool operator == (const Connection_Set REF i);                 // only checks if the two connect the same layers...
 
@@ -100,9 +118,14 @@ class Connection_Set : public connection_set
  string description ();
  void draw ();
  int  size();						                                      // number of connections in set
+ size_t memory_usage();                                           // approximate bytes used (connections, including list nodes)
  string item_description (int item);
  void from_stream (std::istream REF s);
  void to_stream (std::ostream REF s);
+ void from_text (text_model_reader REF r);                      // read connections from text model reader (faster, same format as from_stream)
+ bool to_binary (binary_writer REF w);                          // write connections (weights, PE ids) to binary model file
+ bool from_binary (binary_component_block REF b);               // read connections from block of binary model file (set must then be setup to connect layers)
+ bool write_changes (binary_delta_writer PTR w);                // write blocks of connection weights changed since last call (PE ids must not change)
 
  pe REF source_pe(connection REF c);                            // returns pe (regardless PE_TYPE) for given connection
  pe REF source_pe(int c);                                       // returns pe (regardless PE_TYPE) for given connection number
@@ -120,6 +143,11 @@ class Connection_Set : public connection_set
 
  bool add_connection(const int source_pe, const int destin_pe, const DATA initial_weight);
  bool remove_connection(int connection_number);
+
+ bool can_fuse_recall_with(component PTR p_next);				// (virtual in connection_set) false unless specialized for CONNECTION_TYPE (see below)
+ void recall_fused_with(component PTR p_next);
+
+ bool copy_weights_from(connection_set REF source);				// (virtual in connection_set) also copies misc values; source must be of same type and connect the same PEs (connections are created if set is empty)
  };
 
 
@@ -166,7 +194,7 @@ Connection_Set<CONNECTION_TYPE>::Connection_Set(string name)
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
 template <class CONNECTION_TYPE>
-Connection_Set<CONNECTION_TYPE>::Connection_Set(string name, bool PTR error_flag_to_use)
+Connection_Set<CONNECTION_TYPE>::Connection_Set(string name, error_flag_t PTR error_flag_to_use)
  :Connection_Set<CONNECTION_TYPE>(name)
  {
  if(no_error())
@@ -194,7 +222,7 @@ Connection_Set<CONNECTION_TYPE>::Connection_Set(string name, layer PTR source_la
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
 template <class CONNECTION_TYPE>
-Connection_Set<CONNECTION_TYPE>::Connection_Set(string name, layer PTR source_layer, layer PTR destin_layer, bool PTR error_flag_to_use, bool fully_connect_layers)
+Connection_Set<CONNECTION_TYPE>::Connection_Set(string name, layer PTR source_layer, layer PTR destin_layer, error_flag_t PTR error_flag_to_use, bool fully_connect_layers)
 	{
         set_error_flag(error_flag_to_use);
 
@@ -230,7 +258,7 @@ bool Connection_Set<CONNECTION_TYPE>::setup (layer PTR source_layer, layer PTR d
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
 template <class CONNECTION_TYPE>
-bool Connection_Set<CONNECTION_TYPE>::setup (layer PTR source_layer, layer PTR destin_layer, bool PTR error_flag_to_use, bool fully_connect_layers)
+bool Connection_Set<CONNECTION_TYPE>::setup (layer PTR source_layer, layer PTR destin_layer, error_flag_t PTR error_flag_to_use, bool fully_connect_layers)
 {
 	set_error_flag(error_flag_to_use);
 	setup(source_layer,destin_layer);
@@ -250,7 +278,7 @@ bool Connection_Set<CONNECTION_TYPE>::setup (string name, layer PTR source_layer
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
 template <class CONNECTION_TYPE>
-bool Connection_Set<CONNECTION_TYPE>::setup (string name, layer PTR source_layer, layer PTR destin_layer, bool PTR error_flag_to_use, bool fully_connect_layers)
+bool Connection_Set<CONNECTION_TYPE>::setup (string name, layer PTR source_layer, layer PTR destin_layer, error_flag_t PTR error_flag_to_use, bool fully_connect_layers)
  {
  m_name = name;
  return(setup(source_layer, destin_layer, error_flag_to_use, fully_connect_layers));
@@ -260,7 +288,7 @@ bool Connection_Set<CONNECTION_TYPE>::setup (string name, layer PTR source_layer
 
 
 template <class CONNECTION_TYPE>
-bool Connection_Set<CONNECTION_TYPE>::setup(string name, layer PTR source_layer, layer PTR destin_layer, bool PTR error_flag_to_use, bool fully_connect_layers, DATA min_random_weight, DATA max_random_weight)
+bool Connection_Set<CONNECTION_TYPE>::setup(string name, layer PTR source_layer, layer PTR destin_layer, error_flag_t PTR error_flag_to_use, bool fully_connect_layers, DATA min_random_weight, DATA max_random_weight)
  {
  if (setup(name, source_layer, destin_layer, error_flag_to_use, fully_connect_layers))
     {
@@ -285,10 +313,8 @@ template <class CONNECTION_TYPE>
 void Connection_Set<CONNECTION_TYPE>::set_connection_weights (DATA value)
 {
 if(no_error())
- if(connections.goto_first())
-  do
-   connections.current().weight() = value;
-  while(connections.goto_next());
+ for(CONNECTION_TYPE REF c : connections)
+  c.weight() = value;
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -301,10 +327,8 @@ void Connection_Set<CONNECTION_TYPE>::set_connection_weights_random(DATA min_ran
     if (rmin > rmax) { warning("Invalid weight initialization"); rmin = rmax; }
     if (rmin == rmax) { set_connection_weights(rmax); return; }
     if (no_error())
-    if (connections.goto_first())
-     do
-      connections.current().weight() = random(rmin, rmax);
-     while (connections.goto_next());
+     for (CONNECTION_TYPE REF c : connections)
+      c.weight() = random(rmin, rmax);
 }
 
 
@@ -382,6 +406,15 @@ int Connection_Set<CONNECTION_TYPE>::size()
 return connections.number_of_items();
 }
 
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// approximate bytes used (connection objects, in list nodes)
+
+template <class CONNECTION_TYPE>
+size_t Connection_Set<CONNECTION_TYPE>::memory_usage()
+{
+return sizeof(Connection_Set<CONNECTION_TYPE>) - sizeof(connections) + connections.memory_usage();
+}
+
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
 template <class CONNECTION_TYPE>
@@ -468,6 +501,45 @@ return true;
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
+template <class CONNECTION_TYPE>
+bool Connection_Set<CONNECTION_TYPE>::copy_weights_from(connection_set REF source)
+{
+	if(NOT no_error()) return false;
+	Connection_Set<CONNECTION_TYPE> PTR p_source = dynamic_cast<Connection_Set<CONNECTION_TYPE> PTR>(&source);
+	if(p_source==NULL) return connection_set::copy_weights_from(source);
+	if(p_source==this) return true;
+
+	if(connections.is_empty())										// create the same connections
+		{
+		for(CONNECTION_TYPE REF s : p_source->connections)
+			{
+			if(NOT add_connection(s.source_pe_id(),s.destin_pe_id(),s.weight())) return false;
+			connections.last().misc = s.misc;
+			}
+		return no_error();
+		}
+
+	if(p_source->connections.number_of_items()!=connections.number_of_items())
+		{error(NN_INTEGR_ERR,"Connection sets differ, cannot copy weights"); return false;}
+
+	std::vector<CONNECTION_TYPE PTR> from;							// (lists are walked once, not indexed)
+	from.reserve(connections.number_of_items());
+	for(CONNECTION_TYPE REF c : p_source->connections) from.push_back(&c);
+
+	size_t i = 0;
+	for(CONNECTION_TYPE REF c : connections)
+		{
+		CONNECTION_TYPE REF s = *from[i++];
+		if((c.source_pe_id()!=s.source_pe_id()) OR (c.destin_pe_id()!=s.destin_pe_id()))
+			{error(NN_INTEGR_ERR,"Connection sets differ, cannot copy weights"); return false;}
+		c.weight() = s.weight();
+		c.misc = s.misc;
+		}
+	return true;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
 template <class CONNECTION_TYPE>
 bool Connection_Set<CONNECTION_TYPE>::remove_connection(int connection_number)
 {
@@ -503,6 +575,36 @@ void Connection_Set<CONNECTION_TYPE>::from_stream (std::istream REF s)
         }
 }
 
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// input it (from text model reader, same format as from_stream):
+
+template <class CONNECTION_TYPE>
+void Connection_Set<CONNECTION_TYPE>::from_text (text_model_reader REF r)
+{
+	if(NOT no_error()) return;
+
+	component::from_text(r);
+
+	int n = 0;
+	if(NOT (r.skip(4) AND											// original source and destination layer ids (not used)
+	        r.skip() AND r.read(n)))								// "ListSize(elements):" and number of connections
+		return;
+
+	int source_pe_id, destin_pe_id;
+	DATA weight;
+
+	connections.reset();
+	for(int i=0;(i<n) AND no_error();i++)
+	{
+		if(NOT (r.skip(3) AND r.read(source_pe_id) AND				// item number, "CON", "FR:" and source PE,
+		        r.skip()  AND r.read(destin_pe_id) AND				// "TO:" and destination PE,
+		        r.skip()  AND r.read(weight)))						// "WGT:" and weight.
+			return;
+		if(connections.append())
+			connections.last().setup(this,source_pe_id,destin_pe_id,weight);
+	}
+}
+
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 // output it :
 
@@ -519,23 +621,110 @@ void Connection_Set<CONNECTION_TYPE>::to_stream (std::ostream REF s)
         }
 }
 
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// output it (binary):
+
+template <class CONNECTION_TYPE>
+bool Connection_Set<CONNECTION_TYPE>::to_binary (binary_writer REF w)
+{
+	if(NOT no_error()) return false;
+	int source_id = (mp_source_layer==NULL) ? -1 : mp_source_layer->id();
+	int destin_id = (mp_destin_layer==NULL) ? -1 : mp_destin_layer->id();
+	if(NOT w.begin_component(*this,bin_connection_list,connections.size(),1,source_id,destin_id)) return false;
+	for(CONNECTION_TYPE REF c : connections) w.write_data(&(c.weight()),1);
+	w.end_block();
+	for(CONNECTION_TYPE REF c : connections) { int id = c.source_pe_id(); w.write_ints(&id,1); }
+	w.end_block();
+	for(CONNECTION_TYPE REF c : connections) { int id = c.destin_pe_id(); w.write_ints(&id,1); }
+	w.end_block();
+	return w.end_component();
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// input it (binary):
+
+template <class CONNECTION_TYPE>
+bool Connection_Set<CONNECTION_TYPE>::from_binary (binary_component_block REF b)
+{
+	if(NOT no_error()) return false;
+	if(b.kind()!=bin_connection_list) {error(NN_IOFILE_ERR,"Stored component is not a list of connections"); return false;}
+	if(NOT component::from_binary(b)) return false;
+
+	int n = b.rows();
+	const DATA PTR weights = b.weights();
+	const int32_t PTR source_ids = b.source_pe_ids();
+	const int32_t PTR destin_ids = b.destin_pe_ids();
+
+	connections.reset();
+	for(int i=0;(i<n) AND no_error();i++)
+		if(connections.append())
+			connections.last().setup(this,source_ids[i],destin_ids[i],weights[i]);
+
+	return no_error();
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// output changes (binary): blocks of (NN_DIRTY_BLOCK_VALUES) connections,
+// in list order, whose weights changed since last call. If connections were
+// added, removed or reconnected, changes cannot be written this way.
+
+template <class CONNECTION_TYPE>
+bool Connection_Set<CONNECTION_TYPE>::write_changes (binary_delta_writer PTR w)
+{
+	if(NOT no_error()) return false;
+	int n = connections.size();
+
+	uint64_t layout = dirty_block_tracker::empty_fingerprint;
+	for(CONNECTION_TYPE REF c : connections)
+	{
+		int ids[2] = {c.source_pe_id(), c.destin_pe_id()};
+		layout = dirty_block_tracker::fingerprint(ids,2,layout);
+	}
+
+	if(w==NULL) m_dirty_connections.start(n,NN_DIRTY_BLOCK_VALUES,layout);
+	else
+		if(NOT m_dirty_connections.is_tracking(n,NN_DIRTY_BLOCK_VALUES,layout)) return false;
+
+	DATA block_weights[NN_DIRTY_BLOCK_VALUES];
+	int i = 0;
+	for(CONNECTION_TYPE REF c : connections)
+	{
+		block_weights[i % NN_DIRTY_BLOCK_VALUES] = c.weight();
+		i++;
+		if(((i % NN_DIRTY_BLOCK_VALUES)==0) OR (i==n))						// block completed
+		{
+			int b = (i-1) / NN_DIRTY_BLOCK_VALUES;
+			int count = m_dirty_connections.items_in_block(b);
+			uint64_t h = dirty_block_tracker::fingerprint(block_weights,count);
+			if((w!=NULL) AND m_dirty_connections.is_dirty(b,h))
+			{
+				if(NOT w->begin_range(delta_weights,m_dirty_connections.first_item(b),count)) return false;
+				w->write_data(block_weights,count);
+				if(NOT w->end_range()) return false;
+			}
+			m_dirty_connections.set_clean(b,h);
+		}
+	}
+	return true;
+}
+
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 // may be overridden by derived classes.
 
 template <class CONNECTION_TYPE>
 void Connection_Set<CONNECTION_TYPE>::encode()
 {
-if(connections.goto_first())
-do connections.current().encode();
-while(connections.goto_next());
+NN_COUNT(cnt_connections_visited,connections.size());
+for(CONNECTION_TYPE REF c : connections)
+ c.encode();
 }
 
 template <class CONNECTION_TYPE>
 void Connection_Set<CONNECTION_TYPE>::recall()
 {
-if(connections.goto_first())
-do connections.current().recall();
-while(connections.goto_next());
+NN_COUNT(cnt_connections_visited,connections.size());
+for(CONNECTION_TYPE REF c : connections)
+ c.recall();
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -619,12 +808,10 @@ bool Connection_Set<CONNECTION_TYPE>::get_misc(DATA * buffer, int dimension)
 	if (dimension NEQL size())
 	{ warning ("Incompatible vector dimension (number of connections vs vector length)");
 		return false; }
-	if(NOT connections.goto_first()) return false;
-	for (int i = 0; i < dimension; i++)
-		{
-		buffer[i] = connections.current().misc;                    // get data from respective connection misc
-		if(NOT connections.goto_next()) i=dimension;
-		}
+	if(connections.is_empty()) return false;
+	int i = 0;
+	for (const CONNECTION_TYPE REF c : connections)
+		buffer[i++] = c.misc;                    				// get data from respective connection misc
 	return true;
 }
 
@@ -639,15 +826,102 @@ bool Connection_Set<CONNECTION_TYPE>::set_misc(DATA * data, int dimension)
 	if (dimension NEQL size())
 	{ warning ("Incompatible vector dimension (number of connections vs vector length)");
 		return false; }
-	if(NOT connections.goto_first()) return false;
-	for (int i = 0; i < dimension; i++)
-	{
-		connections.current().misc = data[i];                    // sets data to respective connection misc
-		if(NOT connections.goto_next()) i=dimension;
-	}
+	if(connections.is_empty()) return false;
+	int i = 0;
+	for (CONNECTION_TYPE REF c : connections)
+		c.misc = data[i++];                    					// sets data to respective connection misc
 	return true;
 }
 
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// by default, recall is not fused (specializations for particular connection types follow)
+
+template <class CONNECTION_TYPE>
+bool Connection_Set<CONNECTION_TYPE>::can_fuse_recall_with(component PTR p_next)
+{
+	return false;
+}
+
+template <class CONNECTION_TYPE>
+void Connection_Set<CONNECTION_TYPE>::recall_fused_with(component PTR p_next)
+{
+	recall();
+	if(p_next!=NULL) p_next->recall();
+}
+
+//-------------------------------------------------------------------------
+// pass-through connections followed by their destination pass_through_layer:
+// values are summed directly to destination pe inputs (instead of being
+// queued in each pe's received_values list and then summed by the layer).
+
+template <>
+inline bool Connection_Set<pass_through_connection>::can_fuse_recall_with(component PTR p_next)
+{
+	if(p_next==NULL) return false;
+	if(typeid(*p_next)!=typeid(pass_through_layer)) return false;		// only exact type, derived classes may do something else
+	return (has_destin_layer() AND (mp_destin_layer==p_next));
+}
+
+template <>
+inline void Connection_Set<pass_through_connection>::recall_fused_with(component PTR p_next)
+{
+	if(NOT can_fuse_recall_with(p_next)) { recall(); if(p_next!=NULL) p_next->recall(); return; }
+	if(NOT no_error()) return;
+
+	pass_through_layer REF destin = *(reinterpret_cast<pass_through_layer PTR>(p_next));
+	layer REF source = source_layer();
+	pe PTR p_destin_pes = destin.PEs();
+	int destin_size = destin.size();
+
+	for(int i=0;i<destin_size;i++) p_destin_pes[i].input_function();	// sum any values already received (also resets received values)
+
+	NN_COUNT(cnt_connections_visited,connections.size());
+	for(pass_through_connection REF c : connections)
+		p_destin_pes[c.destin_pe_id()].input += source.PE(c.source_pe_id()).output;
+
+	for(int i=0;i<destin_size;i++)
+		{
+		p_destin_pes[i].output = p_destin_pes[i].input;
+		p_destin_pes[i].input  = 0;
+		}
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// same as above, for weighted pass-through connections
+
+template <>
+inline bool Connection_Set<weighted_pass_through_connection>::can_fuse_recall_with(component PTR p_next)
+{
+	if(p_next==NULL) return false;
+	if(typeid(*p_next)!=typeid(pass_through_layer)) return false;
+	return (has_destin_layer() AND (mp_destin_layer==p_next));
+}
+
+template <>
+inline void Connection_Set<weighted_pass_through_connection>::recall_fused_with(component PTR p_next)
+{
+	if(NOT can_fuse_recall_with(p_next)) { recall(); if(p_next!=NULL) p_next->recall(); return; }
+	if(NOT no_error()) return;
+
+	pass_through_layer REF destin = *(reinterpret_cast<pass_through_layer PTR>(p_next));
+	layer REF source = source_layer();
+	pe PTR p_destin_pes = destin.PEs();
+	int destin_size = destin.size();
+
+	for(int i=0;i<destin_size;i++) p_destin_pes[i].input_function();
+
+	NN_COUNT(cnt_connections_visited,connections.size());
+	NN_COUNT(cnt_multiply_adds,connections.size());
+	for(weighted_pass_through_connection REF c : connections)
+		p_destin_pes[c.destin_pe_id()].input += c.weight() * source.PE(c.source_pe_id()).output;
+
+	for(int i=0;i<destin_size;i++)
+		{
+		p_destin_pes[i].output = p_destin_pes[i].input;
+		p_destin_pes[i].input  = 0;
+		}
+}
+
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
 } // end of namespace nnlib2
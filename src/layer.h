@@ -15,6 +15,8 @@
 #include "pe.h"
 #include "nnlib2_vector.h"
 #include "nnlib2_misc.h"
+#include "nnlib2_binary.h"
+#include "nnlib2_text_reader.h"
 
 namespace nnlib2 {
 
@@ -54,6 +56,10 @@ public:
 template <class PE_TYPE>
 class Layer : public layer
 {
+private:
+
+	dirty_block_tracker m_dirty_pes;											// (all PEs as one block) biases or misc values changed since last write_changes
+
 protected:
 
 	vector <PE_TYPE> pes;                                                       // Processing Elements in layer.
@@ -64,18 +70,24 @@ public:
 
 	Layer();
 	Layer(string name, int size);
-	Layer(string name, int size, bool PTR error_flag_to_use);
+	Layer(string name, int size, error_flag_t PTR error_flag_to_use);
 	~Layer();
 	void reset();
 	bool setup(string name, int size);
-	bool setup(string name, int size, bool PTR error_flag_to_use);
+	bool setup(string name, int size, error_flag_t PTR error_flag_to_use);
 	void draw();
 	int size();
+	size_t memory_usage();													// approximate bytes used (PEs, and values queued in their received_values lists)
 	pe REF PE(int pe);
+	PE_TYPE PTR PEs() { return pes.data(); }								// direct access to the (contiguous) array of PEs, for fast processing code
 	void randomize_biases (DATA min_random_value,DATA max_random_value);
 	string item_description(int item);
 	void from_stream (std::istream REF s);                                 // read layer from stream
 	void to_stream (std::ostream REF s);                                   // write layer to stream
+	void from_text (text_model_reader REF r);                              // read layer from text model reader (faster, same format as from_stream)
+	bool to_binary (binary_writer REF w);                                  // write layer (PE biases and misc values) to binary model file
+	bool from_binary (binary_component_block REF b);                       // read layer from block of binary model file
+	bool write_changes (binary_delta_writer PTR w);                        // write PE biases and misc values, if changed since last call
 
 	bool input_data_from_vector(DATA * data, int dimension);               // overrides virtual method in data_receiver, sets values to pe inputs
 	bool output_data_to_vector(DATA * buffer, int dimension);              // overrides virtual method in data_provider, gets values from pe outputs
@@ -122,7 +134,7 @@ Layer<PE_TYPE>::Layer(string name, int size)
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
 template <class PE_TYPE>
-Layer<PE_TYPE>::Layer(string name, int size, bool PTR error_flag_to_use)
+Layer<PE_TYPE>::Layer(string name, int size, error_flag_t PTR error_flag_to_use)
 {
 	m_type = cmpnt_layer;
 	setup(name, size, error_flag_to_use);
@@ -165,7 +177,7 @@ bool Layer<PE_TYPE>::setup(string name, int size)
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
 template <class PE_TYPE>
-bool Layer<PE_TYPE>::setup(string name, int size, bool PTR error_flag_to_use)
+bool Layer<PE_TYPE>::setup(string name, int size, error_flag_t PTR error_flag_to_use)
 {
 	set_error_flag(error_flag_to_use);
 	return setup(name,size);
@@ -189,6 +201,18 @@ int Layer<PE_TYPE>::size()
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
+template <class PE_TYPE>
+size_t Layer<PE_TYPE>::memory_usage()
+{
+	size_t bytes = sizeof(Layer<PE_TYPE>) - sizeof(pes) + pes.memory_usage();
+	PE_TYPE PTR p = pes.data();
+	for(int i=0;i<pes.number_of_items();i++)
+		bytes += p[i].received_values_memory();
+	return bytes;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
 template <class PE_TYPE>
 pe REF Layer<PE_TYPE>::PE(int pe)
 {
@@ -225,6 +249,28 @@ void Layer<PE_TYPE>::from_stream(std::istream REF s)
 	}
 }
 
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// input it (from text model reader, same format as from_stream):
+
+template <class PE_TYPE>
+void Layer<PE_TYPE>::from_text(text_model_reader REF r)
+{
+	if (NOT no_error()) return;
+
+	component::from_text(r);
+
+	int n = 0;
+	if (NOT (r.skip() AND r.read(n))) return;						// "VectSize(elements):" and number of PEs
+
+	pes.reset();
+	if (n > 0)
+		if (pes.setup(n))
+			for (int i = 0; (i < n) AND no_error(); i++)
+				if (NOT (r.skip(3) AND r.read(pes[i].bias) AND		// item number, "PE", "B:" and bias,
+				         r.skip() AND r.read(pes[i].misc)))			// "M:" and misc value.
+					return;
+}
+
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 // output it :
 
@@ -238,6 +284,82 @@ void Layer<PE_TYPE>::to_stream(std::ostream REF s)
 	}
 }
 
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// output it (binary):
+
+template <class PE_TYPE>
+bool Layer<PE_TYPE>::to_binary(binary_writer REF w)
+{
+	if (NOT no_error()) return false;
+	int n = size();
+	if (NOT w.begin_component(*this, bin_layer, n, 1)) return false;
+	for (int i = 0; i < n; i++) w.write_data(&(pes[i].bias), 1);
+	w.end_block();
+	for (int i = 0; i < n; i++) w.write_data(&(pes[i].misc), 1);
+	w.end_block();
+	return w.end_component();
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// output changes (binary):
+
+template <class PE_TYPE>
+bool Layer<PE_TYPE>::write_changes(binary_delta_writer PTR w)
+{
+	if (NOT no_error()) return false;
+	int n = size();
+	int block_size = (n > 0) ? n : 1;
+
+	if (w == NULL) m_dirty_pes.start(n, block_size);
+	else
+		if (NOT m_dirty_pes.is_tracking(n, block_size)) return false;
+	if (n <= 0) return true;
+
+	uint64_t h = dirty_block_tracker::empty_fingerprint;
+	for (int i = 0; i < n; i++)
+	{
+		h = dirty_block_tracker::fingerprint(&(pes[i].bias), 1, h);
+		h = dirty_block_tracker::fingerprint(&(pes[i].misc), 1, h);
+	}
+
+	if ((w != NULL) AND m_dirty_pes.is_dirty(0, h))
+	{
+		if (NOT w->begin_range(delta_biases, 0, n)) return false;
+		for (int i = 0; i < n; i++) w->write_data(&(pes[i].bias), 1);
+		if (NOT w->end_range()) return false;
+		if (NOT w->begin_range(delta_misc, 0, n)) return false;
+		for (int i = 0; i < n; i++) w->write_data(&(pes[i].misc), 1);
+		if (NOT w->end_range()) return false;
+	}
+	m_dirty_pes.set_clean(0, h);
+	return true;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// input it (binary):
+
+template <class PE_TYPE>
+bool Layer<PE_TYPE>::from_binary(binary_component_block REF b)
+{
+	if (NOT no_error()) return false;
+	if (b.kind() != bin_layer) { error(NN_IOFILE_ERR, "Stored component is not a layer"); return false; }
+	if (NOT component::from_binary(b)) return false;
+
+	int n = b.rows();
+	const DATA PTR biases = b.biases();
+	const DATA PTR misc = b.misc();
+
+	pes.reset();
+	if (n > 0)
+		if (pes.setup(n))
+			for (int i = 0; i < n; i++)
+			{
+				pes[i].bias = biases[i];
+				pes[i].misc = misc[i];
+			}
+	return no_error();
+}
+
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 // overrides virtual method in data_receiver, sets values to pe inputs
 // (sets this input to respective pe input and to received_values,
@@ -18,7 +18,7 @@ protected:
 
 public:
 	Layer2D(string name, int dim1, int dim2);
-	Layer2D(string name, int dim1, int dim2, bool PTR error_flag_to_use);
+	Layer2D(string name, int dim1, int dim2, error_flag_t PTR error_flag_to_use);
 	pe REF PE(int c1, int c2) { return PE(coords2PEid(c1,c2)); }
 	int dim1() { return m_dim1; };
 	int dim2() { return m_dim2; };
@@ -37,7 +37,7 @@ Layer2D<PE_TYPE>::Layer2D(string name, int dim1, int dim2)
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
 template <class PE_TYPE>
-Layer2D<PE_TYPE>::Layer2D(string name, int dim1, int dim2, bool PTR error_flag_to_use)
+Layer2D<PE_TYPE>::Layer2D(string name, int dim1, int dim2, error_flag_t PTR error_flag_to_use)
 	:Layer<PE_TYPE>(name,dim1*dim2,error_flag_to_use)
 {
 m_dim1 = dim1;
@@ -9,6 +9,7 @@
 
 #include <stdarg.h>
 #include <sstream>
+#include <fstream>
 
 namespace nnlib2 {
 
@@ -19,12 +20,18 @@ namespace nnlib2 {
 nn::nn(string name)
   :component(name,cmpnt_nn)
  {
+ m_recall_fusion_enabled = true;
+ m_plan_topology_stamp = -1;
+ mp_in_place_model_file = NULL;
  reset();
  }
 
 nn::nn()
   :component("Neural Network",cmpnt_nn)
  {
+ m_recall_fusion_enabled = true;
+ m_plan_topology_stamp = -1;
+ mp_in_place_model_file = NULL;
  reset();
  }
 
@@ -78,8 +85,17 @@ void nn::reset(bool clear_additional_parameters)
 
  topology.check();
 
+ if(mp_in_place_model_file!=NULL)		// no components use it now.
+  {
+  delete mp_in_place_model_file;
+  mp_in_place_model_file = NULL;
+  }
+
  m_topology_component_for_input = -1;
  m_topology_component_for_output = -1;
+
+ m_profiler.reset();
+ invalidate_plan();
  }
 
 
@@ -139,17 +155,17 @@ void nn::recall()
 {
 if(NOT is_ready()) return;
 
+if(NOT ensure_plan()) return;
+
+int n = (int) m_plan.size();
+
 if(m_topology_component_for_input<=m_topology_component_for_output)
  {
- if(topology.goto_first())
-  do { topology.current()->recall(); }
-  while(topology.goto_next());
+ recall_plan_forward();
  }
 else
  {
- if(topology.goto_last())
-  do { topology.current()->recall(); }
-  while(topology.goto_previous());
+ for(int i=n-1;i>=0;i--) recall_step(i);
  }
 }
 
@@ -161,17 +177,17 @@ void nn::encode()
 {
 if(NOT is_ready()) return;
 
+if(NOT ensure_plan()) return;
+
+int n = (int) m_plan.size();
+
 if(m_topology_component_for_input<=m_topology_component_for_output)
   {
-  if(topology.goto_first())
-  do { topology.current()->encode(); }
-  while(topology.goto_next());
+  for(int i=0;i<n;i++) encode_step(i);
   }
 else
   {
-  if(topology.goto_last())
-  do { topology.current()->encode(); }
-  while(topology.goto_previous());
+  for(int i=n-1;i>=0;i--) encode_step(i);
   }
 }
 
@@ -184,8 +200,11 @@ int nn::input_dimension()
  if(m_topology_component_for_input<0) return 0;
  if(topology.is_empty()) return 0;
  if(topology.size()<=m_topology_component_for_input)return 0;
+ nn_plan_step PTR p_step = plan_step_at(m_topology_component_for_input);
+ if(p_step==NULL) return 0;
+ if(p_step->p_layer!=NULL) return p_step->p_layer->size();			// (current size, layer may have been set up again)
  if(!component_accepts_input(m_topology_component_for_input)) return 0;
- return topology[m_topology_component_for_input]->size();
+ return p_step->p_component->size();
  // remaining code is old version's, not used:
  if(topology[m_topology_component_for_input]->type()==cmpnt_layer)
  {
@@ -204,8 +223,11 @@ int nn::output_dimension()
  if(m_topology_component_for_output<0) return 0;
  if(topology.is_empty()) return 0;
  if(topology.size()<=m_topology_component_for_output)return 0;
+ nn_plan_step PTR p_step = plan_step_at(m_topology_component_for_output);
+ if(p_step==NULL) return 0;
+ if(p_step->p_layer!=NULL) return p_step->p_layer->size();			// (current size, layer may have been set up again)
  if(!component_provides_output(m_topology_component_for_output)) return 0;
- return topology[m_topology_component_for_output]->size();
+ return p_step->p_component->size();
  // remaining code is old version's, not used:
  if(topology[m_topology_component_for_output]->type()==cmpnt_layer)
  {
@@ -229,7 +251,8 @@ bool nn::input_data_from_vector(DATA * data, int dimension)
  if(m_topology_component_for_input<0)
   if(NOT set_component_for_input(0))
     return false;
- data_receiver * pl = dynamic_cast <data_receiver *> (topology[m_topology_component_for_input]);
+ nn_plan_step PTR p_step = plan_step_at(m_topology_component_for_input);
+data_receiver * pl = (p_step==NULL) ? NULL : p_step->p_receiver;
  if (pl==NULL) {error(NN_INTEGR_ERR,"Requested component cannot accept data");return false;}
  return(pl->input_data_from_vector(data,dimension));
  }
@@ -248,7 +271,8 @@ if (NOT is_ready()) return false;
 if(m_topology_component_for_input<0)
   if(NOT set_component_for_input(0))
     return false;
-data_receiver * pl = dynamic_cast <data_receiver *> (topology[m_topology_component_for_input]);
+nn_plan_step PTR p_step = plan_step_at(m_topology_component_for_input);
+data_receiver * pl = (p_step==NULL) ? NULL : p_step->p_receiver;
 if (pl==NULL) {error(NN_INTEGR_ERR,"Requested component cannot accept data");return false;}
 return pl->send_input_to(index,d);
 }
@@ -266,7 +290,8 @@ bool nn::output_data_to_vector(DATA * buffer, int dimension)
  if(m_topology_component_for_output<0)
   if(NOT set_component_for_output(topology.size()-1))
    return false;
- data_provider * pl = dynamic_cast <data_provider *> (topology[m_topology_component_for_output]);
+ nn_plan_step PTR p_step = plan_step_at(m_topology_component_for_output);
+data_provider * pl = (p_step==NULL) ? NULL : p_step->p_provider;
  if (pl==NULL) {error(NN_INTEGR_ERR,"Requested component does not output data");return false;}
  return(pl->output_data_to_vector(buffer,dimension));
 }
@@ -286,7 +311,8 @@ DATA nn::get_output_from (int index)
  if(m_topology_component_for_output<0)
   if(NOT set_component_for_output(topology.size()-1))
    return false;
- data_provider * pl = dynamic_cast <data_provider *> (topology[m_topology_component_for_output]);
+ nn_plan_step PTR p_step = plan_step_at(m_topology_component_for_output);
+data_provider * pl = (p_step==NULL) ? NULL : p_step->p_provider;
  if (pl==NULL) {error(NN_INTEGR_ERR,"Requested component does not output data");return false;}
  return pl->get_output_from(index);
 }
@@ -356,6 +382,137 @@ int nn::size()
  return topology.number_of_items();
  }
 
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// approximate bytes used by nn (topology and plan) and its components
+
+size_t nn::memory_usage()
+ {
+ size_t bytes = sizeof(nn) + (topology.memory_usage() - sizeof(dllist<component PTR>)) + m_plan.capacity() * sizeof(nn_plan_step);
+ for(component PTR p_component : topology)
+  if(p_component!=NULL) bytes += p_component->memory_usage();
+ return bytes;
+ }
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// freeze current topology into a flat, indexed execution plan (so that
+// processing and index-based access do not walk the topology list).
+
+bool nn::compile_plan()
+ {
+ if(m_plan_topology_stamp NEQL topology.modifications())
+  m_profiler.reset();									// (profile is by topology index, which may have changed)
+
+ m_plan.clear();
+ m_plan_is_compiled = false;
+
+ if(NOT no_error()) return false;
+
+ m_plan.reserve(topology.size());
+
+ for(component PTR p_component : topology)
+  {
+  nn_plan_step step;
+  step.p_component		= p_component;
+  step.p_layer			= NULL;
+  step.p_connection_set	= NULL;
+  step.p_aux_control	= NULL;
+  step.p_receiver		= NULL;
+  step.p_provider		= NULL;
+  step.fuse_recall_with_next = false;
+
+  if(p_component==NULL) {error(NN_NULLPT_ERR,"Invalid component in topology"); m_plan.clear(); return false;}
+
+  switch(p_component->type())
+   {
+   case cmpnt_layer:
+     step.p_layer = reinterpret_cast<layer PTR>(p_component);
+     break;
+   case cmpnt_connection_set:
+     step.p_connection_set = reinterpret_cast<connection_set PTR>(p_component);
+     break;
+   case cmpnt_aux_control:
+     step.p_aux_control = reinterpret_cast<aux_control PTR>(p_component);
+     break;
+   default:
+     break;
+   }
+
+  step.p_receiver = dynamic_cast<data_receiver PTR>(p_component);
+  step.p_provider = dynamic_cast<data_provider PTR>(p_component);
+
+  m_plan.push_back(step);
+  }
+
+ // second pass: find connection set + layer pairs that can be recalled by fused code
+ // (the set decides, unknown or custom components are processed as usual).
+
+ if(m_recall_fusion_enabled)
+  for(int i=0;i+1<(int)m_plan.size();i++)
+   if(m_plan[i].p_connection_set!=NULL)
+    if(m_plan[i].p_connection_set->can_fuse_recall_with(m_plan[i+1].p_component))
+     {
+     m_plan[i].fuse_recall_with_next = true;
+     i++;                                        // next step is consumed by fused step
+     }
+
+ m_plan_topology_stamp = topology.modifications();
+ m_plan_is_compiled = true;
+ return true;
+ }
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+void nn::invalidate_plan()
+ {
+ m_plan_is_compiled = false;
+ }
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+void nn::set_recall_fusion(bool enable)
+ {
+ if(enable==m_recall_fusion_enabled) return;
+ m_recall_fusion_enabled = enable;
+ invalidate_plan();
+ }
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// recall all components, 1st to last, following the plan (assumed compiled).
+
+void nn::recall_plan_forward()
+ {
+ int n = (int) m_plan.size();
+ for(int i=0;i<n;i++)
+  {
+  nn_plan_step REF step = m_plan[i];
+  if(step.fuse_recall_with_next AND (i+1<n))
+   {
+   if(m_profiler.enabled() OR event_tracer.enabled())	// (time is recorded for the set, the fused layer only counts the call)
+    {
+    profile_scope timed(m_profiler,i,false,step.p_component->size());
+    trace_scope traced("recall",step.p_component->name().c_str(),"index",i);
+    if(m_profiler.enabled()) m_profiler.add(i+1,false,0,m_plan[i+1].p_component->size());
+    step.p_connection_set->recall_fused_with(m_plan[i+1].p_component);
+    }
+   else
+    step.p_connection_set->recall_fused_with(m_plan[i+1].p_component);
+   i++;
+   }
+  else
+   recall_step(i);
+  }
+ }
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// returns step for "index"-th component in topology, NULL if not available
+
+nn_plan_step PTR nn::plan_step_at(int index)
+ {
+ if(NOT ensure_plan()) return NULL;
+ if((index<0) OR (index>=(int)m_plan.size())) return NULL;
+ return &(m_plan[index]);
+ }
+
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
 string nn::item_description (int item)
@@ -403,6 +560,29 @@ void nn::from_stream ( std::istream REF s )
   }
  }
 
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// input it (from text model reader, same format as from_stream above).
+// Reader errors are reported to this nn.
+
+void nn::from_text ( text_model_reader REF r )
+ {
+ reset_error();
+ r.set_error_flag(my_error_flag());
+ component::from_text(r);
+ if(no_error())
+  {
+  int i_dim = 0;
+  int o_dim = 0;
+
+  if(NOT (r.skip() AND r.read(i_dim) AND r.skip() AND r.read(o_dim))) return;
+
+  if ((i_dim>0) OR (o_dim>0))
+   if ((input_dimension()>0) OR (output_dimension()>0))							// to avoid complaints when loading into an empty NN
+    if ((i_dim NEQL input_dimension()) OR (o_dim NEQL output_dimension()))
+      warning("Current neural net used different input-output dimensions from stored ones.");
+  }
+ }
+
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 // output it :
 
@@ -424,12 +604,196 @@ void nn::to_stream   ( std::ostream REF s )
 
   s << "NumCompon: " << topology.number_of_items() << "\n";
 
-  if(topology.goto_first())
+  for(component PTR p_component : topology)
+   p_component->to_stream(s);
+  }
+ }
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// output it (binary):
+
+bool nn::to_binary ( binary_writer REF w )
+ {
+ if(NOT m_nn_is_ready) warning("Neural net is not initialized!");
+ if(NOT no_error()) return false;
+
+ if(NOT w.begin_file(m_name,m_id,auxiliary_parameter(),topology.size(),input_dimension(),output_dimension())) return false;
+
+ for(component PTR p_component : topology)
+  if(NOT p_component->to_binary(w)) return false;
+
+ return no_error();
+ }
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// output changes (binary, see nnlib2_binary.h): ranges are identified by
+// the position of components in topology.
+
+bool nn::write_changes ( binary_delta_writer PTR w )
+ {
+ if(NOT no_error()) return false;
+
+ int index = 0;
+ for(component PTR p_component : topology)
+  {
+  if(w!=NULL) w->set_component(index);
+  if(NOT p_component->write_changes(w)) return false;
+  index++;
+  }
+
+ return no_error();
+ }
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// input it (binary) : This is generic, loads components into existing
+// topology (component types must match). Child-classes can override it
+// to first create the needed topology (see bp_nn or kohonen_nn).
+
+bool nn::from_binary_file ( binary_model_file REF f )
+ {
+ if(NOT no_error()) return false;
+ if(NOT f.is_open()) {error(NN_IOFILE_ERR,"No binary file to read"); return false;}
+
+ if(f.number_of_components()!=size())
+  {
+  error(NN_IOFILE_ERR,"Stored neural net has different number of components than current topology");
+  return false;
+  }
+
+ for(int i=0;(i<f.number_of_components()) AND no_error();i++)
+  {
+  component PTR p_component = component_from_topology_index(i);
+  if(p_component==NULL) return false;
+  if(NOT p_component->from_binary(f.component_block(i))) return false;
+  }
+
+ m_name = f.name();
+ invalidate_plan();
+
+ if ((input_dimension()>0) OR (output_dimension()>0))							// (not yet known if topology was just created)
+  if ((f.input_dimension() NEQL input_dimension()) OR (f.output_dimension() NEQL output_dimension()))
+   warning("Current neural net used different input-output dimensions from stored ones.");
+
+ return no_error();
+ }
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+bool nn::save_binary ( string filename )
+ {
+ std::ofstream outfile(filename.c_str(), std::ios::binary);
+ if(NOT outfile) {error(NN_IOFILE_ERR,"File cannot be opened"); return false;}
+ binary_writer w(outfile);
+ w.set_error_flag(my_error_flag());
+ bool ok = to_binary(w);
+ outfile.close();
+ return ok AND no_error();
+ }
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+bool nn::load_binary ( string filename )
+ {
+ reset_error();
+ binary_model_file f;
+ f.set_error_flag(my_error_flag());
+ if(NOT f.open(filename)) return false;
+ return from_binary_file(f);
+ }
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// load NN from binary model file, which is kept open (memory-mapped, copy-
+// on-write) so that components can use its data in place. Pages are shared
+// by all processes that load the same file, unless changed by a process (in
+// which case they are privately copied, s.a. when the NN is trained).
+
+bool nn::load_binary_in_place ( string filename )
+ {
+ reset_error();
+ binary_model_file PTR p_file = new binary_model_file;
+ p_file->set_error_flag(my_error_flag());
+
+ if(p_file->open(filename,true))
+  if(from_binary_file(*p_file))
    {
-   do topology.current()->to_stream(s);
-   while (topology.goto_next());
+   if(mp_in_place_model_file!=NULL) delete mp_in_place_model_file;	// (previous file is no longer used by components)
+   mp_in_place_model_file = p_file;
+   return true;
    }
+
+ if(p_file->is_open())				// some components may be using its data...
+  {
+  reset(false);						// ...so remove them.
+  error(NN_IOFILE_ERR,"Loading failed, neural net was reset");
   }
+ delete p_file;
+ return false;
+ }
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// copy values from a NN with the same structure (same number and types of
+// components in topology, layers of same sizes, connections between the
+// same PEs), s.a. a newly created skeleton of it. Used for cloning NNs,
+// faster than a stream or file; aux_control components are not copied.
+
+bool nn::copy_values_from ( nn REF source )
+ {
+ if(&source==this) return true;
+ if(NOT no_error()) return false;
+
+ if(source.size()!=size())
+  {
+  error(NN_INTEGR_ERR,"Neural nets have different number of components, cannot copy values");
+  return false;
+  }
+
+ for(int i=0;(i<size()) AND no_error();i++)
+  {
+  component PTR p_from = source.component_from_topology_index(i);
+  component PTR p_to   = component_from_topology_index(i);
+  if((p_from==NULL) OR (p_to==NULL)) return false;
+  if(typeid(ATPTR p_from)!=typeid(ATPTR p_to))
+   {
+   error(NN_INTEGR_ERR,"Neural nets have different components, cannot copy values");
+   return false;
+   }
+
+  layer PTR p_layer_from = dynamic_cast<layer PTR>(p_from);
+  layer PTR p_layer_to   = dynamic_cast<layer PTR>(p_to);
+  if((p_layer_from!=NULL) AND (p_layer_to!=NULL))
+   {
+   if(p_layer_from->size()!=p_layer_to->size())
+    {
+    error(NN_INTEGR_ERR,"Layers have different sizes, cannot copy values");
+    return false;
+    }
+   for(int p=0;p<p_layer_to->size();p++)
+    {
+    pe REF from = p_layer_from->PE(p);
+    pe REF to   = p_layer_to->PE(p);
+    to.reset_received_values();
+    to.input  = from.input;
+    to.bias   = from.bias;
+    to.output = from.output;
+    to.misc   = from.misc;
+    }
+   continue;
+   }
+
+  connection_set PTR p_set_from = dynamic_cast<connection_set PTR>(p_from);
+  connection_set PTR p_set_to   = dynamic_cast<connection_set PTR>(p_to);
+  if((p_set_from!=NULL) AND (p_set_to!=NULL))
+   if(NOT p_set_to->copy_weights_from(ATPTR p_set_from))
+    {
+    error(NN_INTEGR_ERR,"Connection sets differ, cannot copy weights");
+    return false;
+    }
+  }
+
+ m_topology_component_for_input  = source.m_topology_component_for_input;
+ m_topology_component_for_output = source.m_topology_component_for_output;
+ invalidate_plan();
+ return no_error();
  }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -440,11 +804,11 @@ string nn::outline (bool show_first_index_as_one)
  std::stringstream s;
  s << description() << "\n";
 
- if(topology.goto_first())
+ if(NOT topology.is_empty())
  {
    int c=0;
    s << "Current NN topology:\n";
-   do
+   for(component PTR p_component : topology)
     {
     if(show_first_index_as_one)
      {
@@ -454,12 +818,13 @@ string nn::outline (bool show_first_index_as_one)
      {
      s << "@ " << c;
      }
-    s << " component (id=" << topology.current()->id() << ")";
-    s << " is " << topology.current()->description();
-    s << " of size " <<  topology.current()->size() << "\n";
+    s << " component (id=" << p_component->id() << ")";
+    s << " is " << p_component->description();
+    s << " of size " <<  p_component->size();
+    s << " (" << p_component->memory_usage() << " bytes)\n";
     c++;
     }
-     while (topology.goto_next());
+   s << "Approximate memory used: " << memory_usage() << " bytes\n";
  }
  return s.str();
  }
@@ -509,9 +874,9 @@ bool nn::add_aux_control(aux_control * p_aux_control)
 
 bool nn::call_component_encode(int index)
   {
-  if(index<0) return false;
-  if(index>=topology.size()) return false;
-  topology[index]->encode();
+  nn_plan_step PTR p_step = plan_step_at(index);
+  if(p_step==NULL) return false;
+  encode_step(index);
   return true;
   }
 
@@ -520,9 +885,9 @@ bool nn::call_component_encode(int index)
 
 bool nn::call_component_recall(int index)
   {
-  if(index<0) return false;
-  if(index>=topology.size()) return false;
-  topology[index]->recall();
+  nn_plan_step PTR p_step = plan_step_at(index);
+  if(p_step==NULL) return false;
+  recall_step(index);
   return true;
   }
 
@@ -532,21 +897,14 @@ bool nn::call_component_recall(int index)
 
 bool nn::call_component_encode_all(bool fwd)
 {
+if(topology.is_empty()) return false;
+if(NOT ensure_plan()) return false;
+int n = (int) m_plan.size();
 if(fwd)
-  if(topology.goto_first())
-  {
-  do topology.current()->encode();
-  while (topology.goto_next());
-  return true;
-  }
-if(NOT fwd)
-  if(topology.goto_last())
-  {
-  do topology.current()->encode();
-  while (topology.goto_previous());
-  return true;
-  }
-return false;
+  for(int i=0;i<n;i++) encode_step(i);
+else
+  for(int i=n-1;i>=0;i--) encode_step(i);
+return true;
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -555,21 +913,14 @@ return false;
 
 bool nn::call_component_recall_all(bool fwd)
 {
-  if(fwd)
-    if(topology.goto_first())
-    {
-    do topology.current()->recall();
-    while (topology.goto_next());
-    return true;
-    }
-  if(NOT fwd)
-    if(topology.goto_last())
-    {
-    do topology.current()->recall();
-    while (topology.goto_previous());
-    return true;
-    }
-return false;
+if(topology.is_empty()) return false;
+if(NOT ensure_plan()) return false;
+int n = (int) m_plan.size();
+if(fwd)
+  recall_plan_forward();
+else
+  for(int i=n-1;i>=0;i--) recall_step(i);
+return true;
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -577,12 +928,8 @@ return false;
 
 component * nn::component_from_id(int id)
 {
-	for(int i=0;i<topology.size();i++)
-	{
-		component * cp = topology[i];
-		if(no_error())
-			if(cp->id()==id) return cp;
-	}
+	for(component * cp : topology)
+		if(cp->id()==id) return cp;
 	return NULL;
 }
 
@@ -591,7 +938,9 @@ component * nn::component_from_id(int id)
 
 component * nn::component_from_topology_index(int index)
 {
-  component * cp = topology[index];
+  nn_plan_step PTR p_step = plan_step_at(index);
+  if(p_step!=NULL) return p_step->p_component;
+  component * cp = topology[index];					// (invalid index, this reports the error)
   if(no_error()) return cp;
   return NULL;
 }
@@ -601,11 +950,11 @@ component * nn::component_from_topology_index(int index)
 
 bool nn::component_accepts_input(int index)
 {
-	component * cp = component_from_topology_index(index);
-	if(cp==NULL) return false;
-	if(cp->type()==cmpnt_layer) return true;
-	if(cp->type()==cmpnt_aux_control) return true;
-	if(dynamic_cast<data_receiver *>(cp)!=NULL) return true;
+	nn_plan_step PTR p_step = plan_step_at(index);
+	if(p_step==NULL) return false;
+	if(p_step->p_layer!=NULL) return true;
+	if(p_step->p_aux_control!=NULL) return true;
+	if(p_step->p_receiver!=NULL) return true;
 	return false;
 }
 
@@ -614,11 +963,11 @@ bool nn::component_accepts_input(int index)
 
 bool nn::component_provides_output(int index)
 {
-	component * cp = component_from_topology_index(index);
-	if(cp==NULL) return false;
-	if(cp->type()==cmpnt_layer) return true;
-	if(cp->type()==cmpnt_aux_control) return true;
-	if(dynamic_cast<data_provider *>(cp)!=NULL) return true;
+	nn_plan_step PTR p_step = plan_step_at(index);
+	if(p_step==NULL) return false;
+	if(p_step->p_layer!=NULL) return true;
+	if(p_step->p_aux_control!=NULL) return true;
+	if(p_step->p_provider!=NULL) return true;
 	return false;
 }
 
@@ -627,11 +976,11 @@ bool nn::component_provides_output(int index)
 
 int nn::component_topology_index_from_id(int id)
 {
-	for(int i=0;i<topology.size();i++)
+	int i = 0;
+	for(component * cp : topology)
 	{
-		component * cp = topology[i];
-		if(no_error())
-			if(cp->id()==id) return i;
+		if(cp->id()==id) return i;
+		i++;
 	}
 	return -1;
 }
@@ -641,15 +990,11 @@ int nn::component_topology_index_from_id(int id)
 
 int nn::component_id_from_topology_index(int index)
 {
-  if(topology.goto_first())
+  int i = 0;
+  for(component PTR p_component : topology)
   {
-    int i = 0;
-    do
-    {
-      if(index==i) return topology.current()->id();
-      i++;
-    }
-    while (topology.goto_next());
+    if(index==i) return p_component->id();
+    i++;
   }
   warning("No component with requested id is found in topology");
   return -1;
@@ -710,12 +1055,13 @@ if(NOT topology.goto_first())   {error(NN_INTEGR_ERR,"nn topology is empty"); re
 // scan topology to find layers...
 
 dllist<int> layer_indexes_in_topology;
-for(int index=0;index<topology.size();index++)
+int index=0;
+for(component PTR p_component : topology)
   {
-  p_c1 = topology[index];
-  if(p_c1!=NULL)
-   if(p_c1->type()==cmpnt_layer)
+  if(p_component!=NULL)
+   if(p_component->type()==cmpnt_layer)
      layer_indexes_in_topology.append(index);
+  index++;
   }
 if(layer_indexes_in_topology.size()<2) {error(NN_INTEGR_ERR,"not enough layers (<2) in topology"); return false;}
 
@@ -757,6 +1103,7 @@ for(int i=0;i<layer_indexes_in_topology.size()-1;i++)
      {
      pconx->setup(pconx->name(),play1,play2,my_error_flag(),fully_connect,min_random_weight,max_random_weight);
      pair_connected = true;
+     invalidate_plan();                  // set is now attached, may allow more fused steps
      }
     }
   }
@@ -830,6 +1177,8 @@ bool nn::connect_layers_at_topology_indexes(                                // c
   layer PTR p_l1 = reinterpret_cast<layer PTR>(p_c1);
   layer PTR p_l2 = reinterpret_cast<layer PTR>(p_c2);
 
+  invalidate_plan();
+
   return p_connection_set->setup(p_connection_set->name(),
                                  p_l1,
                                  p_l2,
@@ -852,18 +1201,9 @@ int nn::number_of_components_in_topology()
 
 layer PTR nn::get_layer_at(int index)
 {
-  if(index<0) return NULL;
-  if(index>=topology.size()) return NULL;
-  if(topology.is_empty()) return NULL;
-
-  component PTR p_comp = topology[index];
-  if(p_comp==NULL) return NULL;
-
-  if(p_comp->type()!=cmpnt_layer) return NULL;
-  // component found and seems to be a layer
-
-  layer PTR p_la = reinterpret_cast<layer PTR>(p_comp);
-  return p_la;
+  nn_plan_step PTR p_step = plan_step_at(index);
+  if(p_step==NULL) return NULL;
+  return p_step->p_layer;
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -871,18 +1211,9 @@ layer PTR nn::get_layer_at(int index)
 
 connection_set PTR nn::get_connection_set_at(int index)
 {
-  if(index<0) return NULL;
-  if(index>=topology.size()) return NULL;
-  if(topology.is_empty()) return NULL;
-
-  component PTR p_comp = topology[index];
-  if(p_comp==NULL) return NULL;
-
-  if(p_comp->type()!=cmpnt_connection_set) return NULL;
-  // component found and seems to be a connection_set
-
-  connection_set PTR p_cs = reinterpret_cast<connection_set PTR>(p_comp);
-  return p_cs;
+  nn_plan_step PTR p_step = plan_step_at(index);
+  if(p_step==NULL) return NULL;
+  return p_step->p_connection_set;
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -890,18 +1221,9 @@ connection_set PTR nn::get_connection_set_at(int index)
 
 aux_control PTR nn::get_aux_control_at(int index)
 {
-	if(index<0) return NULL;
-	if(index>=topology.size()) return NULL;
-	if(topology.is_empty()) return NULL;
-
-	component PTR p_comp = topology[index];
-	if(p_comp==NULL) return NULL;
-
-	if(p_comp->type()!=cmpnt_aux_control) return NULL;
-	// component found and seems to be a aux_control
-
-	aux_control PTR p_ax = reinterpret_cast<aux_control PTR>(p_comp);
-	return p_ax;
+	nn_plan_step PTR p_step = plan_step_at(index);
+	if(p_step==NULL) return NULL;
+	return p_step->p_aux_control;
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -938,7 +1260,7 @@ bool nn::get_input_at_component (int index, DATA * buffer, int dimension)
   if(index>=topology.size()) return false;
   if(topology.is_empty()) return false;
 
-  component PTR p_comp = topology[index];
+  component PTR p_comp = component_from_topology_index(index);
   if(p_comp==NULL) return false;
 
   int num_items = p_comp->size();
@@ -975,7 +1297,7 @@ bool nn::set_input_at_component (int index, DATA * data, int dimension)
 	if(index>=topology.size()) return false;
 	if(topology.is_empty()) return false;
 	if(!component_accepts_input(index)) return false;
-	data_receiver * pc = dynamic_cast <data_receiver *> (topology[index]);
+	data_receiver * pc = plan_step_at(index)->p_receiver;
 	if (pc==NULL) {error(NN_INTEGR_ERR,"Requested component cannot accept data");return false;}
 	return(pc->input_data_from_vector(data,dimension));
 }
@@ -991,7 +1313,7 @@ bool nn::get_weights_at_component (int index, DATA * buffer, int dimension)
   if(index>=topology.size()) return false;
   if(topology.is_empty()) return false;
 
-  component PTR p_comp = topology[index];
+  component PTR p_comp = component_from_topology_index(index);
   if(p_comp==NULL) return false;
   if(p_comp->type()!=cmpnt_connection_set) return false;
 
@@ -1084,7 +1406,7 @@ bool nn::get_output_from_component (int index, DATA * buffer, int dimension)
 	if(index>=topology.size()) return false;
 	if(topology.is_empty()) return false;
 	if(!component_accepts_input(index)) return false;
-	data_provider * pc = dynamic_cast <data_provider *> (topology[index]);
+	data_provider * pc = plan_step_at(index)->p_provider;
 	if (pc==NULL) {error(NN_INTEGR_ERR,"Requested component cannot provide data");return false;}
 	return(pc->output_data_to_vector(buffer,dimension));
 }
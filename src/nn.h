@@ -18,6 +18,10 @@
 #include "connection_set.h"
 #include "connection_matrix.h"
 #include "aux_control.h"
+#include "nnlib2_profiler.h"
+#include "nnlib2_trace.h"
+
+#include <vector>
 
 #ifdef NNLIB2_FOR_MFC_UI
 #include "..\nnlib2.mfcgui\nnlib2_mfc_ui.h"
@@ -25,6 +29,21 @@
 
 namespace nnlib2 {
 
+/*-----------------------------------------------------------------------*/
+/* a step in a nn execution plan (see below)						 	 */
+/*-----------------------------------------------------------------------*/
+
+struct nn_plan_step
+ {
+ component		PTR p_component;
+ layer			PTR p_layer;							// NULL if component is not a layer
+ connection_set	PTR p_connection_set;					// NULL if component is not a connection set
+ aux_control	PTR p_aux_control;						// NULL if component is not an aux_control
+ data_receiver	PTR p_receiver;							// NULL if component does not accept input
+ data_provider	PTR p_provider;							// NULL if component does not provide output
+ bool			fuse_recall_with_next;					// true if this (connection set) and next step can be recalled by a single fused call (forward recall only)
+ };
+
 /*-----------------------------------------------------------------------*/
 /* Artificial Neural Network (ans)					 */
 /*-----------------------------------------------------------------------*/
@@ -35,6 +54,31 @@ class nn : public component, public data_receiver, public data_provider, public
 
  bool m_nn_is_ready;							// indicates that setup - or load - has been performed and nn is ready for encode/decode...
 
+ std::vector<nn_plan_step> m_plan;				// execution plan, a flat (indexed) copy of topology with resolved component pointers...
+ int  m_plan_topology_stamp;					// ...compiled when topology had this number of modifications...
+ bool m_plan_is_compiled;						// ...(if false, plan must be compiled before use).
+ bool m_recall_fusion_enabled;					// if true, known connection set + layer pairs are recalled by fused code (see connection_set::recall_fused_with).
+
+ binary_model_file PTR mp_in_place_model_file;	// binary model file whose data is used in place by components (see load_binary_in_place), NULL if none. Deleted when topology is reset.
+
+ nn_profiler m_profiler;						// per-component timing (opt-in, see nnlib2_profiler.h)
+
+ void encode_step(int i)						// encode component at plan step (topology index) i, timed if profiling or tracing.
+  {
+  if(NOT (m_profiler.enabled() OR event_tracer.enabled())) { m_plan[i].p_component->encode(); return; }
+  profile_scope timed(m_profiler,i,true,m_plan[i].p_component->size());
+  trace_scope traced("encode",m_plan[i].p_component->name().c_str(),"index",i);
+  m_plan[i].p_component->encode();
+  }
+
+ void recall_step(int i)						// recall component at plan step (topology index) i, timed if profiling or tracing.
+  {
+  if(NOT (m_profiler.enabled() OR event_tracer.enabled())) { m_plan[i].p_component->recall(); return; }
+  profile_scope timed(m_profiler,i,false,m_plan[i].p_component->size());
+  trace_scope traced("recall",m_plan[i].p_component->name().c_str(),"index",i);
+  m_plan[i].p_component->recall();
+  }
+
  protected:
 
  pointer_dllist <component PTR>	topology;		                // ordered list of pointers to major nn components; indicates FeedForward/FeedBackWard processing order; added items (components) are displayed/serialised, and also are deleted in nn's destructor () (when nn is deleted).
@@ -46,6 +90,11 @@ class nn : public component, public data_receiver, public data_provider, public
 
  void set_is_ready_flag() { m_nn_is_ready = true; }
 
+ bool plan_is_current()  { return m_plan_is_compiled AND (m_plan_topology_stamp EQL topology.modifications()); }
+ bool ensure_plan()      { return plan_is_current() OR compile_plan(); }
+ nn_plan_step PTR plan_step_at(int index);                              // NULL if index is not valid. Compiles plan if needed.
+ void recall_plan_forward();                                            // recall all components 1st to last, using fused steps where available.
+
  public:
 
  nn();
@@ -80,6 +129,14 @@ class nn : public component, public data_receiver, public data_provider, public
  int output_length()    { return output_dimension(); }
 
  int size();								// returns number of components in topology
+ size_t memory_usage();					// approximate bytes used by NN and all components in topology
+
+ bool compile_plan();                                                   // freeze current topology into execution plan (done automatically when topology list is changed)
+ void invalidate_plan();                                                // call if components in topology are changed in ways the plan can not detect (s.a. re-setup of layers)
+ void set_recall_fusion(bool enable);                                   // enable (default) or disable fused recall of known connection set + layer pairs
+ bool recall_fusion()   { return m_recall_fusion_enabled; }
+
+ nn_profiler REF profiler() { return m_profiler; }                     // per-component timing of encode/recall (enable with profiler().enable(true))
 
  bool is_ready()        { return (no_error() && m_nn_is_ready); }
  virtual string description ();
@@ -87,6 +144,16 @@ class nn : public component, public data_receiver, public data_provider, public
  string item_description (int item);
  void from_stream ( std::istream REF s );			        			// overrides virtual method in component, only reads header
  void to_stream   ( std::ostream REF s );			        			// overrides virtual method in component
+ void from_text   ( text_model_reader REF r );                          // overrides virtual method in component, only reads header (as from_stream)
+
+ bool to_binary ( binary_writer REF w );                                // overrides virtual method in component, writes entire NN (header and all components in topology)
+ bool write_changes ( binary_delta_writer PTR w );                      // overrides virtual method in component, writes values changed in all components in topology
+ virtual bool from_binary_file ( binary_model_file REF f );             // reads components into current topology (which must have the same structure). Override to create topology.
+ bool save_binary ( string filename );                                  // save NN to binary model file
+ bool load_binary ( string filename );                                  // load NN from binary model file (memory-mapped, if possible)
+ bool load_binary_in_place ( string filename );                         // as above, but components (connection matrices) keep using the (memory-mapped, copy-on-write) file data instead of copying it, so processes using the same file share it. Intended for inference.
+ bool uses_in_place_model_file() { return mp_in_place_model_file!=NULL; }
+ bool copy_values_from ( nn REF source );                              // copy PE values and weights from a NN with the same structure (s.a. to clone it); weights in matrices are shared copy-on-write (see generic_connection_matrix::share_weights_from)
 
  bool set_component_for_input(int index);                               // set which component in the topology is used for input (by index position in topology)
  bool set_component_for_input_by_id(int id);                            // set which component in the topology is used for input (by component id)
@@ -13,6 +13,7 @@
 
 #include <cmath>
 #include <sstream>
+#include <typeinfo>
 
 #include "nn_bp.h"
 
@@ -90,6 +91,7 @@ void bp_comput_layer::encode()
 
 void bp_comput_layer::recall()
   {
+  NN_COUNT(cnt_exp_evaluations,size());
   if(no_error())
   for(int i=0;i<size();i++)
    {
@@ -137,10 +139,12 @@ void bp_connection_set::encode()
   layer REF source = source_layer();
   layer REF destin = destin_layer();
 
-  if(no_error() AND (connections.goto_first()))
-  do
+  NN_COUNT(cnt_connections_visited,connections.size());
+  NN_COUNT(cnt_multiply_adds,2*connections.size());			// (error back-propagated, weight adjusted)
+
+  if(no_error())
+  for(connection REF c : connections)
    {
-   connection REF c = connections.current();
    pe REF source_pe = source.PE(c.source_pe_id());
    pe REF destin_pe = destin.PE(c.destin_pe_id());
 
@@ -152,7 +156,6 @@ void bp_connection_set::encode()
 
    c.weight() += (m_learning_rate * b * d);					// adjust weight (SIMPSON 5-164/6)
    }
-  while(connections.goto_next());
   }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -163,10 +166,12 @@ void bp_connection_set::recall()
   layer REF source = source_layer();
   layer REF destin = destin_layer();
 
-  if(no_error() AND (connections.goto_first()))
-  do
+  NN_COUNT(cnt_connections_visited,connections.size());
+  NN_COUNT(cnt_multiply_adds,connections.size());
+
+  if(no_error())
+  for(connection REF c : connections)
    {
-   connection REF c = (connections.current());
 
    source_pe = c.source_pe_id();
    destin_pe = c.destin_pe_id();
@@ -176,7 +181,6 @@ void bp_connection_set::recall()
 
    destin.PE(destin_pe).add_to_input(x);
    }
-  while(connections.goto_next());
   }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -200,25 +204,31 @@ void bp_connection_matrix::encode()
 	layer REF source = source_layer();
 	layer REF destin = destin_layer();
 
-	for(int source_pe_id = 0; source_pe_id<source_layer().size();source_pe_id++)
+	int source_size = source.size();
+	int destin_size = destin.size();
+
+	NN_COUNT(cnt_connections_visited,(int64_t)source_size*destin_size);
+	NN_COUNT(cnt_multiply_adds,(int64_t)2*source_size*destin_size);	// (error back-propagated, weight adjusted)
+
+	// processed row by row (as matrix is stored); each source pe still receives
+	// its values in the same order (by destination pe), so results do not change.
+
+	for(int destin_pe_id = 0; destin_pe_id<destin_size;destin_pe_id++)
 	{
-		pe REF source_pe = source.PE(source_pe_id);
-		DATA b = source_pe.output;
+		row_access_hint(destin_pe_id,true);
+		DATA d = destin.PE(destin_pe_id).misc;							// get discrepancy at destination pe...
+		DATA PTR weights = writable_row(destin_pe_id);					// (copied first if shared with a clone)
+		if(weights==NULL) return;
 
-		for(int destin_pe_id = 0; destin_pe_id<destin_layer().size();destin_pe_id++)
+		for(int source_pe_id = 0; source_pe_id<source_size;source_pe_id++)
 		{
-			pe REF destin_pe = destin.PE(destin_pe_id);
-			DATA d = destin_pe.misc;									// get discrepancy at destination pe...
-		 // DATA w = get_connection_weight(source_pe_id,destin_pe_id);  // get connection weight...safer version
-			DATA w = m_weights[destin_pe_id][source_pe_id];				// get connection weight...faster version
+			pe REF source_pe = source.PE(source_pe_id);
+			DATA w = weights[source_pe_id];								// get connection weight...
 			DATA x = w * d;												// and multiply the two values...
 			source_pe.add_to_input(x);									// feeding it back to the previous layer.
 
-		 // set_connection_weight(source_pe_id,destin_pe_id,			// adjust weight (SIMPSON 5-164/6)
-		 //     w + (m_learning_rate * b * d));							// safer version
-
-			m_weights[destin_pe_id][source_pe_id] = 					// adjust weight (SIMPSON 5-164/6)
-				w + (m_learning_rate * b * d);							// faster version
+			weights[source_pe_id] = 									// adjust weight (SIMPSON 5-164/6)
+				w + (m_learning_rate * source_pe.output * d);
 		}
 	}
 }
@@ -232,15 +242,19 @@ void bp_connection_matrix::recall()
 	layer REF source = source_layer();
 	layer REF destin = destin_layer();
 
-	for(int source_pe = 0; source_pe<source_layer().size();source_pe++)
+	int source_size = source.size();
+	int destin_size = destin.size();
+
+	NN_COUNT(cnt_connections_visited,(int64_t)source_size*destin_size);
+	NN_COUNT(cnt_multiply_adds,(int64_t)source_size*destin_size);
+
+	for(int destin_pe=0;destin_pe<destin_size;destin_pe++)				// (row by row, as matrix is stored)
         {
-        	DATA x0 = source.PE(source_pe).output;
-        	for(int destin_pe=0;destin_pe<destin_layer().size();destin_pe++)
-        	{
-        	//  DATA x1 = x0 * get_connection_weight(source_pe,destin_pe);   // safer version
-        		DATA x1 = x0 * m_weights[destin_pe][source_pe];				 // faster version
-        		destin.PE(destin_pe).add_to_input(x1);
-        	}
+        	row_access_hint(destin_pe,false);
+        	pe REF p = destin.PE(destin_pe);
+        	DATA PTR weights = m_weights[destin_pe];
+        	for(int source_pe = 0; source_pe<source_size;source_pe++)
+        		p.add_to_input(source.PE(source_pe).output * weights[source_pe]);
         }
 }
 
@@ -251,6 +265,65 @@ void bp_connection_matrix::set_learning_rate(DATA lrate)
 	m_learning_rate=lrate;
 }
 
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// Fused recall: performs this recall() and the destination layer's recall()
+// in one pass over the destination PEs. Only done if the destination is exactly
+// a bp_comput_layer or bp_output_layer (derived classes may recall differently).
+// Summation order is the same as in the separate steps, so results are identical.
+
+bool bp_connection_matrix::can_fuse_recall_with(component PTR p_next)
+{
+	if(p_next==NULL) return false;
+	if((typeid(*p_next)!=typeid(bp_comput_layer)) AND
+	   (typeid(*p_next)!=typeid(bp_output_layer))) return false;
+	if(NOT has_destin_layer()) return false;
+	return (&destin_layer() == p_next);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+void bp_connection_matrix::recall_fused_with(component PTR p_next)
+{
+	if((NOT can_fuse_recall_with(p_next)) OR
+	   (NOT has_source_layer()))
+		{
+		recall();
+		if(p_next!=NULL) p_next->recall();
+		return;
+		}
+
+	if(NOT no_error()) return;
+	if(NOT sizes_are_consistent()) return;
+
+	layer REF source = source_layer();
+	bp_comput_layer REF destin = *(reinterpret_cast<bp_comput_layer PTR>(p_next));
+
+	int source_size = source.size();
+	int destin_size = destin.size();
+
+	m_source_outputs.resize(source_size);						// no reallocation once sized
+	DATA PTR x = m_source_outputs.data();
+	for(int s=0;s<source_size;s++) x[s]=source.PE(s).output;
+
+	pe PTR p_destin_pes = destin.PEs();
+
+	NN_COUNT(cnt_connections_visited,(int64_t)source_size*destin_size);
+	NN_COUNT(cnt_multiply_adds,(int64_t)source_size*destin_size);
+	NN_COUNT(cnt_exp_evaluations,destin_size);
+
+	for(int d=0;d<destin_size;d++)
+		{
+		row_access_hint(d,false);
+		pe REF p = p_destin_pes[d];
+		DATA PTR w = m_weights[d];
+		DATA a = p.input;
+		for(int s=0;s<source_size;s++) a = a + x[s] * w[s];	// weighted sum,
+		a = a + p.bias;											// add bias,
+		p.output=(DATA)1/(1+exp(-a));							// and apply logistic sigmoid (as in bp_comput_layer::recall).
+		p.input=0;
+		}
+}
+
 /*-----------------------------------------------------------------------*/
 /* Back Propagation Perceptron (bp_nn)									 */
 /*-----------------------------------------------------------------------*/
@@ -262,6 +335,8 @@ bp_nn::bp_nn()
  {
  set_initialization_mode_to_default();
  m_use_squared_error = bp_nn::display_squared_error;
+ m_frozen_is_valid = false;
+ m_frozen_topology_stamp = 0;
  }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -317,6 +392,7 @@ bool bp_nn::setup(int input_dimension, int output_dimension)
 
  int cparam;
 
+ unfreeze();
  reset(false);
 
  if(no_error())
@@ -350,6 +426,7 @@ bool bp_nn::setup(int input_dimension, int output_dimension)
    new_connection_set = new BP_CONNECTIONS;
    new_connection_set->set_error_flag(my_error_flag());
    topology.append(new_connection_set);
+   assign_weights_file(new_connection_set,topology.size()-1);			// (used if weights are stored on disk)
 
   // create hidden layer(s)...
 
@@ -378,6 +455,7 @@ bool bp_nn::setup(int input_dimension, int output_dimension)
   new_connection_set = new BP_CONNECTIONS;
   new_connection_set->set_error_flag(my_error_flag());
   topology.append(new_connection_set);
+  assign_weights_file(new_connection_set,topology.size()-1);			// (used if weights are stored on disk)
 
   destin_layer = new bp_output_layer ();
   destin_layer->set_error_flag(my_error_flag());
@@ -412,6 +490,8 @@ DATA bp_nn::encode_s(	DATA PTR input,
  {
  DATA error_level = DATA_MAX;
 
+ unfreeze();													// weights will change
+
  if(is_ready())
   {
   recall(input,input_dim);
@@ -438,34 +518,41 @@ DATA bp_nn::encode_s(	DATA PTR input,
   if(no_error())
    {
    if(OUTPUT_LAYER.input_data_from_vector(desired_output,output_dim))
-   if(topology.goto_last())									// start from output layer and...
-   do
-    topology.current()->encode();							// ...encode while...
-   while(topology.goto_previous());							// ...propagating backwards.
+   call_component_encode_all(false);						// start from output layer and encode while propagating backwards.
    }
   }
  return error_level;										// Note: error level is calculated before last 'encode' cycle.
  }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-// input it :
+// input it : the (remaining) stream is read in memory and parsed by a
+// text_model_reader (much faster than extracting each item from stream).
+
+void bp_nn::from_stream ( std::istream REF s )
+ {
+ text_model_reader r;
+ r.set_error_flag(my_error_flag());
+ if(r.load_stream(s)) from_text(r);
+ r.return_unused_to(s);
+ }
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// input it (from text model reader):
 // This assumes that the sequence of topology is:
 // input_layer->connection_list->hidden_layer->connection_list->...->output_layer
 
-void bp_nn::from_stream ( std::istream REF s )
+void bp_nn::from_text ( text_model_reader REF r )
  {
  int i, number_of_components, hidden_layers;
- string comment;
  bp_layer * source_layer, * destin_layer;
  BP_CONNECTIONS * new_connection_set;
 
- nn::from_stream(s);	                                    // read header (the way it was done in older versions)
+ unfreeze();
+ nn::from_text(r);	                                    // read header (the way it was done in older versions)
 
  if(no_error())
   {
-  if(s.rdstate()) {error(NN_IOFILE_ERR,"Error reading stream (BP)");return;}
-
-  s >> comment >> number_of_components ;
+  if(NOT (r.skip() AND r.read(number_of_components))) return;
 
   if(number_of_components<3) {error(NN_IOFILE_ERR,"No BP topology to load");return;}
 
@@ -476,7 +563,7 @@ void bp_nn::from_stream ( std::istream REF s )
   source_layer = new bp_input_layer;
   source_layer->set_error_flag(my_error_flag());
   topology.append(source_layer);
-  source_layer->from_stream(s);								// load input layer
+  source_layer->from_text(r);								// load input layer
 
   for(i=0;(i<hidden_layers)AND no_error();i++)
    {
@@ -485,14 +572,15 @@ void bp_nn::from_stream ( std::istream REF s )
    new_connection_set = new BP_CONNECTIONS;
    new_connection_set->set_error_flag(my_error_flag());
    topology.append(new_connection_set);
-   new_connection_set->from_stream(s);						// load connection set
+   assign_weights_file(new_connection_set,topology.size()-1);			// (used if weights are stored on disk)
+   new_connection_set->from_text(r);						// load connection set
 
   // create hidden layer(s)...
 
    destin_layer = new bp_comput_layer;
    destin_layer->set_error_flag(my_error_flag());
    topology.append(destin_layer);
-   destin_layer->from_stream(s);							// load hidden layer
+   destin_layer->from_text(r);							// load hidden layer
 
   // fixup connection set (fix pointers ...)
 
@@ -505,12 +593,13 @@ void bp_nn::from_stream ( std::istream REF s )
   new_connection_set = new BP_CONNECTIONS;
   new_connection_set->set_error_flag(my_error_flag());
   topology.append(new_connection_set);
-  new_connection_set->from_stream(s);						// load connection set
+  assign_weights_file(new_connection_set,topology.size()-1);			// (used if weights are stored on disk)
+  new_connection_set->from_text(r);						// load connection set
 
   destin_layer = new bp_output_layer;
   destin_layer->set_error_flag(my_error_flag());
   topology.append(destin_layer);
-  destin_layer->from_stream(s);								// load output layer
+  destin_layer->from_text(r);								// load output layer
 
   // fixup connection set (fix pointers ...)
 
@@ -525,6 +614,440 @@ void bp_nn::from_stream ( std::istream REF s )
   }
  }
 
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// input it (binary): creates topology (similar to from_stream above) and
+// then loads components from file.
+
+bool bp_nn::from_binary_file ( binary_model_file REF f )
+ {
+ bp_layer * p_layer;
+ BP_CONNECTIONS * p_connection_set;
+
+ unfreeze();
+ reset(false);
+
+ int number_of_components = f.number_of_components();
+ if((number_of_components<3) OR ((number_of_components%2)==0)) {error(NN_IOFILE_ERR,"No BP topology to load");return false;}
+
+ p_layer = new bp_input_layer;
+ p_layer->set_error_flag(my_error_flag());
+ topology.append(p_layer);
+
+ for(int i=1;i<number_of_components;i+=2)
+  {
+  p_connection_set = new BP_CONNECTIONS;
+  p_connection_set->set_error_flag(my_error_flag());
+  topology.append(p_connection_set);
+  assign_weights_file(p_connection_set,topology.size()-1);			// (used if weights are stored on disk)
+
+  if(i+2<number_of_components) p_layer = new bp_comput_layer;
+  else                         p_layer = new bp_output_layer;
+  p_layer->set_error_flag(my_error_flag());
+  topology.append(p_layer);
+  }
+
+ if(NOT nn::from_binary_file(f)) return false;
+
+ // fixup connection sets (fix pointers ...)
+
+ for(int i=1;i<number_of_components;i+=2)
+  get_connection_set_at(i)->setup(get_layer_at(i-1),get_layer_at(i+1),my_error_flag());
+
+ if(no_error())
+  {
+  set_component_for_input(0);								// the first in topology
+  set_component_for_output(topology.size()-1);				// the last in topology
+  set_is_ready_flag();
+  }
+ return no_error();
+ }
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// copy weights and biases to flat (contiguous) arrays, for recall_frozen()
+// and snapshots. This assumes that the sequence of topology is:
+// input_layer->connection_matrix->comput_layer->...->connection_matrix->output_layer
+// Weights used in place (see nn::load_binary_in_place) are copied only if
+// copy_in_place_weights is true.
+
+bool bp_nn::flatten(std::vector<int> REF layer_sizes,
+                    std::vector<DATA> REF weights,
+                    std::vector<const DATA PTR> REF weight_blocks,
+                    std::vector<DATA> REF biases,
+                    bool copy_in_place_weights)
+ {
+ layer_sizes.clear();
+ weights.clear();
+ weight_blocks.clear();
+ biases.clear();
+
+ if(NOT is_ready()) return false;
+ if(typeid(*this)!=typeid(bp_nn)) return false;				// derived (bpu) variations recall differently.
+ if(NOT ensure_plan()) return false;
+
+ int n = size();
+ if((n<3) OR ((n%2)==0)) return false;
+ if(m_topology_component_for_input!=0) return false;
+ if(m_topology_component_for_output!=n-1) return false;
+
+ for(int i=0;i<n;i+=2)										// layers...
+  {
+  layer PTR p_layer = plan_step_at(i)->p_layer;
+  if(p_layer==NULL) return false;
+  if(i==0)
+   {if(typeid(*p_layer)!=typeid(bp_input_layer)) return false;}
+  else
+   {
+   if((typeid(*p_layer)!=typeid(bp_comput_layer)) AND
+      (typeid(*p_layer)!=typeid(bp_output_layer))) return false;
+   for(int d=0;d<p_layer->size();d++) biases.push_back(p_layer->PE(d).bias);
+   }
+  if(p_layer->size()<=0) return false;
+  layer_sizes.push_back(p_layer->size());
+  }
+
+ for(int i=1;i<n;i+=2)										// ...and connections between them.
+  {
+  generic_connection_matrix PTR p_matrix = dynamic_cast<generic_connection_matrix PTR>(plan_step_at(i)->p_component);
+  if(p_matrix==NULL) return false;
+  if((NOT p_matrix->has_source_layer()) OR (NOT p_matrix->has_destin_layer())) return false;
+  layer PTR p_source = plan_step_at(i-1)->p_layer;
+  layer PTR p_destin = plan_step_at(i+1)->p_layer;
+  if((&(p_matrix->source_layer())!=p_source) OR (&(p_matrix->destin_layer())!=p_destin)) return false;
+  if(p_matrix->weights_on_disk()) return false;						// (would be copied in memory)
+  if((p_matrix->in_place_weights()!=NULL) AND (NOT copy_in_place_weights))
+   {
+   weight_blocks.push_back(p_matrix->in_place_weights());			// (already contiguous, no copy needed)
+   continue;
+   }
+  weight_blocks.push_back(NULL);										// (set below, as vector may move)
+  for(int d=0;d<p_destin->size();d++)
+   for(int s=0;s<p_source->size();s++)
+    weights.push_back(p_matrix->get_connection_weight(s,d));
+  }
+
+ const DATA PTR copied_weights = weights.data();
+ for(int l=0;l<(int)weight_blocks.size();l++)
+  if(weight_blocks[l]==NULL)
+   {
+   weight_blocks[l] = copied_weights;
+   copied_weights += layer_sizes[l] * layer_sizes[l+1];
+   }
+
+ return no_error();
+ }
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+bool bp_nn::freeze()
+ {
+ unfreeze();
+
+ if(NOT flatten(m_frozen_layer_sizes, m_frozen_weights, m_frozen_weight_blocks, m_frozen_biases, false)) return false;
+
+ int max_layer_size = 0;
+ for(size_t l=0;l<m_frozen_layer_sizes.size();l++)
+  if(m_frozen_layer_sizes[l]>max_layer_size) max_layer_size = m_frozen_layer_sizes[l];
+
+ m_frozen_values_a.assign(max_layer_size,0);
+ m_frozen_values_b.assign(max_layer_size,0);
+ m_frozen_topology_stamp = topology.modifications();
+ m_frozen_is_valid = true;
+ return true;
+ }
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+void bp_nn::unfreeze()
+ {
+ m_frozen_is_valid = false;
+ }
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+bool bp_nn::is_frozen()
+ {
+ return m_frozen_is_valid AND (m_frozen_topology_stamp==topology.modifications());
+ }
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+size_t bp_nn::memory_usage()
+ {
+ return nn::memory_usage() - sizeof(nn) + sizeof(bp_nn) +
+        m_frozen_layer_sizes.capacity()   * sizeof(int) +
+        m_frozen_weights.capacity()       * sizeof(DATA) +
+        m_frozen_weight_blocks.capacity() * sizeof(const DATA PTR) +
+        m_frozen_biases.capacity()        * sizeof(DATA) +
+        m_frozen_values_a.capacity()      * sizeof(DATA) +
+        m_frozen_values_b.capacity()      * sizeof(DATA);
+ }
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// forward pass over flat weights and biases (see bp_nn::flatten), with
+// values_a and values_b as buffers for layer outputs (each at least as long
+// as the largest layer).
+
+static void bp_forward_pass(const std::vector<int> REF layer_sizes,
+                            const std::vector<const DATA PTR> REF weight_blocks,
+                            const std::vector<DATA> REF biases,
+                            const DATA PTR input,
+                            DATA PTR output_buffer,
+                            DATA PTR values_a,
+                            DATA PTR values_b)
+ {
+ int number_of_layers = (int) layer_sizes.size();
+
+ const DATA PTR x = input;									// input layer just passes values
+ const DATA PTR w;
+ const DATA PTR b = biases.data();
+ DATA PTR y = values_a;
+
+ for(int l=1;l<number_of_layers;l++)
+  {
+  int source_size = layer_sizes[l-1];
+  int destin_size = layer_sizes[l];
+  w = weight_blocks[l-1];
+  if(l==number_of_layers-1) y = output_buffer;				// last layer writes directly to output
+  NN_COUNT(cnt_connections_visited,(int64_t)source_size*destin_size);
+  NN_COUNT(cnt_multiply_adds,(int64_t)source_size*destin_size);
+  NN_COUNT(cnt_exp_evaluations,destin_size);
+  for(int d=0;d<destin_size;d++)
+   {
+   DATA a = 0;
+   for(int s=0;s<source_size;s++) a = a + x[s] * w[s];		// weighted sum (same order as in bp_connection_matrix),
+   a = a + b[d];												// add bias,
+   y[d] = (DATA)1/(1+exp(-a));								// and apply logistic sigmoid (as in bp_comput_layer::recall).
+   w += source_size;
+   }
+  b += destin_size;
+  x = y;
+  y = (y==values_a) ? values_b : values_a;
+  }
+ }
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// recall a single input vector using the frozen weights and biases.
+// Checks are done once per call, and no memory is allocated (once frozen).
+// Results are the same as those of recall(), but PE values are not changed.
+
+bool bp_nn::recall_frozen(const DATA PTR input,int input_dim,DATA PTR output_buffer,int output_dim)
+ {
+ if((input==NULL) OR (output_buffer==NULL)) return false;
+ if(NOT is_frozen())
+  if(NOT freeze()) return false;
+ if(NOT no_error()) return false;
+
+ int number_of_layers = (int) m_frozen_layer_sizes.size();
+ if(input_dim!=m_frozen_layer_sizes[0]) return false;
+ if(output_dim!=m_frozen_layer_sizes[number_of_layers-1]) return false;
+
+ bp_forward_pass(m_frozen_layer_sizes, m_frozen_weight_blocks, m_frozen_biases, input, output_buffer, m_frozen_values_a.data(), m_frozen_values_b.data());
+ return true;
+ }
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// immutable copy of current weights and biases, for recall by other threads
+// (see nnlib2_snapshot.h). NULL if not possible (as for freeze).
+
+bp_snapshot PTR bp_nn::make_snapshot()
+ {
+ bp_snapshot PTR p = new bp_snapshot;
+ if(NOT flatten(p->m_layer_sizes, p->m_weights, p->m_weight_blocks, p->m_biases, true))
+  {
+  delete p;
+  return NULL;
+  }
+ return p;
+ }
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// make this a clone of source: the topology is created as in from_binary_file
+// (same layer and connection set names, sizes and learning rates) and then
+// values are copied by nn::copy_values_from, which shares the weight rows.
+
+bool bp_nn::clone_from(bp_nn REF source)
+ {
+ if(&source==this) return true;
+ if((typeid(*this)!=typeid(bp_nn)) OR (typeid(source)!=typeid(bp_nn)))
+  {error(NN_INTEGR_ERR,"Only plain BP neural nets can be cloned"); return false;}
+ if(NOT source.is_ready())
+  {error(NN_INTEGR_ERR,"BP neural net to clone is not ready"); return false;}
+ if(source.weights_are_on_disk())											// (clone would hold them all in memory)
+  {error(NN_INTEGR_ERR,"BP neural net with weights stored on disk cannot be cloned"); return false;}
+
+ unfreeze();
+ reset(true);
+
+ parameters.reset();
+ for(int i=0;i<source.parameters.number_of_items();i++) parameters.append(source.parameters[i]);
+ m_use_squared_error = source.m_use_squared_error;
+ bp_rnd_min = source.bp_rnd_min;
+ bp_rnd_max = source.bp_rnd_max;
+
+ int number_of_components = source.size();
+ if((number_of_components<3) OR ((number_of_components%2)==0)) {error(NN_INTEGR_ERR,"No BP topology to clone");return false;}
+
+ bp_layer PTR source_layer = NULL;
+
+ for(int i=0;(i<number_of_components) AND no_error();i+=2)
+  {
+  bp_layer PTR p_from = dynamic_cast<bp_layer PTR>(source.get_layer_at(i));
+  bp_layer PTR p_layer;
+
+  if(i==0)                          p_layer = new bp_input_layer;
+  else if(i+1<number_of_components) p_layer = new bp_comput_layer;
+  else                              p_layer = new bp_output_layer;
+
+  if((p_from==NULL) OR (typeid(*p_from)!=typeid(*p_layer)))
+   {
+   delete p_layer;
+   error(NN_INTEGR_ERR,"Unexpected BP topology, cannot clone");
+   return false;
+   }
+
+  p_layer->set_error_flag(my_error_flag());
+  p_layer->setup(p_from->name(),p_from->size());
+  p_layer->set_learning_rate(p_from->get_learning_rate());
+
+  if(i>0)
+   {
+   BP_CONNECTIONS PTR p_set_from = dynamic_cast<BP_CONNECTIONS PTR>(source.get_connection_set_at(i-1));
+   if(p_set_from==NULL)
+    {
+    delete p_layer;
+    error(NN_INTEGR_ERR,"Unexpected BP topology, cannot clone");
+    return false;
+    }
+   BP_CONNECTIONS PTR p_connection_set = new BP_CONNECTIONS;
+   p_connection_set->set_error_flag(my_error_flag());
+   topology.append(p_connection_set);
+   assign_weights_file(p_connection_set,topology.size()-1);		// (used if weights are stored on disk)
+   p_connection_set->set_learning_rate(p_set_from->get_learning_rate());
+   p_connection_set->setup(p_set_from->name(),source_layer,p_layer);
+   }
+
+  topology.append(p_layer);
+
+  source_layer = p_layer;
+  }
+
+ if(NOT copy_values_from(source)) return false;					// (connections and weights)
+
+ m_name = source.name();
+ if(no_error()) set_is_ready_flag();
+ return no_error();
+ }
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+bp_nn PTR bp_nn::clone()
+ {
+ bp_nn PTR p = new bp_nn;
+ if(NOT p->clone_from(ATPTR this))
+  {
+  delete p;
+  return NULL;
+  }
+ return p;
+ }
+
+/*-----------------------------------------------------------------------*/
+/* bp_snapshot															 */
+/*-----------------------------------------------------------------------*/
+
+int bp_snapshot::input_dimension() const
+ {
+ return m_layer_sizes.empty() ? 0 : m_layer_sizes.front();
+ }
+
+int bp_snapshot::output_dimension() const
+ {
+ return m_layer_sizes.empty() ? 0 : m_layer_sizes.back();
+ }
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// same results as bp_nn::recall_frozen. Buffers for layer outputs are kept
+// per thread (allocated only when a larger one is needed).
+
+bool bp_snapshot::recall(const DATA PTR input,int input_dim,DATA PTR output_buffer,int output_dim) const
+ {
+ static thread_local std::vector<DATA> values_a;
+ static thread_local std::vector<DATA> values_b;
+
+ if((input==NULL) OR (output_buffer==NULL)) return false;
+ if(m_layer_sizes.size()<2) return false;
+ if(input_dim!=input_dimension()) return false;
+ if(output_dim!=output_dimension()) return false;
+
+ for(size_t l=0;l<m_layer_sizes.size();l++)
+  if((int)values_a.size()<m_layer_sizes[l])
+   {
+   values_a.resize(m_layer_sizes[l]);
+   values_b.resize(m_layer_sizes[l]);
+   }
+
+ bp_forward_pass(m_layer_sizes, m_weight_blocks, m_biases, input, output_buffer, values_a.data(), values_b.data());
+ return true;
+ }
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+size_t bp_snapshot::memory_usage() const
+ {
+ return sizeof(bp_snapshot) +
+        m_layer_sizes.capacity()   * sizeof(int) +
+        m_weights.capacity()       * sizeof(DATA) +
+        m_weight_blocks.capacity() * sizeof(const DATA PTR) +
+        m_biases.capacity()        * sizeof(DATA);
+ }
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+string bp_nn::weights_filename(int topology_index)
+ {
+ if(m_weights_file_prefix.empty()) return "";
+ std::stringstream s;
+ s << m_weights_file_prefix << "." << topology_index << ".weights";
+ return s.str();
+ }
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+void bp_nn::assign_weights_file(connection_set PTR p_connection_set, int topology_index)
+ {
+ generic_connection_matrix PTR p_matrix = dynamic_cast<generic_connection_matrix PTR>(p_connection_set);
+ if(p_matrix==NULL) return;													// (only matrices can be stored on disk)
+ p_matrix->set_weights_file(weights_filename(topology_index));
+ }
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+bool bp_nn::store_weights_on_disk(string file_prefix)
+ {
+ if(NOT no_error()) return false;
+ unfreeze();
+ m_weights_file_prefix = file_prefix;
+ for(int i=0;i<size();i++)
+  {
+  connection_set PTR p_connection_set = get_connection_set_at(i);
+  if(p_connection_set!=NULL) assign_weights_file(p_connection_set,i);			// (current weights are moved)
+  }
+ return no_error();
+ }
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+bool bp_nn::sync_weights_on_disk()
+ {
+ bool ok = true;
+ for(int i=0;i<size();i++)
+  {
+  generic_connection_matrix PTR p_matrix = dynamic_cast<generic_connection_matrix PTR>(get_connection_set_at(i));
+  if(p_matrix!=NULL) ok = p_matrix->sync_weights_file() AND ok;
+  }
+ return ok;
+ }
+
 /*-----------------------------------------------------------------------*/
 /* Experimental Unsupervised extentions of Back Propagation by VNN		 */
 /*-----------------------------------------------------------------------*/
@@ -606,10 +1129,7 @@ DATA bpu1_nn::encode_u(DATA PTR input, int input_dim, int iteration)
  if(no_error())
   {
   if(OUTPUT_LAYER.input_data_from_vector(desired_output,output_dimension()))
-  if(topology.goto_last())									// start from output layer and...
-   do
-    topology.current()->encode();							// ...encode while...
-   while(topology.goto_previous());							// ...propagating backwards.
+  call_component_encode_all(false);						// start from output layer and encode while propagating backwards.
   }
   // done encoding like in regular bp.
 
@@ -696,10 +1216,7 @@ DATA bpu2_nn::encode_u(DATA PTR input, int input_dim, int iteration)
  if(no_error())
   {
   if(OUTPUT_LAYER.input_data_from_vector(desired_output,output_dimension()))
-  if(topology.goto_last())									// start from output layer and...
-   do
-    topology.current()->encode();							// ...encode while...
-   while(topology.goto_previous());							// ...propagating backwards.
+  call_component_encode_all(false);						// start from output layer and encode while propagating backwards.
    }
   // done encoding like in regular bp.
 
@@ -778,10 +1295,7 @@ DATA bpu3_nn::encode_u(DATA PTR input, int input_dim, int iteration)
  if(no_error())
   {
   if(OUTPUT_LAYER.input_data_from_vector(desired_output,output_dimension()))
-  if(topology.goto_last())									// start from output layer and...
-   do
-    topology.current()->encode();							// ...encode while...
-   while(topology.goto_previous());							// ...propagating backwards.
+  call_component_encode_all(false);						// start from output layer and encode while propagating backwards.
    }
   // done encoding like in regular bp.
 
@@ -845,6 +1359,7 @@ bool bpu4_nn::setup(int input_dimension,int output_dimension)
    new_connection_set = new BP_CONNECTIONS;
    new_connection_set->set_error_flag(my_error_flag());
    topology.append(new_connection_set);
+   assign_weights_file(new_connection_set,topology.size()-1);			// (used if weights are stored on disk)
 
   // create hidden layer(s)...
 
@@ -872,6 +1387,7 @@ bool bpu4_nn::setup(int input_dimension,int output_dimension)
   new_connection_set = new BP_CONNECTIONS;
   new_connection_set->set_error_flag(my_error_flag());
   topology.append(new_connection_set);
+  assign_weights_file(new_connection_set,topology.size()-1);			// (used if weights are stored on disk)
 
   destin_layer = new bp_comput_layer ();									// This is the special layer (nothing special in this version, only size(
   destin_layer->set_error_flag(my_error_flag());
@@ -894,6 +1410,7 @@ bool bpu4_nn::setup(int input_dimension,int output_dimension)
    new_connection_set = new BP_CONNECTIONS;
    new_connection_set->set_error_flag(my_error_flag());
    topology.append(new_connection_set);
+   assign_weights_file(new_connection_set,topology.size()-1);			// (used if weights are stored on disk)
 
   // create hidden layer(s)...
 
@@ -921,6 +1438,7 @@ bool bpu4_nn::setup(int input_dimension,int output_dimension)
   new_connection_set = new BP_CONNECTIONS;
   new_connection_set->set_error_flag(my_error_flag());
   topology.append(new_connection_set);
+  assign_weights_file(new_connection_set,topology.size()-1);			// (used if weights are stored on disk)
 
   destin_layer = new bp_output_layer ();
   destin_layer->set_error_flag(my_error_flag());
@@ -979,10 +1497,7 @@ DATA bpu4_nn::encode_u(DATA PTR input, int input_dim, int iteration)
   if(no_error())
    {
    if(OUTPUT_LAYER.input_data_from_vector(desired_output,input_dim))
-   if(topology.goto_last())									// start from output layer and...
-   do
-    topology.current()->encode();							// ...encode while...
-   while(topology.goto_previous());							// ...propagating backwards.
+   call_component_encode_all(false);						// start from output layer and encode while propagating backwards.
    }
 
   // done encoding like in regular bp.
@@ -1052,6 +1567,7 @@ bool bpu5_nn::setup(int input_dimension, DATA learning_rate, int hidden_layers_p
    new_connection_set = new BP_CONNECTIONS;
    new_connection_set->set_error_flag(my_error_flag());
    topology.append(new_connection_set);
+   assign_weights_file(new_connection_set,topology.size()-1);			// (used if weights are stored on disk)
 
   // create hidden layer(s)...
 
@@ -1079,6 +1595,7 @@ bool bpu5_nn::setup(int input_dimension, DATA learning_rate, int hidden_layers_p
   new_connection_set = new BP_CONNECTIONS;
   new_connection_set->set_error_flag(my_error_flag());
   topology.append(new_connection_set);
+  assign_weights_file(new_connection_set,topology.size()-1);			// (used if weights are stored on disk)
 
   destin_layer = new bp_comput_layer ();									// This is the special layer (nothing special in this version, only size(
   destin_layer->set_error_flag(my_error_flag());
@@ -1102,6 +1619,7 @@ bool bpu5_nn::setup(int input_dimension, DATA learning_rate, int hidden_layers_p
    new_connection_set = new BP_CONNECTIONS;
    new_connection_set->set_error_flag(my_error_flag());
    topology.append(new_connection_set);
+   assign_weights_file(new_connection_set,topology.size()-1);			// (used if weights are stored on disk)
 
   // create hidden layer(s)...
 
@@ -1129,6 +1647,7 @@ bool bpu5_nn::setup(int input_dimension, DATA learning_rate, int hidden_layers_p
   new_connection_set = new BP_CONNECTIONS;
   new_connection_set->set_error_flag(my_error_flag());
   topology.append(new_connection_set);
+  assign_weights_file(new_connection_set,topology.size()-1);			// (used if weights are stored on disk)
 
   destin_layer = new bp_output_layer ();
   destin_layer->set_error_flag(my_error_flag());
@@ -15,22 +15,65 @@
 #define NN_BP_H
 
 #include <cmath>
+#include <vector>
 
 #include "nn.h"
+#include "nnlib2_snapshot.h"
 
 namespace nnlib2 {
 
 namespace bp {
 
+/*-----------------------------------------------------------------------*/
+/* Immutable copy of bp_nn weights and biases, for recall (only) by any	 */
+/* thread, s.a. while the bp_nn is trained (see nnlib2_snapshot.h)		 */
+/*-----------------------------------------------------------------------*/
+
+class bp_snapshot : public model_snapshot
+ {
+ friend class bp_nn;
+
+ private:
+
+ std::vector<int>  m_layer_sizes;				// sizes of layers, from input to output
+ std::vector<DATA> m_weights;					// weights of each connection matrix (row-major, [destin][source]), one after the other
+ std::vector<const DATA *> m_weight_blocks;		// (each matrix in m_weights)
+ std::vector<DATA> m_biases;					// biases of each computing layer, one after the other
+
+ public:
+
+ int input_dimension() const;
+ int output_dimension() const;
+ bool recall(const DATA PTR input,int input_dim,DATA PTR output_buffer,int output_dim) const;	// false if not possible
+ size_t memory_usage() const;
+ };
+
 /*-----------------------------------------------------------------------*/
 /* Back Propagation Perceptron (bp_nn)					 */
 /*-----------------------------------------------------------------------*/
 
 class bp_nn : public NN_PARENT_CLASS
  {
+ private:
+
+ // frozen (read-only) copy of weights and biases, used by recall_frozen():
+ bool m_frozen_is_valid;
+ int  m_frozen_topology_stamp;
+ std::vector<int>  m_frozen_layer_sizes;		// sizes of layers, from input to output
+ std::vector<DATA> m_frozen_weights;			// weights of each connection matrix (row-major, [destin][source]), one after the other (unless used in place)
+ std::vector<const DATA *> m_frozen_weight_blocks;	// weights used for each connection matrix (in m_frozen_weights, or in place in binary model file)
+ std::vector<DATA> m_frozen_biases;				// biases of each computing layer, one after the other
+ std::vector<DATA> m_frozen_values_a;			// preallocated buffers for layer outputs...
+ std::vector<DATA> m_frozen_values_b;			// ...(used alternately).
+
+ string m_weights_file_prefix;					// if not empty, weight matrices are stored on disk (see store_weights_on_disk)
+
  protected:
 
  bool setup(int input_dimension,int output_dimension);
+ bool flatten(std::vector<int> REF layer_sizes, std::vector<DATA> REF weights, std::vector<const DATA PTR> REF weight_blocks, std::vector<DATA> REF biases, bool copy_in_place_weights);	// (see freeze)
+ string weights_filename(int topology_index);							// disk file for weights of connection set at given topology position ("" if weights are in memory)
+ void assign_weights_file(connection_set PTR p_connection_set, int topology_index);	// (call for new connection sets, before they are connected or loaded)
 
  public:
  static bool display_squared_error;		// true = display squared error when encoding, false = display absolute error when encoding
@@ -47,7 +90,44 @@ class bp_nn : public NN_PARENT_CLASS
  void set_initialization_mode_to_default();
  void set_initialization_mode_to_custom(DATA min_value, DATA max_value);
  DATA encode_s(DATA PTR input,int input_dim,DATA PTR desired_output,int output_dim,int UNUSED=0);
- void from_stream ( std::istream REF s );
+ void from_stream ( std::istream REF s );								// (uses from_text below)
+ void from_text ( text_model_reader REF r );
+ bool from_binary_file ( binary_model_file REF f );
+ size_t memory_usage();													// (also counts frozen copy, if any)
+
+ // fast single-vector recall: uses a frozen copy of the current weights and biases,
+ // performs no allocations and does not change the state of the NN components.
+ // The copy is made when needed and dropped by encode_s, setup and from_stream
+ // (call unfreeze() if weights are changed by other means). Weights used in place
+ // (see nn::load_binary_in_place) are not copied.
+
+ bool freeze();															// make frozen copy (false if not possible, s.a. not a plain bp_nn)
+ void unfreeze();
+ bool is_frozen();
+ bool recall_frozen(const DATA PTR input,int input_dim,DATA PTR output_buffer,int output_dim);	// false if not possible (use recall instead)
+
+ // snapshot: as above, but the copy is immutable and owned by the caller, so that
+ // it can be used (s.a. published, see nnlib2_snapshot.h) by other threads while
+ // this bp_nn changes. Weights are always copied.
+
+ bp_snapshot PTR make_snapshot();										// NULL if not possible (as for freeze)
+
+ // clone: a new bp_nn with the same topology, parameters and values as this one.
+ // Weight rows are shared copy-on-write (see generic_connection_matrix::share_weights_from),
+ // so memory is only used for rows that change when either of the two is trained.
+ // Only plain bp_nn (not derived variations), with weights not stored on disk, can be cloned.
+
+ bool clone_from(bp_nn REF source);										// make this a clone of source (false if not possible)
+ bp_nn PTR clone();														// NULL if not possible
+
+ // out-of-core weights: connection matrices are stored in (memory-mapped) disk files
+ // named <file_prefix>.<topology index>.weights, so that nets larger than available
+ // memory can be trained. Applies to current and future (setup or loaded) topology;
+ // use an empty prefix to store weights in memory again.
+
+ bool store_weights_on_disk(string file_prefix);
+ bool weights_are_on_disk()	{ return NOT m_weights_file_prefix.empty(); }
+ bool sync_weights_on_disk();											// write all changes to disk files
  };
 
 
@@ -147,6 +227,7 @@ protected:
 
 public:
         void set_learning_rate(DATA lrate);
+        DATA get_learning_rate() { return m_learning_rate; }
 };
 
 /*-----------------------------------------------------------------------*/
@@ -183,6 +264,7 @@ public:
         void encode();
         void recall();
         void set_learning_rate(DATA d);
+        DATA get_learning_rate() { return m_learning_rate; }
 };
 
 /*-----------------------------------------------------------------------*/
@@ -193,11 +275,16 @@ class bp_connection_matrix : public generic_connection_matrix
 {
 protected:
 	DATA m_learning_rate;
+	std::vector<DATA> m_source_outputs;							// reusable buffer (used by fused recall)
 
 public:
 	void encode();
 	void recall();
 	void set_learning_rate(DATA d);
+	DATA get_learning_rate() { return m_learning_rate; }
+
+	bool can_fuse_recall_with(component PTR p_next);			// true if p_next is the (BP computing) destination layer
+	void recall_fused_with(component PTR p_next);				// matrix-vector product, bias and sigmoid in a single pass
 };
 
 /*-----------------------------------------------------------------------*/
@@ -18,6 +18,7 @@
 //		-----------------------------------------------------------
 
 #include <sstream>
+#include <typeinfo>
 #include "nn_lvq.h"
 
 #include "layer.h"
@@ -204,10 +205,11 @@ void lvq_connection_set::encode()
 
   layer REF destin = destin_layer();
 
-  if(no_error() AND (connections.goto_first()))
-  do
+  NN_COUNT(cnt_connections_visited,connections.size());
+
+  if(no_error())
+  for(connection REF c : connections)
    {
-   connection REF c = (connections.current());
    pe REF destin_pe = destin.PE(c.destin_pe_id());
 
    if(destin_pe.bias == LVQ_REWARD_PE) 						// if destination PE is activated...
@@ -230,7 +232,6 @@ void lvq_connection_set::encode()
    if(c.weight()>m_max_weight_allowed)
    	c.weight()=m_max_weight_allowed;
    }
-  while(connections.goto_next());
   }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -243,10 +244,12 @@ void lvq_connection_set::recall()
   layer REF source = source_layer();
   layer REF destin = destin_layer();
 
-  if(no_error() AND (connections.goto_first()))
-  do
+  NN_COUNT(cnt_connections_visited,connections.size());
+  NN_COUNT(cnt_multiply_adds,connections.size());			// (squared differences summed)
+
+  if(no_error())
+  for(connection REF c : connections)
    {
-   connection REF c = (connections.current());
 
    source_pe = c.source_pe_id();
    destin_pe = c.destin_pe_id();
@@ -260,7 +263,65 @@ void lvq_connection_set::recall()
 
    destin.PE(destin_pe).add_to_input(x);  					        // ...do summation, forming the euclidian distance squared.
    }
-  while(connections.goto_next());
+  }
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// Fused recall: same as recall() above followed by the destination layer's
+// recall(), but source outputs are read once and the squared distances are
+// summed directly on the destination PEs. Winner selection stays in the layer.
+
+bool lvq_connection_set::can_fuse_recall_with(component PTR p_next)
+  {
+  if(p_next==NULL) return false;
+  if(typeid(*p_next)!=typeid(lvq_output_layer)) return false;	// only exact type, derived classes may recall differently
+  if(NOT has_destin_layer()) return false;
+  return (&destin_layer() == p_next);
+  }
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+void lvq_connection_set::recall_fused_with(component PTR p_next)
+  {
+  if((NOT can_fuse_recall_with(p_next)) OR
+     (NOT has_source_layer()))
+   {
+   recall();
+   if(p_next!=NULL) p_next->recall();
+   return;
+   }
+
+  if(NOT no_error()) return;
+
+  layer REF source = source_layer();
+  lvq_output_layer REF destin = *(reinterpret_cast<lvq_output_layer PTR>(p_next));
+
+  int source_size = source.size();
+  m_source_outputs.resize(source_size);
+  DATA PTR x = m_source_outputs.data();
+  for(int s=0;s<source_size;s++) x[s]=source.PE(s).output;
+
+  pe PTR p_destin_pes = destin.PEs();
+  int destin_size = destin.size();
+
+  NN_COUNT(cnt_connections_visited,connections.size());
+  NN_COUNT(cnt_multiply_adds,connections.size());
+
+  for(connection REF c : connections)
+   {
+   int source_pe = c.source_pe_id();
+   int destin_pe = c.destin_pe_id();
+   if((source_pe<0) OR (source_pe>=source_size) OR
+      (destin_pe<0) OR (destin_pe>=destin_size))
+    {
+    error(NN_INTEGR_ERR,"LVQ connection refers to non-existent PE");
+    return;
+    }
+   DATA d = x[source_pe] - c.weight();
+   c.misc = d;
+   p_destin_pes[destin_pe].input = p_destin_pes[destin_pe].input + d*d;
+   }
+
+  destin.recall();
   }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -292,6 +353,29 @@ DATA lvq_connection_set::get_reward_coefficient()
 DATA lvq_connection_set::get_punish_coefficient()
 	{ return m_punish_coefficient; }
 
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// copy weights (codebook vectors) to a row-major [output PE][input] matrix.
+
+bool lvq_connection_set::get_codebook(int input_dim, int output_dim, std::vector<DATA> REF codebook)
+{
+	codebook.assign((size_t)input_dim * output_dim, 0);
+	std::vector<bool> connected((size_t)input_dim * output_dim, false);
+	int number_connected = 0;
+
+	for(connection REF c : connections)
+	{
+		int s = c.source_pe_id();
+		int d = c.destin_pe_id();
+		if((s<0) OR (s>=input_dim) OR (d<0) OR (d>=output_dim)) return false;
+		if(connected[(size_t)d*input_dim+s]) return false;
+		connected[(size_t)d*input_dim+s] = true;
+		codebook[(size_t)d*input_dim+s] = c.weight();
+		number_connected++;
+	}
+
+	return (number_connected==input_dim*output_dim);
+}
+
 /*-----------------------------------------------------------------------*/
 /* Base class for Kohonen - inspired ANS (currently LVQ or SOM)			 */
 /*-----------------------------------------------------------------------*/
@@ -369,23 +453,32 @@ bool kohonen_nn::setup(
 	}
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-// input it :
+// input it : the (remaining) stream is read in memory and parsed by a
+// text_model_reader (see bp_nn::from_stream).
 
 void kohonen_nn::from_stream ( std::istream REF s )
 {
-	string comment;
+	text_model_reader r;
+	r.set_error_flag(my_error_flag());
+	if(r.load_stream(s)) from_text(r);
+	r.return_unused_to(s);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// input it (from text model reader):
+
+void kohonen_nn::from_text ( text_model_reader REF r )
+{
 	lvq_input_layer    * p_input_layer;
 	lvq_output_layer   * p_output_layer;
 	lvq_connection_set * p_connection_set;
 	int number_of_components;
 
-	nn::from_stream(s);		                                    // read header (the way it was done in older versions)
+	nn::from_text(r);		                                    // read header (the way it was done in older versions)
 
 	if(no_error())
 	{
-		if(s.rdstate()) {error(NN_IOFILE_ERR,"Error reading stream (LVQ)");return;}
-
-		s >> comment >> number_of_components ;
+		if(NOT (r.skip() AND r.read(number_of_components))) return;
 
 		if(number_of_components NEQL 3) {error(NN_IOFILE_ERR,"Not a Kohonen-type (LVQ or SOM) neural net");return;}
 
@@ -394,17 +487,17 @@ void kohonen_nn::from_stream ( std::istream REF s )
 		p_input_layer = new lvq_input_layer;
 		p_input_layer->set_error_flag(my_error_flag());				// runtime errors in layer affect entire neural net.
 		topology.append(p_input_layer);
-		p_input_layer->from_stream(s);								// load input layer
+		p_input_layer->from_text(r);								// load input layer
 
 		p_connection_set = new lvq_connection_set;
 		p_connection_set->set_error_flag(my_error_flag());
 		topology.append(p_connection_set);
-		p_connection_set->from_stream(s);							// load connection set
+		p_connection_set->from_text(r);							// load connection set
 
 		p_output_layer = new lvq_output_layer ();
 		p_output_layer->set_error_flag(my_error_flag());
 		topology.append(p_output_layer);
-		p_output_layer->from_stream(s);								// load output layer
+		p_output_layer->from_text(r);								// load output layer
 
 		// fixup connection set (fix pointers ...)
 
@@ -419,6 +512,46 @@ void kohonen_nn::from_stream ( std::istream REF s )
 	}
 }
 
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// input it (binary):
+
+bool kohonen_nn::from_binary_file ( binary_model_file REF f )
+{
+	lvq_input_layer    * p_input_layer;
+	lvq_output_layer   * p_output_layer;
+	lvq_connection_set * p_connection_set;
+
+	reset(false);
+
+	if(f.number_of_components() NEQL 3) {error(NN_IOFILE_ERR,"Not a Kohonen-type (LVQ or SOM) neural net");return false;}
+
+	p_input_layer = new lvq_input_layer;
+	p_input_layer->set_error_flag(my_error_flag());
+	topology.append(p_input_layer);
+
+	p_connection_set = new lvq_connection_set;
+	p_connection_set->set_error_flag(my_error_flag());
+	topology.append(p_connection_set);
+
+	p_output_layer = new lvq_output_layer ();
+	p_output_layer->set_error_flag(my_error_flag());
+	topology.append(p_output_layer);
+
+	if(NOT nn::from_binary_file(f)) return false;
+
+	// fixup connection set (fix pointers ...)
+
+	p_connection_set->setup(p_connection_set->name(),p_input_layer,p_output_layer);
+
+	if(no_error())
+	{
+		set_component_for_input(0);
+		set_component_for_output(2);
+		set_is_ready_flag();
+	}
+	return no_error();
+}
+
 /*-----------------------------------------------------------------------*/
 /* LVQ ANS (Supervised LVQ)												 */
 /*-----------------------------------------------------------------------*/
@@ -614,7 +747,12 @@ DATA lvq_nn::encode_s(	DATA PTR input,
   if(m_punish_enabled)
 		OUTPUT_LAYER.PE(current_winner_pe).bias = LVQ_PUNISH_PE;
 
- if(no_error()) LVQ_CONNECTIONS.encode(iteration);
+ if(no_error())
+  {
+  profile_scope timed(profiler(),1,true,LVQ_CONNECTIONS.size());		// (timed if profiling, see nnlib2_profiler.h)
+  trace_scope traced("encode",LVQ_CONNECTIONS.name().c_str(),"index",1);
+  LVQ_CONNECTIONS.encode(iteration);
+  }
 
  return 0;
  }
@@ -685,6 +823,150 @@ int lvq_nn::recall_class( DATA PTR input,
 	return returned_class;
 }
 
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// copy codebook vectors (connection weights) and rewards. The LVQ must be
+// fully connected (as set up), each input-output pair connected once.
+
+lvq_snapshot PTR lvq_nn::make_snapshot()
+{
+	if(NOT is_ready()) return NULL;
+
+	int input_dim  = input_dimension();
+	int output_dim = output_dimension();
+	if((input_dim<=0) OR (output_dim<=0) OR (m_number_of_output_nodes_per_class<=0)) return NULL;
+
+	lvq_snapshot PTR p = new lvq_snapshot;
+	p->m_input_dimension = input_dim;
+	p->m_output_dimension = output_dim;
+	p->m_number_of_output_nodes_per_class = m_number_of_output_nodes_per_class;
+	p->m_rewards.assign(output_dim, 0);
+
+	if(NOT LVQ_CONNECTIONS.get_codebook(input_dim, output_dim, p->m_codebook))
+	{
+		delete p;
+		return NULL;
+	}
+
+	for(int i=0;i<output_dim;i++) p->m_rewards[i] = OUTPUT_LAYER.PE(i).misc;
+
+	return p;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// make this a copy of source: topology is created as in kohonen_nn::setup
+// (without random weights), then values are copied by nn::copy_values_from.
+// (LVQ connections are in a list, so weights are copied, not shared).
+
+bool lvq_nn::clone_from(lvq_nn REF source)
+{
+	if(&source==this) return true;
+	if((typeid(*this)!=typeid(lvq_nn)) OR (typeid(source)!=typeid(lvq_nn)))
+		{error(NN_INTEGR_ERR,"Only plain LVQ neural nets can be cloned"); return false;}
+	if(NOT source.is_ready())
+		{error(NN_INTEGR_ERR,"LVQ neural net to clone is not ready"); return false;}
+	if(source.size()!=3)
+		{error(NN_INTEGR_ERR,"Unexpected LVQ topology, cannot clone"); return false;}
+
+	lvq_input_layer    PTR p_input_from      = dynamic_cast<lvq_input_layer PTR>(source.get_layer_at(0));
+	lvq_connection_set PTR p_connections_from = dynamic_cast<lvq_connection_set PTR>(source.get_connection_set_at(1));
+	lvq_output_layer   PTR p_output_from     = dynamic_cast<lvq_output_layer PTR>(source.get_layer_at(2));
+	if((p_input_from==NULL) OR (p_connections_from==NULL) OR (p_output_from==NULL))
+		{error(NN_INTEGR_ERR,"Unexpected LVQ topology, cannot clone"); return false;}
+
+	reset();
+
+	lvq_input_layer PTR p_input_layer = new lvq_input_layer;
+	p_input_layer->set_error_flag(my_error_flag());
+	p_input_layer->setup(p_input_from->name(),p_input_from->size());
+
+	lvq_output_layer PTR p_output_layer = new lvq_output_layer;
+	p_output_layer->set_error_flag(my_error_flag());
+	p_output_layer->setup(p_output_from->name(),p_output_from->size(),1);
+
+	lvq_connection_set PTR p_connection_set = new lvq_connection_set;
+	p_connection_set->set_error_flag(my_error_flag());
+	p_connection_set->setup(p_connections_from->name(),p_input_layer,p_output_layer);
+	p_connection_set->set_weight_limits(p_connections_from->get_min_weight_allowed(),p_connections_from->get_max_weight_allowed());
+	p_connection_set->set_encoding_coefficients(p_connections_from->get_reward_coefficient(),p_connections_from->get_punish_coefficient());
+
+	topology.append(p_input_layer);
+	topology.append(p_connection_set);
+	topology.append(p_output_layer);
+
+	if(NOT copy_values_from(source)) return false;				// (connections are created by copy)
+
+	m_number_of_output_nodes_per_class = source.m_number_of_output_nodes_per_class;
+	m_punish_enabled = source.m_punish_enabled;
+	m_name = source.name();
+	if(no_error()) set_is_ready_flag();
+	return no_error();
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+lvq_nn PTR lvq_nn::clone()
+{
+	lvq_nn PTR p = new lvq_nn;
+	if(NOT p->clone_from(ATPTR this))
+	{
+		delete p;
+		return NULL;
+	}
+	return p;
+}
+
+/*-----------------------------------------------------------------------*/
+/* lvq_snapshot															 */
+/*-----------------------------------------------------------------------*/
+
+lvq_snapshot::lvq_snapshot()
+{
+	m_input_dimension = 0;
+	m_output_dimension = 0;
+	m_number_of_output_nodes_per_class = 1;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// winner selection as in lvq_nn::recall_class (but no error is reported
+// if no output node has requested number of rewards, -1 is returned).
+
+int lvq_snapshot::recall_class(const DATA PTR input, int input_dim, int min_rewards) const
+{
+	if((input==NULL) OR (input_dim!=m_input_dimension) OR (m_output_dimension<=0)) return -1;
+
+	NN_COUNT(cnt_connections_visited,m_codebook.size());
+	NN_COUNT(cnt_multiply_adds,m_codebook.size());
+
+	int current_winner_pe = -1;
+	DATA current_win_output = DATA_MAX;
+
+	for(int i=0;i<m_output_dimension;i++)
+	{
+		if(m_rewards[i] < min_rewards) continue;
+		const DATA PTR w = m_codebook.data() + (size_t)i*m_input_dimension;
+		DATA d = 0;
+		for(int s=0;s<m_input_dimension;s++) d = d + (input[s]-w[s])*(input[s]-w[s]);
+		d = sqrt(d);												// Euclidian distance, as in lvq_output_layer::recall.
+		if((current_winner_pe<0) OR (d<=current_win_output))
+		{
+			current_win_output = d;
+			current_winner_pe  = i;
+		}
+	}
+
+	if(current_winner_pe<0) return -1;
+	return (int)(current_winner_pe / m_number_of_output_nodes_per_class);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+size_t lvq_snapshot::memory_usage() const
+{
+	return sizeof(lvq_snapshot) +
+	       m_codebook.capacity() * sizeof(DATA) +
+	       m_rewards.capacity()  * sizeof(DATA);
+}
+
 /*-----------------------------------------------------------------------*/
 /* Kononen SOM	ANS	(Unsupervised LVQ)									 */
 /*-----------------------------------------------------------------------*/
@@ -718,7 +1000,12 @@ DATA som_nn::encode_u(DATA PTR input, int input_dim, int iteration)
   {
   INPUT_LAYER.input_data_from_vector(input,input_dim);
   recall();
-  if(no_error()) LVQ_CONNECTIONS.encode(iteration);
+  if(no_error())
+   {
+   profile_scope timed(profiler(),1,true,LVQ_CONNECTIONS.size());	// (timed if profiling, see nnlib2_profiler.h)
+   trace_scope traced("encode",LVQ_CONNECTIONS.name().c_str(),"index",1);
+   LVQ_CONNECTIONS.encode(iteration);
+   }
   }
  return 1;
  }
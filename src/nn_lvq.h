@@ -22,8 +22,10 @@
 #define NN_LVQ_H
 
 #include <cmath>
+#include <vector>
 
 #include "nn.h"
+#include "nnlib2_snapshot.h"
 
 #define LVQ_MAXITERATION (10000)
 
@@ -66,6 +68,8 @@ private:
 		DATA m_reward_coefficient;
 		DATA m_punish_coefficient;
 
+		std::vector<DATA> m_source_outputs;	// reusable buffer (used by fused recall)
+
 public:
 
         lvq_connection_set();
@@ -76,6 +80,9 @@ public:
         void encode();						// virtual, defined in component
         void encode(int iteration);			// a variation of above, imposes iteration number
 
+        bool can_fuse_recall_with(component PTR p_next);	// true if p_next is the (lvq_output_layer) destination layer
+        void recall_fused_with(component PTR p_next);		// distances computed directly on destination PEs, then output layer recall
+
 		// helper functions for experimentation:
 
 		void set_weight_limits(DATA min, DATA max);
@@ -85,6 +92,8 @@ public:
 		void set_encoding_coefficients(DATA reward, DATA punish);
 		DATA get_reward_coefficient();
 		DATA get_punish_coefficient();
+
+		bool get_codebook(int input_dim, int output_dim, std::vector<DATA> REF codebook);	// weights as [output PE][input] matrix, false if not fully connected once
 };
 
 
@@ -106,7 +115,35 @@ public:
 	kohonen_nn();
 	~kohonen_nn();
 
-	void from_stream ( std::istream REF s );
+	void from_stream ( std::istream REF s );							// (uses from_text below)
+	void from_text ( text_model_reader REF r );
+	bool from_binary_file ( binary_model_file REF f );
+};
+
+/*-----------------------------------------------------------------------*/
+/* Immutable copy of lvq_nn codebook vectors, for recall (only) by any	 */
+/* thread, s.a. while the lvq_nn is trained (see nnlib2_snapshot.h)		 */
+/*-----------------------------------------------------------------------*/
+
+class lvq_snapshot : public model_snapshot
+{
+	friend class lvq_nn;
+
+private:
+
+	int m_input_dimension;
+	int m_output_dimension;
+	int m_number_of_output_nodes_per_class;
+	std::vector<DATA> m_codebook;				// codebook vectors (weights), row-major [output PE][input]
+	std::vector<DATA> m_rewards;				// rewards given to each output PE during encoding
+
+public:
+
+	lvq_snapshot();
+	int input_dimension() const  { return m_input_dimension; }
+	int output_dimension() const { return m_output_dimension; }
+	int recall_class(const DATA PTR input, int input_dim, int min_rewards) const;	// same as lvq_nn::recall_class, -1 if not possible
+	size_t memory_usage() const;
 };
 
 /*-----------------------------------------------------------------------*/
@@ -145,6 +182,11 @@ public:
 	DATA encode_s(DATA PTR input, int input_dim, int desired_class, int iteration);							// Note: 0 indicates no error (success), DATA_MAX failure.
 
 	int recall_class (DATA PTR input, int input_dim, int min_rewards = 0);									// min_rewards allows ignoring PE that were not rewarded during encoding (training).
+
+	lvq_snapshot PTR make_snapshot();		// immutable copy for recall by other threads (see nnlib2_snapshot.h), NULL if not possible
+
+	bool clone_from(lvq_nn REF source);		// make this a copy of source, with same settings (false if not possible, s.a. not a plain lvq_nn)
+	lvq_nn PTR clone();						// NULL if not possible
 };
 
 /*-----------------------------------------------------------------------*/
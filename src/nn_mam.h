@@ -81,6 +81,16 @@ public:
 		}
 
 	// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+	// input it (binary): setup with stored layer sizes, then load components
+
+	bool from_binary_file(binary_model_file REF f)
+		{
+		if(f.number_of_components() NEQL 3) {error(NN_IOFILE_ERR,"Not a MAM neural net");return false;}
+		if(NOT setup(f.component_block(0).rows(),f.component_block(2).rows())) return false;
+		return nn::from_binary_file(f);
+		}
+
+	// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
 };
 
@@ -23,8 +23,22 @@
 //#define NNLIB2_FOR_RCPP               // for R (Rcpp) package of nnlib2 NNs
 //#define NNLIB2_FOR_MFC_UI				// for MS-Windows (MFC and VS6) support and GUI to nnlib2
 
-// define ONLY ONE of the above (or none for generic, unspecified target, C++ compilation):
+// define ONLY ONE of the above (or none for generic, unspecified target, C++ compilation).
+// If NNLIB2_FOR_GCC or NNLIB2_FOR_MFC_UI is defined on the compiler command line
+// (s.a. -DNNLIB2_FOR_GCC, used by standalone benchmarks in bench/), it is used instead:
+#if !defined(NNLIB2_FOR_GCC) && !defined(NNLIB2_FOR_MFC_UI)
 #define NNLIB2_FOR_RCPP
+#endif
+
+// TRUE and FALSE (defined by R) are also used by nnlib2 code, so define them for other targets:
+#ifndef NNLIB2_FOR_RCPP
+#ifndef TRUE
+#define TRUE true
+#endif
+#ifndef FALSE
+#define FALSE false
+#endif
+#endif
 
 /*-----------------------------------------------------------------------*/
 
@@ -90,6 +104,9 @@ using std::string;
 /*-----------------------------------------------------------------------*/
 
 #define NN_VERBOSE						// more messages (for debugging)
+#define NN_PROFILING					// include (opt-in, run-time enabled) per-component timing profiler, see nnlib2_profiler.h
+#define NN_COUNTERS						// include (always on) hot path performance counters, see nnlib2_counters.h
+#define NN_TRACING						// include (opt-in, run-time enabled) event tracing to Chrome trace JSON, see nnlib2_trace.h
 
 /*-----------------------------------------------------------------------*/
 
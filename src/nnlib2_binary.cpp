@@ -0,0 +1,582 @@
+//		----------------------------------------------------------
+//		(c)2026  Vasilis.N.Nikolaidis          All rights reserved.
+//		-----------------------------------------------------------
+//		nnlib2_binary.cpp						Version 0.1
+//		-----------------------------------------------------------
+//		Versioned binary model file format (see nnlib2_binary.h)
+//		-----------------------------------------------------------
+
+#include "nnlib2_binary.h"
+
+#include <cstring>
+#include <fstream>
+
+#if !defined(_WIN32)
+#define NN_BINARY_USE_MMAP
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace nnlib2 {
+
+static const char binary_file_magic[8] = {'N','N','L','I','B','2','B','N'};
+
+static uint64_t padded_to_8(uint64_t bytes) { return (bytes + 7) & ~((uint64_t)7); }
+
+/*-----------------------------------------------------------------------*/
+// CRC32 (same polynomial as zlib)
+
+struct crc32_table
+{
+	uint32_t entry[256];
+	crc32_table()
+	{
+		for(uint32_t i=0;i<256;i++)
+		{
+			uint32_t c = i;
+			for(int k=0;k<8;k++) c = (c & 1) ? (0xEDB88320 ^ (c >> 1)) : (c >> 1);
+			entry[i] = c;
+		}
+	}
+};
+
+uint32_t crc32_update(uint32_t crc, const void PTR data, size_t length)
+{
+	static const crc32_table table;							// (initialized once, thread-safe)
+
+	const unsigned char PTR p = (const unsigned char PTR) data;
+	crc = crc ^ 0xFFFFFFFF;
+	for(size_t i=0;i<length;i++) crc = table.entry[(crc ^ p[i]) & 0xFF] ^ (crc >> 8);
+	return crc ^ 0xFFFFFFFF;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+uint64_t binary_payload_bytes(binary_block_kind kind, int rows, int cols)
+{
+	uint64_t r = (rows>0) ? (uint64_t) rows : 0;
+	uint64_t c = (cols>0) ? (uint64_t) cols : 0;
+
+	switch(kind)
+	{
+	case bin_layer:				return 2 * padded_to_8(r * sizeof(DATA));
+	case bin_connection_list:	return padded_to_8(r * sizeof(DATA)) + 2 * padded_to_8(r * sizeof(int32_t));
+	case bin_connection_matrix:	return padded_to_8(r * c * sizeof(DATA));
+	default:					return 0;
+	}
+}
+
+/*-----------------------------------------------------------------------*/
+/* binary_writer                                                         */
+/*-----------------------------------------------------------------------*/
+
+binary_writer::binary_writer(std::ostream REF s)
+{
+	mp_stream = &s;
+	m_crc = 0;
+	m_expected_payload_bytes = 0;
+	m_written_payload_bytes = 0;
+	m_block_bytes = 0;
+	m_in_component = false;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+bool binary_writer::write_raw(const void PTR data, size_t length)
+{
+	if(NOT no_error()) return false;
+	if(length==0) return true;
+	mp_stream->write((const char PTR) data, length);
+	if(NOT mp_stream->good()) {error(NN_IOFILE_ERR,"Error writing binary stream"); return false;}
+	if(m_in_component) m_crc = crc32_update(m_crc, data, length);
+	return true;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+bool binary_writer::write_padding(uint64_t length_written)
+{
+	static const char zeros[8] = {0,0,0,0,0,0,0,0};
+	return write_raw(zeros, (size_t)(padded_to_8(length_written) - length_written));
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+bool binary_writer::begin_file(string name, int id, DATA auxiliary_parameter, int number_of_components, int input_dimension, int output_dimension)
+{
+	binary_file_header h;
+	memset(&h, 0, sizeof(h));
+	memcpy(h.magic, binary_file_magic, 8);
+	h.version = NN_BINARY_FILE_VERSION;
+	h.byte_order_mark = NN_BINARY_BYTE_ORDER_MARK;
+	h.data_size = sizeof(DATA);
+	h.number_of_components = (uint32_t) number_of_components;
+	h.input_dimension = input_dimension;
+	h.output_dimension = output_dimension;
+	h.name_length = (uint32_t) name.length();
+	h.id = id;
+	h.auxiliary_parameter = (double) auxiliary_parameter;
+
+	h.checksum = crc32_update(0, &h, sizeof(h));
+	h.checksum = crc32_update(h.checksum, name.data(), name.length());
+
+	m_in_component = false;
+	return write_raw(&h, sizeof(h)) AND
+	       write_raw(name.data(), name.length()) AND
+	       write_padding(name.length());
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+bool binary_writer::begin_component(component REF c, binary_block_kind kind, int rows, int cols, int source_component_id, int destin_component_id)
+{
+	if(m_in_component) {error(NN_INTEGR_ERR,"Binary component not completed"); return false;}
+
+	string name = c.name();
+
+	binary_component_header h;
+	memset(&h, 0, sizeof(h));
+	h.magic = NN_BINARY_COMPONENT_MAGIC;
+	h.type = (uint32_t) c.type();
+	h.kind = (uint32_t) kind;
+	h.id = c.id();
+	h.source_component_id = source_component_id;
+	h.destin_component_id = destin_component_id;
+	h.rows = rows;
+	h.cols = cols;
+	h.name_length = (uint32_t) name.length();
+	h.payload_bytes = binary_payload_bytes(kind, rows, cols);
+	h.auxiliary_parameter = (double) c.auxiliary_parameter();
+
+	m_in_component = true;											// from here on, compute CRC
+	m_crc = 0;
+	m_expected_payload_bytes = h.payload_bytes;
+	m_written_payload_bytes = 0;
+	m_block_bytes = 0;
+
+	return write_raw(&h, sizeof(h)) AND
+	       write_raw(name.data(), name.length()) AND
+	       write_padding(name.length());
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+bool binary_writer::write_data(const DATA PTR data, int count)
+{
+	if(count<=0) return true;
+	if(data==NULL) {error(NN_NULLPT_ERR,"No data to write"); return false;}
+	size_t length = (size_t) count * sizeof(DATA);
+	m_block_bytes += length;
+	return write_raw(data, length);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+bool binary_writer::write_ints(const int PTR data, int count)
+{
+	if(count<=0) return true;
+	if(data==NULL) {error(NN_NULLPT_ERR,"No data to write"); return false;}
+	for(int i=0;i<count;i++)
+	{
+		int32_t v = (int32_t) data[i];
+		if(NOT write_raw(&v, sizeof(v))) return false;
+	}
+	m_block_bytes += (uint64_t) count * sizeof(int32_t);
+	return true;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+bool binary_writer::end_block()
+{
+	if(NOT write_padding(m_block_bytes)) return false;
+	m_written_payload_bytes += padded_to_8(m_block_bytes);
+	m_block_bytes = 0;
+	return true;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+bool binary_writer::end_component()
+{
+	if(NOT m_in_component) {error(NN_INTEGR_ERR,"No binary component to complete"); return false;}
+	if(m_block_bytes>0) end_block();
+	m_in_component = false;
+
+	if(m_written_payload_bytes!=m_expected_payload_bytes)
+		{error(NN_INTEGR_ERR,"Binary component data size is not the expected"); return false;}
+
+	binary_component_trailer t;
+	t.magic = NN_BINARY_TRAILER_MAGIC;
+	t.checksum = m_crc;
+	return write_raw(&t, sizeof(t));
+}
+
+/*-----------------------------------------------------------------------*/
+/* binary_delta_writer                                                   */
+/*-----------------------------------------------------------------------*/
+
+binary_delta_writer::binary_delta_writer(std::ostream REF s)
+{
+	mp_stream = &s;
+	m_component = -1;
+	m_crc = 0;
+	m_number_of_ranges = 0;
+	m_bytes = 0;
+	m_remaining = 0;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+bool binary_delta_writer::write_raw(const void PTR data, size_t length)
+{
+	if(NOT no_error()) return false;
+	if(length==0) return true;
+	mp_stream->write((const char PTR) data, length);
+	if(NOT mp_stream->good()) {error(NN_IOFILE_ERR,"Error writing binary stream"); return false;}
+	m_crc = crc32_update(m_crc, data, length);
+	m_bytes += length;
+	return true;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+bool binary_delta_writer::begin_range(binary_delta_array array, int64_t first, int64_t count)
+{
+	if(m_remaining!=0)  {error(NN_INTEGR_ERR,"Range of changed values not completed"); return false;}
+	if(m_component<0)   {error(NN_INTEGR_ERR,"No component specified for changed values"); return false;}
+
+	binary_delta_range_header h;
+	memset(&h, 0, sizeof(h));
+	h.component = m_component;
+	h.array = (uint32_t) array;
+	h.first = first;
+	h.count = count;
+
+	m_remaining = count;
+	m_number_of_ranges++;
+	return write_raw(&h, sizeof(h));
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+bool binary_delta_writer::write_data(const DATA PTR data, int count)
+{
+	if(count<=0) return true;
+	if(data==NULL) {error(NN_NULLPT_ERR,"No data to write"); return false;}
+	if(count>m_remaining) {error(NN_INTEGR_ERR,"Too many values in range of changed values"); return false;}
+	m_remaining -= count;
+	return write_raw(data, (size_t) count * sizeof(DATA));
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+bool binary_delta_writer::end_range()
+{
+	static const char zeros[8] = {0,0,0,0,0,0,0,0};
+	if(m_remaining!=0) {error(NN_INTEGR_ERR,"Range of changed values not completed"); return false;}
+	return write_raw(zeros, (size_t)(padded_to_8(m_bytes) - m_bytes));
+}
+
+/*-----------------------------------------------------------------------*/
+/* dirty_block_tracker                                                   */
+/*-----------------------------------------------------------------------*/
+
+dirty_block_tracker::dirty_block_tracker()
+{
+	m_items = -1;
+	m_items_per_block = 1;
+	m_layout = 0;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// each step (xor, rotate, multiply by odd number) is invertible, so a change
+// in any single value always changes the fingerprint.
+
+static inline uint64_t fingerprint_step(uint64_t h, uint64_t bits)
+{
+	h = h ^ bits;
+	h = (h << 29) | (h >> 35);
+	return h * 0x100000001B3ULL;
+}
+
+uint64_t dirty_block_tracker::fingerprint(const DATA PTR values, int count, uint64_t h)
+{
+	for(int i=0;i<count;i++)
+	{
+		uint64_t bits = 0;
+		memcpy(&bits, &values[i], sizeof(DATA));				// (exact, bit pattern of value)
+		h = fingerprint_step(h, bits);
+	}
+	return h;
+}
+
+uint64_t dirty_block_tracker::fingerprint(const int PTR values, int count, uint64_t h)
+{
+	for(int i=0;i<count;i++) h = fingerprint_step(h, (uint64_t)(uint32_t) values[i]);
+	return h;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+void dirty_block_tracker::start(int number_of_items, int items_per_block, uint64_t layout)
+{
+	if(number_of_items<0) number_of_items = 0;
+	if(items_per_block<1) items_per_block = 1;
+	m_items = number_of_items;
+	m_items_per_block = items_per_block;
+	m_layout = layout;
+	m_fingerprints.assign((size_t)((number_of_items + items_per_block - 1) / items_per_block), 0);
+}
+
+/*-----------------------------------------------------------------------*/
+/* binary_component_block                                                */
+/*-----------------------------------------------------------------------*/
+
+const DATA PTR binary_component_block::biases()
+{
+	return (const DATA PTR) payload;
+}
+
+const DATA PTR binary_component_block::misc()
+{
+	return (const DATA PTR) (payload + padded_to_8((uint64_t)rows() * sizeof(DATA)));
+}
+
+const DATA PTR binary_component_block::weights()
+{
+	return (const DATA PTR) payload;
+}
+
+const int32_t PTR binary_component_block::source_pe_ids()
+{
+	return (const int32_t PTR) (payload + padded_to_8((uint64_t)rows() * sizeof(DATA)));
+}
+
+const int32_t PTR binary_component_block::destin_pe_ids()
+{
+	return (const int32_t PTR) (payload + padded_to_8((uint64_t)rows() * sizeof(DATA))
+	                                    + padded_to_8((uint64_t)rows() * sizeof(int32_t)));
+}
+
+DATA PTR binary_component_block::weights_in_place()
+{
+	if(NOT in_place) return NULL;
+	return (DATA PTR) payload;								// (writable, copy-on-write mapping or private buffer)
+}
+
+/*-----------------------------------------------------------------------*/
+/* binary_model_file                                                     */
+/*-----------------------------------------------------------------------*/
+
+binary_model_file::binary_model_file()
+{
+	mp_data = NULL;
+	m_size = 0;
+	m_model_size = 0;
+	mp_mapping = NULL;
+	m_in_place = false;
+	m_writable = false;
+	mp_header = NULL;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+binary_model_file::~binary_model_file()
+{
+	close();
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+bool binary_model_file::is_binary_model_file(string filename)
+{
+	char magic[8];
+	std::ifstream f(filename.c_str(), std::ios::binary);
+	if(NOT f) return false;
+	f.read(magic, 8);
+	if(f.gcount()!=8) return false;
+	return memcmp(magic, binary_file_magic, 8)==0;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+void binary_model_file::close()
+{
+#ifdef NN_BINARY_USE_MMAP
+	if(mp_mapping!=NULL) munmap(mp_mapping, m_size);
+#endif
+	mp_mapping = NULL;
+	m_in_place = false;
+	m_writable = false;
+	m_buffer.clear();
+	m_buffer.shrink_to_fit();
+	mp_data = NULL;
+	m_size = 0;
+	m_model_size = 0;
+	mp_header = NULL;
+	m_name.clear();
+	m_components.clear();
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+bool binary_model_file::open(string filename, bool in_place, bool writable)
+{
+	close();
+	m_in_place = in_place;
+	m_writable = writable;
+
+#ifdef NN_BINARY_USE_MMAP
+	int fd = ::open(filename.c_str(), O_RDONLY);
+	if(fd<0) {error(NN_IOFILE_ERR,"File cannot be opened"); return false;}
+	struct stat st;
+	if((fstat(fd,&st)==0) AND (st.st_size>0))
+	{
+		int protection = (in_place OR writable) ? (PROT_READ | PROT_WRITE) : PROT_READ;	// (MAP_PRIVATE: pages are shared until written)
+		void PTR p = mmap(NULL, (size_t) st.st_size, protection, MAP_PRIVATE, fd, 0);
+		if(p!=MAP_FAILED)
+		{
+			mp_mapping = p;
+			mp_data = (const unsigned char PTR) p;
+			m_size = (size_t) st.st_size;
+		}
+	}
+	::close(fd);
+#endif
+
+	if(mp_data==NULL)												// not mapped, read it all
+	{
+		std::ifstream f(filename.c_str(), std::ios::binary | std::ios::ate);
+		if(NOT f) {error(NN_IOFILE_ERR,"File cannot be opened"); return false;}
+		std::streamoff length = f.tellg();
+		if(length<=0) {error(NN_IOFILE_ERR,"File is empty"); return false;}
+		m_buffer.resize((size_t)length);
+		f.seekg(0);
+		f.read((char PTR) m_buffer.data(), length);
+		if(f.gcount()!=length) {error(NN_IOFILE_ERR,"Error reading file"); m_buffer.clear(); return false;}
+		mp_data = m_buffer.data();
+		m_size = m_buffer.size();
+	}
+
+	if(NOT parse()) {close(); return false;}
+	return true;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// validate headers, sizes and checksums, and locate components
+
+bool binary_model_file::parse()
+{
+	if(m_size<sizeof(binary_file_header)) {error(NN_IOFILE_ERR,"Not a binary NN file (too short)"); return false;}
+
+	mp_header = (const binary_file_header PTR) mp_data;
+
+	if(memcmp(mp_header->magic, binary_file_magic, 8)!=0)		{error(NN_IOFILE_ERR,"Not a binary NN file"); return false;}
+	if(mp_header->byte_order_mark!=NN_BINARY_BYTE_ORDER_MARK)	{error(NN_IOFILE_ERR,"Binary NN file was created on a system with different byte order"); return false;}
+	if(mp_header->version>NN_BINARY_FILE_VERSION)				{error(NN_IOFILE_ERR,"Binary NN file was created by a newer version"); return false;}
+	if(mp_header->data_size!=sizeof(DATA))						{error(NN_IOFILE_ERR,"Binary NN file uses different DATA type"); return false;}
+
+	uint64_t offset = sizeof(binary_file_header);
+	uint64_t name_bytes = padded_to_8(mp_header->name_length);
+	if(offset + name_bytes > m_size) {error(NN_IOFILE_ERR,"Binary NN file is truncated"); return false;}
+
+	binary_file_header h = *mp_header;
+	h.checksum = 0;
+	uint32_t crc = crc32_update(0, &h, sizeof(h));
+	crc = crc32_update(crc, mp_data + offset, mp_header->name_length);
+	if(crc!=mp_header->checksum) {error(NN_IOFILE_ERR,"Binary NN file header is corrupt (checksum)"); return false;}
+
+	m_name.assign((const char PTR)(mp_data + offset), mp_header->name_length);
+	offset += name_bytes;
+
+	m_components.reserve(mp_header->number_of_components);
+
+	for(uint32_t i=0;i<mp_header->number_of_components;i++)
+	{
+		if(offset + sizeof(binary_component_header) > m_size) {error(NN_IOFILE_ERR,"Binary NN file is truncated"); return false;}
+
+		binary_component_block b;
+		b.header = (const binary_component_header PTR) (mp_data + offset);
+
+		if(b.header->magic!=NN_BINARY_COMPONENT_MAGIC)	{error(NN_IOFILE_ERR,"Binary NN file is corrupt (component header)"); return false;}
+		if((b.header->rows<0) OR (b.header->cols<0))	{error(NN_IOFILE_ERR,"Binary NN file is corrupt (component size)"); return false;}
+		if((uint64_t) b.header->rows * (uint64_t) b.header->cols > UINT64_MAX / sizeof(DATA))	// (payload size would overflow)
+			{error(NN_IOFILE_ERR,"Binary NN file is corrupt (component size)"); return false;}
+		if(b.header->payload_bytes > m_size)			{error(NN_IOFILE_ERR,"Binary NN file is truncated"); return false;}
+		if(b.header->payload_bytes!=binary_payload_bytes((binary_block_kind)b.header->kind, b.header->rows, b.header->cols))
+			{error(NN_IOFILE_ERR,"Binary NN file is corrupt (component data size)"); return false;}
+
+		uint64_t start = offset + sizeof(binary_component_header);
+		uint64_t component_name_bytes = padded_to_8(b.header->name_length);
+		uint64_t end = start + component_name_bytes + b.header->payload_bytes;
+
+		if(end + sizeof(binary_component_trailer) > m_size) {error(NN_IOFILE_ERR,"Binary NN file is truncated"); return false;}
+
+		const binary_component_trailer PTR t = (const binary_component_trailer PTR) (mp_data + end);
+		if(t->magic!=NN_BINARY_TRAILER_MAGIC)				{error(NN_IOFILE_ERR,"Binary NN file is corrupt (component trailer)"); return false;}
+		if(t->checksum!=crc32_update(0, mp_data + offset, (size_t)(end - offset)))
+			{error(NN_IOFILE_ERR,"Binary NN file is corrupt (component checksum)"); return false;}
+
+		b.name.assign((const char PTR)(mp_data + start), b.header->name_length);
+		b.payload = mp_data + start + component_name_bytes;
+		b.in_place = m_in_place;
+
+		m_components.push_back(b);
+		offset = end + sizeof(binary_component_trailer);
+	}
+
+	m_model_size = (size_t) offset;
+	return true;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+const unsigned char PTR binary_model_file::data_after_model(size_t REF length)
+{
+	length = 0;
+	if((mp_data==NULL) OR (m_model_size>=m_size)) return NULL;
+	length = m_size - m_model_size;
+	return mp_data + m_model_size;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// (used to apply stored changes, see binary_delta_writer; checksums are
+// not updated, the file has already been validated)
+
+DATA PTR binary_model_file::values_for_update(int component_index, binary_delta_array array, int64_t REF number_of_values)
+{
+	number_of_values = 0;
+	if((NOT m_writable) OR (component_index<0) OR (component_index>=number_of_components())) return NULL;
+
+	binary_component_block REF b = m_components[component_index];
+	const DATA PTR p = NULL;
+
+	switch(b.kind())
+	{
+	case bin_layer:
+		if(array==delta_biases) p = b.biases();
+		if(array==delta_misc)   p = b.misc();
+		number_of_values = b.rows();
+		break;
+	case bin_connection_list:
+		if(array==delta_weights) p = b.weights();
+		number_of_values = b.rows();
+		break;
+	case bin_connection_matrix:
+		if(array==delta_weights) p = b.weights();
+		number_of_values = (int64_t) b.rows() * b.cols();
+		break;
+	default:
+		break;
+	}
+
+	if(p==NULL) number_of_values = 0;
+	return (DATA PTR) p;										// (writable, private mapping or buffer)
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+}   // end of namespace nnlib2
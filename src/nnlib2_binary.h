@@ -0,0 +1,293 @@
+//		----------------------------------------------------------
+//		(c)2026  Vasilis.N.Nikolaidis          All rights reserved.
+//		-----------------------------------------------------------
+//		nnlib2_binary.h							Version 0.1
+//		-----------------------------------------------------------
+//		Versioned binary model file format. Faster and exact (no
+//		rounding of DATA values) alternative to text streams.
+//		-----------------------------------------------------------
+//		File layout (all blocks start at 8-byte aligned offsets):
+//
+//		file header (binary_file_header), NN name (padded)
+//		for each component in topology:
+//			component header (binary_component_header),
+//			component name (padded),
+//			payload (contiguous blocks, each padded), depends on kind:
+//			  bin_layer             : biases[rows], misc[rows]
+//			  bin_connection_list   : weights[rows], source PE ids[rows], destination PE ids[rows]
+//			  bin_connection_matrix : weights[rows*cols], row-major (row = destination PE)
+//			component trailer (binary_component_trailer, with CRC32 of all the above)
+//		(optionally) other data, not part of the model (s.a. the
+//		training state stored in checkpoint files, see nnlib2_checkpoint.h)
+//
+//		Changed values of layers and connection sets can also be
+//		written as a list of ranges (binary_delta_range_header and
+//		DATA values, padded) that patch the payloads of a stored model
+//		(used by delta checkpoints, see nnlib2_checkpoint.h). Changes
+//		are detected by comparing fingerprints of blocks of values
+//		(see dirty_block_tracker).
+//
+//		When reading, the file is memory-mapped (if supported by the
+//		OS, otherwise read in memory) and blocks are used in place.
+//		If opened for in-place use, the mapping is copy-on-write and
+//		components may keep pointing to their data (s.a. the weights
+//		of connection matrices), so that processes loading the same
+//		file share a single (physical) copy of it; the file must then
+//		stay open while the components exist (see nn::load_binary_in_place).
+//		-----------------------------------------------------------
+
+#ifndef NN_BINARY_H
+#define NN_BINARY_H
+
+#include "nnlib2.h"
+#include "nnlib2_error.h"
+#include "component.h"
+
+#include <stdint.h>
+#include <vector>
+
+namespace nnlib2 {
+
+#define NN_BINARY_FILE_VERSION		1
+#define NN_BINARY_BYTE_ORDER_MARK	0x01020304
+#define NN_BINARY_COMPONENT_MAGIC	0x504D4F43		/* "COMP" */
+#define NN_BINARY_TRAILER_MAGIC		0x444E4543		/* "CEND" */
+
+enum binary_block_kind {bin_header_only = 0,		// no payload (s.a. aux_control, or unknown components)
+                        bin_layer,					// biases and misc values of PEs
+                        bin_connection_list,			// list of connections (weights, source and destination PE ids)
+                        bin_connection_matrix};		// matrix of weights
+
+/*-----------------------------------------------------------------------*/
+
+struct binary_file_header								// 64 bytes
+ {
+ char     magic[8];										// "NNLIB2BN"
+ uint32_t version;
+ uint32_t byte_order_mark;								// detects files from machines with different byte order
+ uint32_t data_size;									// sizeof(DATA)
+ uint32_t number_of_components;
+ int32_t  input_dimension;
+ int32_t  output_dimension;
+ uint32_t name_length;
+ uint32_t checksum;										// CRC32 of this header (with checksum set to 0) and name
+ int32_t  id;
+ uint32_t reserved_1;
+ double   auxiliary_parameter;
+ uint8_t  reserved_2[8];
+ };
+
+struct binary_component_header						// 64 bytes
+ {
+ uint32_t magic;
+ uint32_t type;											// component_type
+ uint32_t kind;											// binary_block_kind
+ int32_t  id;
+ int32_t  source_component_id;							// -1 if not a connection set (or not connected)
+ int32_t  destin_component_id;							// -1 if not a connection set (or not connected)
+ int32_t  rows;											// number of PEs for layers, connections for lists, destination PEs for matrices
+ int32_t  cols;											// source PEs for matrices, 1 otherwise
+ uint32_t name_length;
+ uint32_t reserved_1;
+ uint64_t payload_bytes;
+ double   auxiliary_parameter;
+ uint8_t  reserved_2[8];
+ };
+
+struct binary_component_trailer						// 8 bytes
+ {
+ uint32_t magic;
+ uint32_t checksum;										// CRC32 of component header, name and payload
+ };
+
+enum binary_delta_array {delta_weights = 0,			// (bin_connection_list or bin_connection_matrix)
+                         delta_biases,					// (bin_layer)
+                         delta_misc};					// (bin_layer)
+
+#define NN_DIRTY_BLOCK_VALUES		512				/* (about) number of values in blocks tracked for changes */
+
+/*-----------------------------------------------------------------------*/
+
+struct binary_delta_range_header						// 24 bytes
+ {
+ int32_t  component;									// index in topology
+ uint32_t array;										// binary_delta_array
+ int64_t  first;										// first value changed (index in array)
+ int64_t  count;										// number of (DATA) values that follow (padded)
+ };
+
+/*-----------------------------------------------------------------------*/
+
+uint32_t crc32_update(uint32_t crc, const void PTR data, size_t length);
+uint64_t binary_payload_bytes(binary_block_kind kind, int rows, int cols);
+
+/*-----------------------------------------------------------------------*/
+// writes a binary model file to a (binary) stream
+
+class binary_writer : public error_flag_client
+ {
+ private:
+
+ std::ostream PTR mp_stream;
+ uint32_t m_crc;
+ uint64_t m_expected_payload_bytes;
+ uint64_t m_written_payload_bytes;
+ uint64_t m_block_bytes;
+ bool     m_in_component;
+
+ bool write_raw(const void PTR data, size_t length);
+ bool write_padding(uint64_t length_written);
+
+ public:
+
+ binary_writer(std::ostream REF s);
+
+ bool begin_file(string name, int id, DATA auxiliary_parameter, int number_of_components, int input_dimension, int output_dimension);
+ bool begin_component(component REF c, binary_block_kind kind, int rows, int cols, int source_component_id = -1, int destin_component_id = -1);
+ bool write_data(const DATA PTR data, int count);		// (part of) a contiguous block of DATA values...
+ bool write_ints(const int PTR data, int count);		// ...or of (32-bit) integers,
+ bool end_block();										// ends (pads) current block, before starting next one.
+ bool end_component();
+ };
+
+/*-----------------------------------------------------------------------*/
+// writes changed values (ranges, see above) to a (binary) stream
+
+class binary_delta_writer : public error_flag_client
+ {
+ private:
+
+ std::ostream PTR mp_stream;
+ int      m_component;									// topology index of component whose changes are written
+ uint32_t m_crc;
+ uint32_t m_number_of_ranges;
+ uint64_t m_bytes;
+ int64_t  m_remaining;									// values expected to complete current range
+
+ bool write_raw(const void PTR data, size_t length);
+
+ public:
+
+ binary_delta_writer(std::ostream REF s);
+
+ void set_component(int topology_index)	{ m_component = topology_index; }
+ bool begin_range(binary_delta_array array, int64_t first, int64_t count);
+ bool write_data(const DATA PTR data, int count);		// (part of) the values of current range
+ bool end_range();
+
+ uint32_t checksum()            { return m_crc; }		// CRC32 of all ranges written
+ uint32_t number_of_ranges()    { return m_number_of_ranges; }
+ uint64_t bytes_written()       { return m_bytes; }
+ };
+
+/*-----------------------------------------------------------------------*/
+// keeps a fingerprint of each block of items (rows, connections, PEs) as it
+// was when last marked clean, so that changed (dirty) blocks can be found
+// without intercepting every change (components and user code change values
+// directly). Layout is a fingerprint of any other data (s.a. connection PE
+// ids) that must not change.
+
+class dirty_block_tracker
+ {
+ private:
+
+ std::vector<uint64_t> m_fingerprints;
+ int m_items;											// number of items tracked (-1 if not tracking)
+ int m_items_per_block;
+ uint64_t m_layout;
+
+ public:
+
+ static const uint64_t empty_fingerprint = 0xCBF29CE484222325ULL;
+
+ dirty_block_tracker();
+
+ static uint64_t fingerprint(const DATA PTR values, int count, uint64_t h = empty_fingerprint);
+ static uint64_t fingerprint(const int PTR values, int count, uint64_t h = empty_fingerprint);
+
+ void start(int number_of_items, int items_per_block, uint64_t layout = 0);	// (re)start tracking, blocks must then be marked clean
+ void stop()                    { m_items = -1; m_fingerprints.clear(); }
+ bool is_tracking(int number_of_items, int items_per_block, uint64_t layout = 0)
+   { return (m_items==number_of_items) AND (m_items_per_block==items_per_block) AND (m_layout==layout); }
+
+ int  number_of_blocks()        { return (m_items<=0) ? 0 : (int) m_fingerprints.size(); }
+ int  first_item(int block)     { return block * m_items_per_block; }
+ int  items_in_block(int block)	{ int n = m_items - first_item(block); return (n<m_items_per_block) ? n : m_items_per_block; }
+ bool is_dirty(int block, uint64_t fingerprint)	{ return m_fingerprints[block]!=fingerprint; }
+ void set_clean(int block, uint64_t fingerprint)	{ m_fingerprints[block] = fingerprint; }
+ };
+
+/*-----------------------------------------------------------------------*/
+// a component stored in a binary model file (points to data in place)
+
+class binary_component_block
+ {
+ public:
+
+ const binary_component_header PTR header;
+ string name;
+ const unsigned char PTR payload;
+ bool in_place;													// true if file was opened for in-place use
+
+ component_type type()           { return (component_type) header->type; }
+ binary_block_kind kind()        { return (binary_block_kind) header->kind; }
+ int rows()                      { return header->rows; }
+ int cols()                      { return header->cols; }
+
+ const DATA PTR biases();										// bin_layer, rows items
+ const DATA PTR misc();											// bin_layer, rows items
+ const DATA PTR weights();										// bin_connection_list (rows items) or bin_connection_matrix (rows*cols items)
+ const int32_t PTR source_pe_ids();								// bin_connection_list, rows items
+ const int32_t PTR destin_pe_ids();								// bin_connection_list, rows items
+ DATA PTR weights_in_place();									// as weights(), but can be used (and changed, copy-on-write) while file is open; NULL if file was not opened for in-place use.
+ };
+
+/*-----------------------------------------------------------------------*/
+// reads (memory-maps) and validates a binary model file
+
+class binary_model_file : public error_flag_client
+ {
+ private:
+
+ const unsigned char PTR mp_data;
+ size_t m_size;
+ size_t m_model_size;											// bytes used by the model (any other data follows)
+
+ void PTR mp_mapping;											// OS mapping (if memory-mapped)
+ bool m_in_place;												// opened for in-place use (see above)
+ bool m_writable;												// opened so that stored values can be changed (privately, see values_for_update)
+ std::vector<unsigned char> m_buffer;							// used if file is not memory-mapped
+
+ const binary_file_header PTR mp_header;
+ string m_name;
+ std::vector<binary_component_block> m_components;
+
+ bool parse();
+
+ public:
+
+ binary_model_file();
+ ~binary_model_file();
+
+ static bool is_binary_model_file(string filename);				// checks magic bytes only
+
+ bool open(string filename, bool in_place = false, bool writable = false);	// maps (or reads) and validates the entire file
+ void close();
+ bool is_open()                  { return mp_data!=NULL; }
+ bool is_memory_mapped()         { return mp_mapping!=NULL; }
+ bool is_in_place()              { return m_in_place; }
+
+ string name()                   { return m_name; }
+ int id()                        { return mp_header->id; }
+ DATA auxiliary_parameter()      { return (DATA) mp_header->auxiliary_parameter; }
+ int input_dimension()           { return mp_header->input_dimension; }
+ int output_dimension()          { return mp_header->output_dimension; }
+ int number_of_components()      { return (int) m_components.size(); }
+ binary_component_block REF component_block(int index)	{ return m_components[index]; }	// (index is not checked)
+ const unsigned char PTR data_after_model(size_t REF length);	// data stored after the model (see above), NULL if none
+ DATA PTR values_for_update(int component_index, binary_delta_array array, int64_t REF number_of_values);	// stored array of component that can be changed (before components read it) if file was opened as writable; NULL if not available. Changes are not written to the file.
+ };
+
+}   // end of namespace nnlib2
+
+#endif // NN_BINARY_H
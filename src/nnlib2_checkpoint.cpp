@@ -0,0 +1,478 @@
+//		----------------------------------------------------------
+//		(c)2026  Vasilis.N.Nikolaidis          All rights reserved.
+//		-----------------------------------------------------------
+//		nnlib2_checkpoint.cpp					Version 0.1
+//		-----------------------------------------------------------
+//		Periodic training checkpoints (see nnlib2_checkpoint.h)
+//		-----------------------------------------------------------
+
+#include "nnlib2_checkpoint.h"
+#include "nnlib2_binary.h"
+#include "nnlib2_misc.h"
+#include "nnlib2_trace.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+
+namespace nnlib2 {
+
+static const char checkpoint_magic[8] = {'N','N','L','I','B','2','C','K'};
+static const char delta_magic[8]      = {'N','N','L','I','B','2','D','L'};
+
+static uint64_t padded_to_8(uint64_t bytes) { return (bytes + 7) & ~((uint64_t)7); }
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+string checkpoint_delta_filename(string filename)
+{
+	return filename + ".delta";
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// write random number generator state (padded), updating CRC
+
+static void write_random_state(std::ostream REF s, const std::vector<int> REF random_state, uint32_t REF crc)
+{
+	if(random_state.empty()) return;
+	size_t bytes = random_state.size()*sizeof(int32_t);
+	std::vector<unsigned char> buffer((size_t)padded_to_8(bytes), 0);
+	memcpy(buffer.data(), random_state.data(), bytes);
+	crc = crc32_update(crc, buffer.data(), buffer.size());
+	s.write((const char PTR) buffer.data(), (std::streamsize) buffer.size());
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+checkpoint_writer::checkpoint_writer()
+{
+	m_every_epochs = 0;
+	m_every_seconds = 0;
+	m_missed = false;
+	m_last_time = std::chrono::steady_clock::now();
+	m_busy.store(false);
+	m_snapshot_is_delta = false;
+	m_max_deltas = 0;
+	m_deltas = 0;
+	m_snapshot_id = 0;
+	m_snapshot_components = -1;
+	m_snapshot_bytes = 0;
+	m_delta_bytes = 0;
+	m_delta_failed.store(false);
+	m_written.store(0);
+	m_written_deltas.store(0);
+	m_failed.store(0);
+	m_skipped = 0;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+checkpoint_writer::~checkpoint_writer()
+{
+	join();													// (no flush_pending_messages here, R must not be called from destructors)
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+bool checkpoint_writer::setup(string filename, int every_epochs, double every_seconds)
+{
+	finish();
+
+	if(every_epochs<0) every_epochs = 0;
+	if(every_seconds<0) every_seconds = 0;
+	if((every_epochs==0) AND (every_seconds==0)) filename.clear();
+
+	m_filename = filename;
+	m_every_epochs = every_epochs;
+	m_every_seconds = every_seconds;
+	m_missed = false;
+	m_deltas = 0;
+	m_snapshot_components = -1;								// (first checkpoint is a full snapshot)
+	m_snapshot_id = (uint32_t) std::chrono::system_clock::now().time_since_epoch().count();	// (differs from snapshots of previous sessions)
+	m_delta_failed.store(false);
+	m_written.store(0);
+	m_written_deltas.store(0);
+	m_failed.store(0);
+	m_skipped = 0;
+	start();
+	return enabled();
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+void checkpoint_writer::set_max_deltas(int max_deltas)
+{
+	m_max_deltas = (max_deltas<0) ? 0 : max_deltas;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+void checkpoint_writer::start()
+{
+	m_last_time = std::chrono::steady_clock::now();
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+bool checkpoint_writer::is_due(int completed_epochs)
+{
+	if(m_filename.empty()) return false;
+	if(m_missed) return true;
+	if((m_every_epochs>0) AND (completed_epochs>0) AND ((completed_epochs % m_every_epochs)==0)) return true;
+	if(m_every_seconds>0)
+	{
+		std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - m_last_time;
+		if(elapsed.count()>=m_every_seconds) return true;
+	}
+	return false;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+bool checkpoint_writer::checkpoint_if_due(nn REF n, int completed_epochs)
+{
+	if(NOT is_due(completed_epochs)) return false;
+	return save(n,completed_epochs);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+bool checkpoint_writer::save(nn REF n, int completed_epochs)
+{
+	if(m_filename.empty()) return false;
+
+	if(m_busy.load(std::memory_order_acquire))				// previous checkpoint is still being written, do not wait for it
+	{
+		m_skipped++;
+		m_missed = true;
+		return false;
+	}
+	if(m_thread.joinable()) m_thread.join();				// (finished)
+
+	// take snapshot (model, epoch counter and random generator state), or
+	// only the changes since previous checkpoint, in memory...
+
+	bool delta = (m_max_deltas>0) AND
+	             (m_deltas<m_max_deltas) AND
+	             (m_snapshot_components==n.size()) AND
+	             (m_delta_bytes<m_snapshot_bytes) AND
+	             (NOT m_delta_failed.load());
+
+	trace_scope traced("checkpoint","take checkpoint","epoch",completed_epochs);
+
+	std::ostringstream s(std::ios::binary);
+	if(delta) delta = take_delta(n,completed_epochs,s);
+	if(NOT delta)
+	{
+		s.str("");
+		if(NOT take_snapshot(n,completed_epochs,s)) return false;
+	}
+
+	m_snapshot = s.str();
+	m_snapshot_is_delta = delta;
+	if(delta)
+	{
+		m_deltas++;
+		m_delta_bytes += m_snapshot.size();
+	}
+	m_missed = false;
+	start();
+
+	// ...which is written to file by a background thread.
+
+	m_busy.store(true, std::memory_order_release);
+	m_thread = std::thread(&checkpoint_writer::write_snapshot, this);
+	return true;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+bool checkpoint_writer::take_snapshot(nn REF n, int completed_epochs, std::ostream REF s)
+{
+	binary_writer w(s);
+	w.set_error_flag(n.my_error_flag());
+	if(NOT n.to_binary(w)) return false;
+
+	m_snapshot_id++;
+	m_deltas = 0;
+	m_delta_bytes = 0;
+	m_delta_failed.store(false);
+	m_snapshot_components = -1;
+	if(m_max_deltas>0)											// start tracking changes from this snapshot
+		if(n.write_changes(NULL)) m_snapshot_components = n.size();
+
+	std::vector<int> random_state = random_generator_state();
+
+	binary_checkpoint_header h;
+	memset(&h, 0, sizeof(h));
+	memcpy(h.magic, checkpoint_magic, 8);
+	h.version = NN_CHECKPOINT_VERSION;
+	h.random_state_length = (uint32_t) random_state.size();
+	h.completed_epochs = completed_epochs;
+	h.snapshot_id = m_snapshot_id;
+	h.checksum = 0;
+	uint32_t crc = crc32_update(0, &h, sizeof(h));
+	if(NOT random_state.empty()) crc = crc32_update(crc, random_state.data(), random_state.size()*sizeof(int32_t));
+	h.checksum = crc;
+
+	s.write((const char PTR) &h, sizeof(h));
+	if(NOT random_state.empty()) s.write((const char PTR) random_state.data(), random_state.size()*sizeof(int32_t));
+	if((random_state.size()%2)!=0) { int32_t padding = 0; s.write((const char PTR) &padding, sizeof(padding)); }
+
+	m_snapshot_bytes = (uint64_t) s.tellp();
+	return s.good();
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+bool checkpoint_writer::take_delta(nn REF n, int completed_epochs, std::ostream REF s)
+{
+	std::ostringstream changes(std::ios::binary);
+	binary_delta_writer w(changes);
+	w.set_error_flag(n.my_error_flag());
+	if(NOT n.write_changes(&w)) return false;					// (not possible, a full snapshot will be taken)
+
+	string payload = changes.str();
+	std::vector<int> random_state = random_generator_state();
+
+	binary_delta_record_header h;
+	memset(&h, 0, sizeof(h));
+	memcpy(h.magic, delta_magic, 8);
+	h.version = NN_CHECKPOINT_DELTA_VERSION;
+	h.snapshot_id = m_snapshot_id;
+	h.completed_epochs = completed_epochs;
+	h.random_state_length = (uint32_t) random_state.size();
+	h.number_of_components = (uint32_t) n.size();
+	h.payload_bytes = (uint64_t) payload.size();
+	h.number_of_ranges = w.number_of_ranges();
+	h.checksum = 0;
+
+	std::ostringstream state(std::ios::binary);
+	uint32_t crc = crc32_update(0, &h, sizeof(h));
+	write_random_state(state, random_state, crc);
+	h.checksum = crc32_update(crc, payload.data(), payload.size());
+
+	s.write((const char PTR) &h, sizeof(h));
+	s << state.str() << payload;
+	return s.good();
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// (background thread) write to a temporary file, then replace checkpoint
+// file with it, so that a complete checkpoint is always available (and
+// remove delta file, whose records apply to previous snapshot). A delta
+// record is appended to the delta file instead.
+
+void checkpoint_writer::write_snapshot()
+{
+	event_tracer.name_this_thread("checkpoint writer");
+	trace_scope traced("checkpoint", m_snapshot_is_delta ? "write checkpoint changes" : "write checkpoint", "bytes", (int64_t) m_snapshot.size());
+
+	if(m_snapshot_is_delta)
+	{
+		string delta_filename = checkpoint_delta_filename(m_filename);
+		std::ofstream f(delta_filename.c_str(), std::ios::binary | std::ios::app);
+		bool ok = f.good();
+		if(ok) f.write(m_snapshot.data(), (std::streamsize) m_snapshot.size());
+		f.close();
+		ok = ok AND (NOT f.fail());
+
+		if(ok)
+		{
+			m_written++;
+			m_written_deltas++;
+		}
+		else
+		{
+			m_failed++;
+			m_delta_failed.store(true);						// (next checkpoint is a full snapshot)
+			warning_queued("Checkpoint changes could not be written to file " + delta_filename);
+		}
+		m_busy.store(false, std::memory_order_release);
+		return;
+	}
+
+	string temporary_filename = m_filename + ".tmp";
+
+	std::ofstream f(temporary_filename.c_str(), std::ios::binary | std::ios::trunc);
+	bool ok = f.good();
+	if(ok) f.write(m_snapshot.data(), (std::streamsize) m_snapshot.size());
+	f.close();
+	ok = ok AND (NOT f.fail());
+
+#ifdef _WIN32
+	if(ok) std::remove(m_filename.c_str());					// (rename does not replace existing files)
+#endif
+	if(ok) ok = (std::rename(temporary_filename.c_str(), m_filename.c_str())==0);
+	if(ok) std::remove(checkpoint_delta_filename(m_filename).c_str());
+
+	if(ok)
+		m_written++;
+	else
+	{
+		m_failed++;
+		m_delta_failed.store(true);							// (next checkpoint is a full snapshot)
+		warning_queued("Checkpoint could not be written to file " + m_filename);
+	}
+
+	m_busy.store(false, std::memory_order_release);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+void checkpoint_writer::join()
+{
+	if(m_thread.joinable()) m_thread.join();
+	m_snapshot.clear();
+	m_snapshot.shrink_to_fit();
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+bool checkpoint_writer::finish()
+{
+	join();
+	if(is_main_thread()) flush_pending_messages();
+	return m_failed.load()==0;
+}
+
+/*-----------------------------------------------------------------------*/
+
+// apply (or, if apply is false, only validate) changed ranges of a delta
+// record to the stored model.
+
+static bool apply_delta_ranges(binary_model_file REF f, const unsigned char PTR p, uint64_t length, uint32_t number_of_ranges, bool apply)
+{
+	uint64_t offset = 0;
+	for(uint32_t i=0;i<number_of_ranges;i++)
+	{
+		binary_delta_range_header r;
+		if(offset + sizeof(r) > length) return false;
+		memcpy(&r, p + offset, sizeof(r));
+		offset += sizeof(r);
+
+		if((r.first<0) OR (r.count<0) OR ((uint64_t)r.count > (length - offset)/sizeof(DATA))) return false;
+
+		int64_t number_of_values = 0;
+		DATA PTR values = f.values_for_update(r.component, (binary_delta_array) r.array, number_of_values);
+		if((values==NULL) OR (r.first + r.count > number_of_values)) return false;
+
+		if(apply) memcpy(values + r.first, p + offset, (size_t) r.count * sizeof(DATA));
+		offset += padded_to_8((uint64_t) r.count * sizeof(DATA));
+	}
+	return offset==length;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// apply records of delta file (if any) made for the given snapshot, in order,
+// up to first incomplete or corrupt one. Returns number of records applied.
+
+static int apply_delta_file(binary_model_file REF f, string filename, uint32_t snapshot_id, int64_t REF completed_epochs, std::vector<int> REF random_state)
+{
+	std::ifstream s(filename.c_str(), std::ios::binary);
+	if(NOT s) return 0;
+	std::vector<unsigned char> buffer((std::istreambuf_iterator<char>(s)), std::istreambuf_iterator<char>());
+
+	int applied = 0;
+	size_t offset = 0;
+	size_t size = buffer.size();
+	const unsigned char PTR p = buffer.data();
+
+	while(offset + sizeof(binary_delta_record_header) <= size)
+	{
+		binary_delta_record_header h;
+		memcpy(&h, p + offset, sizeof(h));
+		if(memcmp(h.magic, delta_magic, 8)!=0) break;
+		if(h.version>NN_CHECKPOINT_DELTA_VERSION) break;
+
+		size_t available = size - offset - sizeof(h);
+		uint64_t random_state_bytes = padded_to_8((uint64_t) h.random_state_length * sizeof(int32_t));
+		if((random_state_bytes > available) OR (h.payload_bytes > available - random_state_bytes)) break;	// (incomplete)
+
+		const unsigned char PTR p_state = p + offset + sizeof(h);
+		const unsigned char PTR p_changes = p_state + random_state_bytes;
+
+		uint32_t stored_checksum = h.checksum;
+		h.checksum = 0;
+		uint32_t crc = crc32_update(0, &h, sizeof(h));
+		crc = crc32_update(crc, p_state, (size_t) random_state_bytes);
+		crc = crc32_update(crc, p_changes, (size_t) h.payload_bytes);
+		if(crc!=stored_checksum) break;
+
+		if(h.snapshot_id==snapshot_id)						// (otherwise left by previous snapshot)
+		{
+			if(h.number_of_components!=(uint32_t)f.number_of_components()) break;
+			if(NOT apply_delta_ranges(f, p_changes, h.payload_bytes, h.number_of_ranges, false)) break;
+			apply_delta_ranges(f, p_changes, h.payload_bytes, h.number_of_ranges, true);
+
+			completed_epochs = h.completed_epochs;
+			random_state.assign(h.random_state_length, 0);
+			if(h.random_state_length>0) memcpy(random_state.data(), p_state, (size_t) h.random_state_length * sizeof(int32_t));
+			applied++;
+		}
+		offset += sizeof(h) + (size_t) random_state_bytes + (size_t) h.payload_bytes;
+	}
+
+	if(offset<size) warning("Checkpoint delta file " + filename + " ends with incomplete or corrupt data (ignored)");
+	return applied;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+bool load_checkpoint(nn REF n, string filename, int REF completed_epochs, bool use_current_topology)
+{
+	completed_epochs = 0;
+	n.reset_error();
+
+	trace_scope traced("checkpoint","load checkpoint");
+
+	binary_model_file f;
+	f.set_error_flag(n.my_error_flag());
+	if(NOT f.open(filename,false,true)) return false;			// (writable, so that changes can be applied)
+
+	// locate and validate training state (follows the model)
+
+	size_t length = 0;
+	const unsigned char PTR p = f.data_after_model(length);
+	if((p==NULL) OR (length<sizeof(binary_checkpoint_header)) OR (memcmp(p, checkpoint_magic, 8)!=0))
+	{
+		f.error(NN_IOFILE_ERR,"Not a checkpoint file (no training state found)");
+		return false;
+	}
+
+	binary_checkpoint_header h;
+	memcpy(&h, p, sizeof(h));
+	if(h.version>NN_CHECKPOINT_VERSION) {f.error(NN_IOFILE_ERR,"Checkpoint file was created by a newer version"); return false;}
+
+	size_t random_state_bytes = (size_t) h.random_state_length * sizeof(int32_t);
+	if(sizeof(h) + random_state_bytes > length) {f.error(NN_IOFILE_ERR,"Checkpoint file is truncated"); return false;}
+
+	std::vector<int> random_state(h.random_state_length);
+	if(random_state_bytes>0) memcpy(random_state.data(), p + sizeof(h), random_state_bytes);
+
+	uint32_t stored_checksum = h.checksum;
+	h.checksum = 0;
+	uint32_t crc = crc32_update(0, &h, sizeof(h));
+	if(random_state_bytes>0) crc = crc32_update(crc, random_state.data(), random_state_bytes);
+	if(crc!=stored_checksum) {f.error(NN_IOFILE_ERR,"Checkpoint file training state is corrupt (checksum)"); return false;}
+
+	// apply changes taken after this snapshot (if any)
+
+	int64_t epochs = h.completed_epochs;
+	apply_delta_file(f, checkpoint_delta_filename(filename), h.snapshot_id, epochs, random_state);
+
+	// load model
+
+	bool ok = use_current_topology ? n.nn::from_binary_file(f) : n.from_binary_file(f);
+	if(NOT ok) return false;
+
+	if(NOT random_state.empty()) set_random_generator_state(random_state);
+	completed_epochs = (int) epochs;
+	return true;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+}   // end of namespace nnlib2
@@ -0,0 +1,147 @@
+//		----------------------------------------------------------
+//		(c)2026  Vasilis.N.Nikolaidis          All rights reserved.
+//		-----------------------------------------------------------
+//		nnlib2_checkpoint.h						Version 0.1
+//		-----------------------------------------------------------
+//		Periodic training checkpoints, so that long training can be
+//		resumed (s.a. after a crash).
+//		A checkpoint file is a binary model file (see nnlib2_binary.h,
+//		so it can also be loaded as a model) followed by the training
+//		state: a binary_checkpoint_header and the state of the random
+//		number generator (32-bit integers, padded).
+//		When a checkpoint is due, the model is serialized in memory
+//		(a copy, taken by the training thread) and written to file by
+//		a background thread, while training continues. The file is
+//		replaced only when the new one is complete. If the previous
+//		checkpoint is still being written, the new one is skipped
+//		(and retried after the next epoch) instead of waiting for it.
+//
+//		Optionally, checkpoints between full snapshots may be delta
+//		checkpoints: only the values changed since the previous
+//		checkpoint (see nn::write_changes) are appended, as a record
+//		(binary_delta_record_header, random number generator state
+//		and changed ranges, see nnlib2_binary.h), to a delta file
+//		(checkpoint filename + ".delta"). This is much less I/O for
+//		models where training changes few values (s.a. LVQ or SOM,
+//		which change only winner rows). A full snapshot (compaction)
+//		is taken after a number of deltas, when the delta file grows
+//		larger than the snapshot, if topology or sizes changed, or if
+//		a delta could not be written; the delta file is then removed.
+//		When loading, valid records (for the same snapshot) are
+//		applied in order, up to the first incomplete or corrupt one.
+//		-----------------------------------------------------------
+
+#ifndef NN_CHECKPOINT_H
+#define NN_CHECKPOINT_H
+
+#include "nnlib2.h"
+#include "nnlib2_error.h"
+#include "nn.h"
+
+#include <stdint.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+namespace nnlib2 {
+
+#define NN_CHECKPOINT_VERSION		1
+#define NN_CHECKPOINT_DELTA_VERSION	1
+
+/*-----------------------------------------------------------------------*/
+
+struct binary_checkpoint_header						// 32 bytes
+ {
+ char     magic[8];										// "NNLIB2CK"
+ uint32_t version;
+ uint32_t random_state_length;							// number of (32-bit) integers that follow
+ int64_t  completed_epochs;
+ uint32_t checksum;										// CRC32 of this header (with checksum set to 0) and random state
+ uint32_t snapshot_id;									// identifies snapshot that delta records apply to (was reserved, 0 in older files)
+ };
+
+struct binary_delta_record_header					// 48 bytes
+ {
+ char     magic[8];										// "NNLIB2DL"
+ uint32_t version;
+ uint32_t snapshot_id;									// snapshot (checkpoint file) that these changes apply to
+ int64_t  completed_epochs;
+ uint32_t random_state_length;							// number of (32-bit) integers that follow (padded)
+ uint32_t number_of_components;							// in topology (must match snapshot)
+ uint64_t payload_bytes;								// changed ranges (follow random state)
+ uint32_t number_of_ranges;
+ uint32_t checksum;										// CRC32 of this header (with checksum set to 0), random state and changes
+ };
+
+/*-----------------------------------------------------------------------*/
+
+class checkpoint_writer : public error_flag_client
+ {
+ private:
+
+ string m_filename;										// empty if checkpoints are disabled
+ int    m_every_epochs;									// checkpoint every this many epochs (0 if not used)...
+ double m_every_seconds;								// ...and/or when this many seconds passed since last one (0 if not used).
+ bool   m_missed;										// last checkpoint was skipped (retry)
+ std::chrono::steady_clock::time_point m_last_time;
+
+ std::thread m_thread;									// background writer...
+ std::atomic<bool> m_busy;								// ...is writing...
+ string m_snapshot;										// ...this (owned by the thread while busy).
+
+ bool   m_snapshot_is_delta;								// ...(a delta record, appended to delta file).
+
+ int      m_max_deltas;									// delta checkpoints allowed between full snapshots (0 if not used)
+ int      m_deltas;										// delta checkpoints since last full snapshot
+ uint32_t m_snapshot_id;								// id of last full snapshot
+ int      m_snapshot_components;							// number of components in last full snapshot (-1 if none, or changes are not tracked)
+ uint64_t m_snapshot_bytes;								// size of last full snapshot
+ uint64_t m_delta_bytes;								// size of delta records since last full snapshot
+ std::atomic<bool> m_delta_failed;						// a delta record was not written (take full snapshot)
+
+ std::atomic<int> m_written;
+ std::atomic<int> m_written_deltas;
+ std::atomic<int> m_failed;
+ int m_skipped;
+
+ bool take_snapshot(nn REF n, int completed_epochs, std::ostream REF s);	// full (model and training state)
+ bool take_delta(nn REF n, int completed_epochs, std::ostream REF s);		// changes only; false if not possible
+ void write_snapshot();									// (runs in background thread)
+
+ public:
+
+ checkpoint_writer();
+ ~checkpoint_writer();									// waits for pending checkpoint (see join)
+
+ bool setup(string filename, int every_epochs, double every_seconds);	// empty filename (or no period) disables checkpoints
+ bool enabled()            { return NOT m_filename.empty(); }
+ string filename()         { return m_filename; }
+ void set_max_deltas(int max_deltas);					// take up to this many delta checkpoints between full snapshots (0 to take only full ones)
+
+ void start();											// call when training starts (restarts timer)
+ bool is_due(int completed_epochs);
+ bool checkpoint_if_due(nn REF n, int completed_epochs);	// call after each epoch; false if no checkpoint was taken
+ bool save(nn REF n, int completed_epochs);				// take checkpoint now (written in background)
+ bool finish();											// wait for pending checkpoint and display messages; false if any failed
+ void join();											// wait for pending checkpoint only (failures stay queued, see nnlib2_error.h)
+
+ int checkpoints_written() { return m_written.load(); }		// (including deltas)
+ int deltas_written()      { return m_written_deltas.load(); }
+ int checkpoints_skipped() { return m_skipped; }
+ int checkpoints_failed()  { return m_failed.load(); }
+ };
+
+/*-----------------------------------------------------------------------*/
+// load model and training state from checkpoint file (and its delta file,
+// if any), restoring the random number generator state (if available). If use_current_topology is true,
+// components are loaded into the current topology of nn (which must have the
+// same structure), otherwise nn creates it (see nn::from_binary_file).
+
+bool load_checkpoint(nn REF n, string filename, int REF completed_epochs, bool use_current_topology = false);
+
+string checkpoint_delta_filename(string filename);		// name of delta file used with given checkpoint file
+
+}   // end of namespace nnlib2
+
+#endif // NN_CHECKPOINT_H
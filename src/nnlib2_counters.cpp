@@ -0,0 +1,36 @@
+//		----------------------------------------------------------
+//		(c)2026  Vasilis.N.Nikolaidis          All rights reserved.
+//		-----------------------------------------------------------
+//		nnlib2_counters.cpp						Version 0.1
+//		-----------------------------------------------------------
+//		process-wide hot path performance counters (see header).
+//		-----------------------------------------------------------
+
+#include "nnlib2_counters.h"
+
+namespace nnlib2 {
+
+nn_counters hot_path_counters;
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+const char PTR nn_counters::name(nn_counter c)
+{
+	switch(c)
+	{
+	case cnt_connections_visited:			return "connections_visited";
+	case cnt_multiply_adds:					return "multiply_adds";
+	case cnt_exp_evaluations:				return "exp_evaluations";
+	case cnt_dllist_allocations:			return "dllist_allocations";
+	case cnt_received_values_allocations:	return "received_values_allocations";
+	case cnt_R_callbacks:					return "R_callbacks";
+	case cnt_training_rows:					return "training_rows";
+	case cnt_training_epochs:				return "training_epochs";
+	case cnt_training_nanoseconds:			return "training_nanoseconds";
+	case cnt_last_epoch_rows:				return "last_epoch_rows";
+	case cnt_last_epoch_nanoseconds:		return "last_epoch_nanoseconds";
+	default:								return "unknown";
+	}
+}
+
+}   // end of namespace nnlib2
@@ -0,0 +1,136 @@
+//		----------------------------------------------------------
+//		(c)2026  Vasilis.N.Nikolaidis          All rights reserved.
+//		-----------------------------------------------------------
+//		nnlib2_counters.h						Version 0.1
+//		-----------------------------------------------------------
+//		Process-wide performance counters for hot paths: connections
+//		visited, multiply-adds, exp() evaluations, list node (heap)
+//		allocations, R callbacks, and rows, epochs and time spent in
+//		training loops. Counters are added once per component call
+//		(not per connection) where possible, using relaxed atomic
+//		operations, so they are cheap enough to be always on. They can
+//		be read (snapshot) and reset at any time, s.a. to spot
+//		allocation storms or R callback overhead in production. If
+//		NN_COUNTERS (nnlib2.h) is not defined, counting code is removed
+//		at compile time.
+//		-----------------------------------------------------------
+
+#ifndef NN_COUNTERS_H
+#define NN_COUNTERS_H
+
+#include "nnlib2.h"
+#include "nnlib2_trace.h"
+#include "nnlib2_progress.h"
+
+#include <stdint.h>
+#include <atomic>
+#include <chrono>
+#include <limits>
+
+namespace nnlib2 {
+
+/*-----------------------------------------------------------------------*/
+
+enum nn_counter {	cnt_connections_visited = 0,			// connections processed by encode or recall
+					cnt_multiply_adds,						// multiply-add operations in connection kernels (BP, LVQ)
+					cnt_exp_evaluations,					// exp() evaluations (sigmoid, softmax)
+					cnt_dllist_allocations,					// dllist nodes allocated (all lists)...
+					cnt_received_values_allocations,		// ...of which for values queued to PEs (pe::receive_input_value)
+					cnt_R_callbacks,						// R functions called by R components (R_layer, R_connection_matrix, aux_control_R)
+					cnt_training_rows,						// rows (cases) presented in training loops...
+					cnt_training_epochs,					// ...in this number of epochs...
+					cnt_training_nanoseconds,				// ...taking this long.
+					cnt_last_epoch_rows,					// rows in last completed training epoch...
+					cnt_last_epoch_nanoseconds,				// ...and its duration.
+					NN_NUMBER_OF_COUNTERS };
+
+/*-----------------------------------------------------------------------*/
+
+class nn_counters
+ {
+ private:
+
+ std::atomic<uint64_t> m_values[NN_NUMBER_OF_COUNTERS];
+
+ public:
+
+ nn_counters() { reset(); }
+
+ void add(nn_counter c, uint64_t n)      { m_values[c].fetch_add(n,std::memory_order_relaxed); }
+ void set(nn_counter c, uint64_t n)      { m_values[c].store(n,std::memory_order_relaxed); }
+ uint64_t value(nn_counter c)            { return m_values[c].load(std::memory_order_relaxed); }
+ void reset()                            { for(int c=0;c<NN_NUMBER_OF_COUNTERS;c++) m_values[c].store(0,std::memory_order_relaxed); }
+
+ static const char PTR name(nn_counter c);	// s.a. "connections_visited"
+ };
+
+extern nn_counters hot_path_counters;		// (process-wide, see nnlib2_counters.cpp)
+
+#ifdef NN_COUNTERS
+#define NN_COUNT(counter,n)		nnlib2::hot_path_counters.add(counter,(uint64_t)(n))
+#else
+#define NN_COUNT(counter,n)
+#endif
+
+/*-----------------------------------------------------------------------*/
+// times epochs of a training loop: create before the loop, call epoch_done
+// at the end of each epoch (also traced, see nnlib2_trace.h, and added to
+// training progress records, see nnlib2_progress.h).
+
+class epoch_counter
+ {
+ private:
+
+ std::chrono::steady_clock::time_point m_start;
+ std::chrono::steady_clock::time_point m_training_start;
+ const char PTR m_model;
+ int m_run;
+
+ public:
+
+ epoch_counter(const char PTR model)				// (static string, s.a. "BP")
+  {
+  m_start = m_training_start = std::chrono::steady_clock::now();
+  m_model = model;
+  m_run = progress_channel.new_run();
+  }
+
+ void epoch_done(int64_t rows, int completed_epochs)
+  {
+  epoch_done(rows, completed_epochs, std::numeric_limits<double>::quiet_NaN());
+  }
+
+ void epoch_done(int64_t rows, int completed_epochs, double error_level)
+  {
+  std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+  uint64_t ns = (uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(now-m_start).count();
+  m_start = now;
+#ifdef NN_COUNTERS
+  hot_path_counters.add(cnt_training_rows,(uint64_t)rows);
+  hot_path_counters.add(cnt_training_epochs,1);
+  hot_path_counters.add(cnt_training_nanoseconds,ns);
+  hot_path_counters.set(cnt_last_epoch_rows,(uint64_t)rows);
+  hot_path_counters.set(cnt_last_epoch_nanoseconds,ns);
+#endif
+  if(event_tracer.enabled())						// (traced as an event that ends now)
+   {
+   uint64_t end = event_tracer.now();
+   event_tracer.record("training","epoch","rows",rows,(end>ns)?end-ns:0,end);
+   }
+
+  progress_record p;
+  p.sequence = 0;
+  p.run = m_run;
+  p.model = m_model;
+  p.epoch = completed_epochs;
+  p.rows = rows;
+  p.error_level = error_level;
+  p.rows_per_second = (ns>0) ? (double) rows * 1e9 / (double) ns : 0;
+  p.elapsed_seconds = std::chrono::duration<double>(now-m_training_start).count();
+  progress_channel.add(p);
+  }
+ };
+
+}   // end of namespace nnlib2
+
+#endif // NN_COUNTERS_H
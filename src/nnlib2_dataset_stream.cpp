@@ -0,0 +1,685 @@
+//		----------------------------------------------------------
+//		(c)2026  Vasilis.N.Nikolaidis          All rights reserved.
+//		-----------------------------------------------------------
+//		nnlib2_dataset_stream.cpp				Version 0.1
+//		-----------------------------------------------------------
+//		Data sets read from files in chunks (see nnlib2_dataset_stream.h)
+//		-----------------------------------------------------------
+
+#include "nnlib2_dataset_stream.h"
+#include "nnlib2_misc.h"
+#include "nnlib2_trace.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+
+namespace nnlib2 {
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+bool dataset_file_format_from_name(string name, dataset_file_format REF format)
+{
+	if((name=="binary") OR (name=="bin")) { format = dataset_binary; return true; }
+	if((name=="csv") OR (name=="text"))   { format = dataset_csv;    return true; }
+	return false;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// CSV helpers
+
+static bool is_csv_separator(char c)
+{
+	return (c==',') OR (c==';') OR (c=='\t') OR (c==' ') OR (c=='\r');
+}
+
+static bool is_blank_line(const char PTR begin, const char PTR end)
+{
+	for(const char PTR p=begin;p<end;p++)
+		if(NOT is_csv_separator(*p)) return false;
+	return true;
+}
+
+// parses values in line (up to max_values, or counts them if values is NULL);
+// returns number of values found, -1 if line contains anything non-numeric.
+
+static int parse_csv_line(const char PTR begin, const char PTR end, DATA PTR values, int max_values)
+{
+	char number[64];
+	int found = 0;
+	const char PTR p = begin;
+	while(p<end)
+	{
+		while((p<end) AND is_csv_separator(*p)) p++;
+		if(p>=end) break;
+		const char PTR field = p;
+		while((p<end) AND (*p!=',') AND (*p!=';') AND (*p!='\t') AND (*p!=' ') AND (*p!='\r')) p++;
+		const char PTR field_end = p;
+		if((field_end-field>=2) AND (*field=='"') AND (*(field_end-1)=='"')) { field++; field_end--; }	// (quoted value)
+		size_t length = (size_t)(field_end-field);
+		if((length==0) OR (length>=sizeof(number))) return -1;
+		memcpy(number,field,length);
+		number[length] = 0;
+		char PTR parsed_end = NULL;
+		double v = strtod(number,&parsed_end);
+		if(parsed_end NEQL number+length) return -1;
+		if(values!=NULL)
+		{
+			if(found>=max_values) return found+1;			// (too many, caller checks count)
+			values[found] = (DATA) v;
+		}
+		found++;
+	}
+	return found;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+dataset_file::dataset_file()
+{
+	close();
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+void dataset_file::close()
+{
+	m_filename.clear();
+	m_format = dataset_binary;
+	m_cols = 0;
+	m_chunk_rows = 0;
+	m_rows = 0;
+	m_chunk_offsets.clear();
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+bool dataset_file::open(string filename, dataset_file_format format, int cols, int chunk_bytes)
+{
+	close();
+	if(chunk_bytes<=0) chunk_bytes = NN_DATASET_CHUNK_BYTES;
+	m_filename = filename;
+	m_format = format;
+	m_cols = (cols>0) ? cols : 0;
+
+	bool ok = (format==dataset_csv) ? index_csv(chunk_bytes) : index_binary(chunk_bytes);
+	if(ok AND (m_rows<=0))
+	{
+		error(NN_DATAST_ERR,"Data set file " + filename + " contains no data");
+		ok = false;
+	}
+	if(NOT ok) close();
+	return ok;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+bool dataset_file::index_binary(int chunk_bytes)
+{
+	if(m_cols<=0)
+	{
+		error(NN_DATAST_ERR,"Number of columns must be specified for binary data set files");
+		return false;
+	}
+
+	std::ifstream f(m_filename.c_str(), std::ios::in | std::ios::binary | std::ios::ate);
+	if(NOT f.is_open())
+	{
+		error(NN_IOFILE_ERR,"Cannot open data set file " + m_filename);
+		return false;
+	}
+	int64_t size = (int64_t) f.tellg();
+	int64_t row_bytes = (int64_t) m_cols * sizeof(DATA);
+	if((size<0) OR (size % row_bytes NEQL 0))
+	{
+		error(NN_DATAST_ERR,"Size of binary data set file " + m_filename + " is not a multiple of row size (check number of columns)");
+		return false;
+	}
+
+	m_rows = size / row_bytes;
+	m_chunk_rows = (int)(chunk_bytes / row_bytes);
+	if(m_chunk_rows<1) m_chunk_rows = 1;
+	for(int64_t r=0;r<m_rows;r+=m_chunk_rows)
+		m_chunk_offsets.push_back(r*row_bytes);
+	m_chunk_offsets.push_back(size);
+	return true;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// scan file once, recording where each chunk (of m_chunk_rows non-empty
+// lines) starts. Number of columns is taken from first data line.
+
+bool dataset_file::index_csv(int chunk_bytes)
+{
+	std::ifstream f(m_filename.c_str(), std::ios::in | std::ios::binary);
+	if(NOT f.is_open())
+	{
+		error(NN_IOFILE_ERR,"Cannot open data set file " + m_filename);
+		return false;
+	}
+
+	string line;
+	int64_t offset = 0;
+	bool header_skipped = false;
+	int rows_in_current = 0;
+
+	while(std::getline(f,line))
+	{
+		int64_t line_offset = offset;
+		offset += (int64_t) line.size() + 1;
+		const char PTR begin = line.data();
+		const char PTR end = begin + line.size();
+		if(is_blank_line(begin,end)) continue;
+
+		if(m_chunk_rows<=0)										// first data line, check header and number of columns
+		{
+			int found = parse_csv_line(begin,end,NULL,0);
+			if((found<0) AND (NOT header_skipped)) { header_skipped = true; continue; }
+			if(found<0)
+			{
+				error(NN_DATAST_ERR,"Data set file " + m_filename + " contains non-numeric values");
+				return false;
+			}
+			if(m_cols<=0) m_cols = found;
+			if(found NEQL m_cols)
+			{
+				error(NN_DATAST_ERR,"Data set file " + m_filename + " does not have the expected number of columns");
+				return false;
+			}
+			m_chunk_rows = (int)(chunk_bytes / ((int64_t) m_cols * sizeof(DATA)));
+			if(m_chunk_rows<1) m_chunk_rows = 1;
+		}
+
+		if(rows_in_current==0) m_chunk_offsets.push_back(line_offset);
+		rows_in_current++;
+		if(rows_in_current>=m_chunk_rows) rows_in_current = 0;
+		m_rows++;
+	}
+
+	if(f.bad())
+	{
+		error(NN_IOFILE_ERR,"Error reading data set file " + m_filename);
+		return false;
+	}
+	if(m_chunk_rows<=0) return true;						// (no data, reported by open)
+	f.clear();
+	f.seekg(0,std::ios::end);
+	int64_t size = (int64_t) f.tellg();
+	if((size>=0) AND (offset>size)) offset = size;			// (last line had no newline)
+	m_chunk_offsets.push_back(offset);
+	return true;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+int dataset_file::rows_in_chunk(int chunk)
+{
+	if((chunk<0) OR (chunk>=number_of_chunks())) return 0;
+	int64_t remaining = m_rows - (int64_t) chunk * m_chunk_rows;
+	return (remaining<m_chunk_rows) ? (int) remaining : m_chunk_rows;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+int dataset_file::read_chunk(int chunk, std::vector<DATA> REF values)
+{
+	string problem;
+	int rows = read_chunk(chunk,values,problem);
+	if(rows<0) error(NN_IOFILE_ERR,problem);
+	return rows;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+int dataset_file::read_chunk(int chunk, std::vector<DATA> REF values, string REF problem)
+{
+	if((chunk<0) OR (chunk>=number_of_chunks()))
+	{
+		problem = "Invalid chunk requested from data set file " + m_filename;
+		return -1;
+	}
+
+	int rows = rows_in_chunk(chunk);
+	int64_t first = m_chunk_offsets[chunk];
+	int64_t bytes = m_chunk_offsets[chunk+1] - first;
+	values.resize((size_t) rows * m_cols);
+
+	std::ifstream f(m_filename.c_str(), std::ios::in | std::ios::binary);	// (own stream, so chunks can be read by another thread)
+	if(NOT f.is_open())
+	{
+		problem = "Cannot open data set file " + m_filename;
+		return -1;
+	}
+	f.seekg(first);
+
+	if(m_format==dataset_binary)
+	{
+		f.read((char PTR) values.data(), (std::streamsize) bytes);
+		if(f.gcount() NEQL (std::streamsize) bytes)
+		{
+			problem = "Data set file " + m_filename + " was truncated";
+			return -1;
+		}
+		return rows;
+	}
+
+	string text((size_t) bytes, 0);
+	f.read(&text[0], (std::streamsize) bytes);
+	if(f.gcount() NEQL (std::streamsize) bytes)
+	{
+		problem = "Data set file " + m_filename + " was truncated";
+		return -1;
+	}
+
+	const char PTR p = text.data();
+	const char PTR text_end = p + text.size();
+	int r = 0;
+	while((p<text_end) AND (r<rows))
+	{
+		const char PTR line_end = (const char PTR) memchr(p,'\n',(size_t)(text_end-p));
+		if(line_end==NULL) line_end = text_end;
+		if(NOT is_blank_line(p,line_end))
+		{
+			int found = parse_csv_line(p,line_end,values.data()+(size_t) r*m_cols,m_cols);
+			if(found NEQL m_cols)
+			{
+				problem = (found<0) ? "Data set file " + m_filename + " contains non-numeric values"
+				                    : "Data set file " + m_filename + " has rows with different number of columns";
+				return -1;
+			}
+			r++;
+		}
+		p = line_end + 1;
+	}
+	if(r NEQL rows)
+	{
+		problem = "Data set file " + m_filename + " was modified while in use";
+		return -1;
+	}
+	return rows;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+dataset_stream::dataset_stream()
+{
+	m_file.set_error_flag(my_error_flag());
+	m_position = 0;
+	m_current_rows = 0;
+	m_next_rows = 0;
+	m_next_chunk = -1;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+dataset_stream::~dataset_stream()
+{
+	if(m_thread.joinable()) m_thread.join();
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+bool dataset_stream::open(string filename, dataset_file_format format, int cols, int chunk_bytes)
+{
+	close();
+	return m_file.open(filename,format,cols,chunk_bytes);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+void dataset_stream::close()
+{
+	if(m_thread.joinable()) m_thread.join();
+	m_file.close();
+	m_order.clear();
+	m_position = 0;
+	m_current.clear();
+	m_current_rows = 0;
+	m_next.clear();
+	m_next_rows = 0;
+	m_next_chunk = -1;
+	m_next_error.clear();
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+void dataset_stream::read_next()
+{
+	event_tracer.name_this_thread("data set reader");
+	trace_scope traced("data set I/O","read chunk","chunk",m_next_chunk);
+	m_next_rows = m_file.read_chunk(m_next_chunk,m_next,m_next_error);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+void dataset_stream::prefetch(int chunk)
+{
+	if(m_thread.joinable()) m_thread.join();
+	m_next_chunk = chunk;
+	m_next_rows = 0;
+	m_next_error.clear();
+	try
+	{
+		m_thread = std::thread(&dataset_stream::read_next, this);
+	}
+	catch(...)
+	{
+		read_next();											// (no thread available, read it now)
+	}
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+bool dataset_stream::wait_for_next()
+{
+	trace_scope traced("wait","wait for chunk");				// (if long, reading is slower than processing)
+	if(m_thread.joinable()) m_thread.join();
+	if(m_next_chunk<0) return false;
+	m_next_chunk = -1;
+	if(m_next_rows<0)
+	{
+		error(NN_IOFILE_ERR,m_next_error);
+		return false;
+	}
+	return true;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+void dataset_stream::start_epoch(bool shuffle)
+{
+	if(m_thread.joinable()) m_thread.join();
+	m_next_chunk = -1;
+
+	int chunks = m_file.is_open() ? m_file.number_of_chunks() : 0;
+	m_order.resize(chunks);
+	for(int i=0;i<chunks;i++) m_order[i] = i;
+	if(shuffle)
+		for(int i=chunks-1;i>0;i--)								// (Fisher-Yates, random() is called here, by main thread)
+		{
+			int j = (int) random(0,(DATA)(i+1));
+			if(j>i) j = i;
+			int t = m_order[i]; m_order[i] = m_order[j]; m_order[j] = t;
+		}
+
+	m_position = 0;
+	if(chunks>0) prefetch(m_order[0]);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+DATA PTR dataset_stream::next_chunk(int REF rows)
+{
+	rows = 0;
+	if(m_position>=(int) m_order.size()) return NULL;
+	if(NOT wait_for_next()) { m_position = (int) m_order.size(); return NULL; }
+
+	m_current.swap(m_next);
+	m_current_rows = m_next_rows;
+	m_position++;
+	if(m_position<(int) m_order.size()) prefetch(m_order[m_position]);	// (read next chunk while this one is used)
+
+	rows = m_current_rows;
+	return m_current.data();
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+dataset_file_writer::dataset_file_writer()
+{
+	m_format = dataset_binary;
+	m_cols = 0;
+	m_rows = 0;
+	mp_file = NULL;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+dataset_file_writer::~dataset_file_writer()
+{
+	string problem;											// (must not throw, so no error() here)
+	if((NOT close(problem)) AND (NOT problem.empty())) warning_queued(problem);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+bool dataset_file_writer::open(string filename, dataset_file_format format, int cols)
+{
+	close();
+	if(cols<=0)
+	{
+		error(NN_DATAST_ERR,"Invalid number of columns for data set file");
+		return false;
+	}
+	mp_file = fopen(filename.c_str(), (format==dataset_csv) ? "w" : "wb");
+	if(mp_file==NULL)
+	{
+		error(NN_IOFILE_ERR,"Cannot create data set file " + filename);
+		return false;
+	}
+	m_filename = filename;
+	m_format = format;
+	m_cols = cols;
+	m_rows = 0;
+	return true;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+bool dataset_file_writer::write_rows(const DATA PTR values, int rows)
+{
+	string problem;
+	if(write_rows(values,rows,problem)) return true;
+	error(NN_IOFILE_ERR,problem);
+	return false;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+bool dataset_file_writer::write_rows(const DATA PTR values, int rows, string REF problem)
+{
+	if(mp_file==NULL)
+	{
+		problem = "Data set file " + m_filename + " is not open for writing";
+		return false;
+	}
+	if(rows<=0) return true;
+
+	bool ok = true;
+	if(m_format==dataset_binary)
+		ok = (fwrite(values, sizeof(DATA) * m_cols, (size_t) rows, mp_file) == (size_t) rows);
+	else
+		for(int r=0;(r<rows) AND ok;r++)
+		{
+			const DATA PTR row = values + (size_t) r * m_cols;
+			for(int c=0;(c<m_cols) AND ok;c++)
+				ok = (fprintf(mp_file, (c<m_cols-1) ? "%.17g," : "%.17g\n", (double) row[c]) > 0);
+		}
+
+	if(NOT ok)
+	{
+		problem = "Error writing to data set file " + m_filename;
+		fclose(mp_file);
+		mp_file = NULL;
+		return false;
+	}
+	m_rows += rows;
+	return true;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+bool dataset_file_writer::close()
+{
+	string problem;
+	if(close(problem)) return true;
+	if(NOT problem.empty()) error(NN_IOFILE_ERR,problem);
+	return false;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+bool dataset_file_writer::close(string REF problem)
+{
+	if(mp_file==NULL) return false;							// (not open, or failed and closed already)
+	bool ok = (fclose(mp_file)==0);
+	mp_file = NULL;
+	if(NOT ok) problem = "Error writing to data set file " + m_filename;
+	return ok;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+dataset_pipeline::dataset_pipeline()
+{
+	m_output_cols = 0;
+	m_failed.store(false);
+	m_finished = true;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+dataset_pipeline::~dataset_pipeline()
+{
+	stop();
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// close queues (unblocking both threads) and wait for them
+
+void dataset_pipeline::stop()
+{
+	m_to_process.close();
+	m_to_write.close();
+	if(m_reader.joinable()) m_reader.join();
+	if(m_writer.joinable()) m_writer.join();
+	m_finished = true;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+bool dataset_pipeline::open(string input_filename, dataset_file_format format, int input_cols,
+                            string output_filename, int output_cols, int queue_chunks)
+{
+	stop();
+	m_failed.store(false);
+	m_problem.clear();
+
+	if(NOT m_input.open(input_filename,format,input_cols)) return false;
+	if(NOT m_output.open(output_filename,format,output_cols)) return false;
+	m_output_cols = output_cols;
+
+	m_to_process.reopen(queue_chunks);
+	m_to_write.reopen(queue_chunks);
+
+	m_finished = false;
+	m_reader = std::thread(&dataset_pipeline::read_chunks, this);
+	m_writer = std::thread(&dataset_pipeline::write_chunks, this);
+	return true;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+void dataset_pipeline::failed(string problem)
+{
+	std::lock_guard<std::mutex> lock(m_problem_mutex);
+	if(m_failed.load()) return;										// (keep first)
+	m_problem = problem;
+	m_failed.store(true);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+void dataset_pipeline::read_chunks()
+{
+	event_tracer.name_this_thread("pipeline reader");
+	for(int c=0;c<m_input.number_of_chunks();c++)
+	{
+		dataset_chunk chunk;
+		string problem;
+		{
+			trace_scope traced("data set I/O","read chunk","chunk",c);
+			chunk.rows = m_input.read_chunk(c,chunk.values,problem);
+		}
+		if(chunk.rows<0)
+		{
+			failed(problem);
+			break;
+		}
+		if(NOT m_to_process.push(chunk)) break;						// (closed, stopped)
+	}
+	m_to_process.close();											// (end of input)
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+void dataset_pipeline::write_chunks()
+{
+	event_tracer.name_this_thread("pipeline writer");
+	dataset_chunk chunk;
+	while(m_to_write.pop(chunk))
+	{
+		string problem;
+		trace_scope traced("data set I/O","write chunk","rows",chunk.rows);
+		if(NOT m_output.write_rows(chunk.values.data(),chunk.rows,problem))
+		{
+			failed(problem);
+			m_to_process.close();									// (stop reading too)
+			m_to_write.close();
+			return;
+		}
+	}
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+bool dataset_pipeline::next(dataset_chunk REF input)
+{
+	if(m_finished OR m_failed.load()) return false;
+	trace_scope traced("wait","wait for input chunk");				// (if long, reading is slower than processing)
+	return m_to_process.pop(input);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+bool dataset_pipeline::put(dataset_chunk REF output)
+{
+	if(m_finished OR m_failed.load()) return false;
+	if((output.rows<0) OR (output.values.size() < (size_t) output.rows * m_output_cols))
+	{
+		error(NN_DATAST_ERR,"Invalid result chunk");
+		return false;
+	}
+	trace_scope traced("wait","wait to queue results");			// (if long, writing is slower than processing)
+	return m_to_write.push(output);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+bool dataset_pipeline::finish()
+{
+	if(m_finished) return false;
+	m_to_write.close();												// (writer completes queued chunks and exits)
+	if(m_writer.joinable()) m_writer.join();
+	m_to_process.close();											// (unblocks reader, if stopped early)
+	if(m_reader.joinable()) m_reader.join();
+	m_finished = true;
+
+	string problem;
+	bool closed = m_output.close(problem);
+	if(m_failed.load())
+	{
+		error(NN_IOFILE_ERR,m_problem);
+		return false;
+	}
+	if(NOT closed)
+	{
+		error(NN_IOFILE_ERR,problem.empty() ? "Data set file was not completed" : problem);
+		return false;
+	}
+	return no_error();
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+}   // end of namespace nnlib2
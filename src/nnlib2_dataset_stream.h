@@ -0,0 +1,271 @@
+//		----------------------------------------------------------
+//		(c)2026  Vasilis.N.Nikolaidis          All rights reserved.
+//		-----------------------------------------------------------
+//		nnlib2_dataset_stream.h					Version 0.1
+//		-----------------------------------------------------------
+//		Data sets stored in files, read in chunks of rows, so that
+//		NNs can be trained on data sets larger than memory.
+//		Supported file formats:
+//		dataset_binary: DATA values (native byte order), row after
+//		                row, no header (in R, such a file can be made
+//		                by writeBin(as.vector(t(m)),filename)).
+//		dataset_csv:    text, one row per line, values separated by
+//		                commas (or semicolons, tabs or spaces). If the
+//		                first line is not numeric it is skipped (header).
+//		                Empty lines are ignored.
+//		dataset_stream reads chunks (in sequence or shuffled order)
+//		with a background thread that prefetches the next chunk
+//		while the current one is used (double buffering).
+//		dataset_file_writer writes rows (s.a. results) to a file in
+//		the same formats.
+//		dataset_pipeline is used for file-to-file batch processing
+//		(s.a. recall): a reader thread reads input chunks, the caller
+//		(main thread) processes them, and a writer thread writes the
+//		results. Stages are connected by bounded queues, so memory
+//		use is constant (a few chunks) regardless of file size.
+//		-----------------------------------------------------------
+
+#ifndef NN_DATASET_STREAM_H
+#define NN_DATASET_STREAM_H
+
+#include "nnlib2.h"
+#include "nnlib2_error.h"
+
+#include <stdint.h>
+#include <cstdio>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace nnlib2 {
+
+enum dataset_file_format {dataset_binary = 0, dataset_csv};
+
+#define NN_DATASET_CHUNK_BYTES		(4*1024*1024)		/* default (approximate) size of chunks */
+
+bool dataset_file_format_from_name(string name, dataset_file_format REF format);	// "binary" or "csv" (false if unknown)
+
+/*-----------------------------------------------------------------------*/
+// reads chunks of rows from a data set file (any chunk, in any order; may be
+// called by another thread, but not concurrently)
+
+class dataset_file : public error_flag_client
+ {
+ private:
+
+ string m_filename;
+ dataset_file_format m_format;
+ int m_cols;
+ int m_chunk_rows;
+ int64_t m_rows;
+ std::vector<int64_t> m_chunk_offsets;					// (bytes) where each chunk starts, and end of data
+
+ bool index_binary(int chunk_bytes);
+ bool index_csv(int chunk_bytes);						// locate chunks (and header, number of columns) in CSV file
+
+ public:
+
+ dataset_file();
+
+ bool open(string filename, dataset_file_format format, int cols = 0, int chunk_bytes = NN_DATASET_CHUNK_BYTES);	// cols is required for binary files (for CSV, if given, it is checked)
+ void close();
+ bool is_open()               { return m_cols>0; }
+
+ string  filename()           { return m_filename; }
+ int64_t rows()               { return m_rows; }
+ int     cols()               { return m_cols; }
+ int     chunk_rows()         { return m_chunk_rows; }
+ int     number_of_chunks()   { return (int) m_chunk_offsets.size() - 1; }
+ int     rows_in_chunk(int chunk);
+
+ int read_chunk(int chunk, std::vector<DATA> REF values);	// read chunk into values (row-major); returns number of rows, -1 if failed
+ int read_chunk(int chunk, std::vector<DATA> REF values, string REF problem);	// as above, but does not raise error (describes it in problem instead; for use by other threads)
+ };
+
+/*-----------------------------------------------------------------------*/
+// presents the chunks of a data set file for each epoch, prefetching the next
+// chunk in background while the current one is used.
+
+class dataset_stream : public error_flag_client
+ {
+ private:
+
+ dataset_file m_file;
+ std::vector<int> m_order;								// chunks, in the order they are presented in current epoch
+ int m_position;										// next chunk (position in m_order) to present
+
+ std::vector<DATA> m_current;							// chunk in use...
+ int m_current_rows;
+ std::vector<DATA> m_next;								// ...and the next one, read by background thread (owned by it while running)
+ int m_next_rows;
+ int m_next_chunk;
+ string m_next_error;
+ std::thread m_thread;
+
+ void prefetch(int chunk);
+ void read_next();										// (runs in background thread)
+ bool wait_for_next();
+
+ public:
+
+ dataset_stream();
+ ~dataset_stream();
+
+ bool open(string filename, dataset_file_format format, int cols = 0, int chunk_bytes = NN_DATASET_CHUNK_BYTES);
+ void close();
+
+ int64_t rows()               { return m_file.rows(); }
+ int     cols()               { return m_file.cols(); }
+ int     number_of_chunks()   { return m_file.number_of_chunks(); }
+
+ void start_epoch(bool shuffle = false);				// present chunks from start (shuffled, using random())
+ DATA PTR next_chunk(int REF rows);						// next chunk of current epoch (rows are contiguous, row-major); NULL at end of epoch or if failed
+ };
+
+/*-----------------------------------------------------------------------*/
+// writes rows to a data set file (CSV values are written with full precision,
+// no header)
+
+class dataset_file_writer : public error_flag_client
+ {
+ private:
+
+ string m_filename;
+ dataset_file_format m_format;
+ int m_cols;
+ int64_t m_rows;
+ FILE PTR mp_file;
+
+ public:
+
+ dataset_file_writer();
+ ~dataset_file_writer();								// closes file
+
+ bool open(string filename, dataset_file_format format, int cols);	// (replaces existing file)
+ bool write_rows(const DATA PTR values, int rows);		// (row-major)
+ bool write_rows(const DATA PTR values, int rows, string REF problem);	// as above, but does not raise error (describes it in problem instead; for use by other threads)
+ bool close();											// false if file could not be completed
+ bool close(string REF problem);
+
+ int64_t rows_written()       { return m_rows; }
+ };
+
+/*-----------------------------------------------------------------------*/
+// queue of limited capacity, for passing items between threads: push waits
+// while full, pop waits while empty. After close, push fails and pop returns
+// remaining items, then fails.
+
+template <class T>
+class bounded_queue
+ {
+ private:
+
+ std::deque<T> m_items;
+ size_t m_capacity;
+ bool m_closed;
+ std::mutex m_mutex;
+ std::condition_variable m_not_full;
+ std::condition_variable m_not_empty;
+
+ public:
+
+ bounded_queue(size_t capacity = 2) { m_capacity = (capacity<1) ? 1 : capacity; m_closed = false; }
+
+ bool push(T REF item)									// (item is moved into queue)
+  {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_not_full.wait(lock, [this]{ return m_closed OR (m_items.size()<m_capacity); });
+  if(m_closed) return false;
+  m_items.push_back(std::move(item));
+  m_not_empty.notify_one();
+  return true;
+  }
+
+ bool pop(T REF item)
+  {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_not_empty.wait(lock, [this]{ return m_closed OR (NOT m_items.empty()); });
+  if(m_items.empty()) return false;
+  item = std::move(m_items.front());
+  m_items.pop_front();
+  m_not_full.notify_one();
+  return true;
+  }
+
+ void close()
+  {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_closed = true;
+  m_not_full.notify_all();
+  m_not_empty.notify_all();
+  }
+
+ void reopen(size_t capacity)							// (empty and open again; no thread may be using it)
+  {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_items.clear();
+  m_capacity = (capacity<1) ? 1 : capacity;
+  m_closed = false;
+  }
+ };
+
+/*-----------------------------------------------------------------------*/
+
+struct dataset_chunk
+ {
+ int rows;
+ std::vector<DATA> values;								// (row-major)
+ };
+
+/*-----------------------------------------------------------------------*/
+// file-to-file batch processing: input chunks are read (in order) by a
+// background thread, and result chunks are written (in the order they are
+// put) by another. Typical use (by main thread):
+//	 if(p.open(...)) while(p.next(in)) { compute out from in; p.put(out); }
+//	 p.finish();
+
+class dataset_pipeline : public error_flag_client
+ {
+ private:
+
+ dataset_file m_input;
+ dataset_file_writer m_output;
+ int m_output_cols;
+
+ bounded_queue<dataset_chunk> m_to_process;
+ bounded_queue<dataset_chunk> m_to_write;
+ std::thread m_reader;
+ std::thread m_writer;
+ std::atomic<bool> m_failed;							// a background stage failed...
+ string m_problem;										// ...for this reason.
+ std::mutex m_problem_mutex;
+ bool m_finished;
+
+ void failed(string problem);							// (called by background threads)
+ void read_chunks();									// (runs in reader thread)
+ void write_chunks();									// (runs in writer thread)
+ void stop();
+
+ public:
+
+ dataset_pipeline();
+ ~dataset_pipeline();									// stops threads (output file may be incomplete, if finish was not called)
+
+ bool open(string input_filename, dataset_file_format format, int input_cols,
+           string output_filename, int output_cols, int queue_chunks = 2);	// input_cols is required for binary files; output is in same format
+ int input_cols()          { return m_input.cols(); }
+ int output_cols()         { return m_output_cols; }
+ int64_t rows()            { return m_input.rows(); }
+
+ bool next(dataset_chunk REF input);					// next input chunk (waits for reader); false at end of input or if failed
+ bool put(dataset_chunk REF output);					// queue result chunk (rows x output_cols) for writing; false if failed
+ bool finish();											// wait for writer to complete output file; false if anything failed
+ int64_t rows_written()    { return m_output.rows_written(); }
+ };
+
+}   // end of namespace nnlib2
+
+#endif // NN_DATASET_STREAM_H
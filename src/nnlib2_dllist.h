@@ -12,6 +12,9 @@
 //		   list. No other such nested loop should be accessing it
 //		   before the first one is completed.
 //		   In such cases the [] operator may be use to access the list.
+//		   Alternatively, use the external iterators (begin(), end()
+//		   etc, also usable in range-for loops) which do not change
+//		   mp_current and any number of which can traverse the list.
 //		-----------------------------------------------------------
 
 #ifndef NN_DLLIST_H
@@ -20,6 +23,7 @@
 #include <iostream>
 #include "nnlib2_string.h"
 #include "nnlib2_error.h"
+#include "nnlib2_counters.h"
 
 // #define DLLIST_EXTRA_INTEGRITY_CHECKS
 
@@ -37,10 +41,60 @@ class dllist : public error_flag_client
  T_wrapper PTR	mp_last;
  T_wrapper PTR	mp_current;					// warning: a single internal iterator for each instance of a list. use with care!
  int			m_number_of_items;
+ int			m_modifications;			// counts changes in list structure (items added/removed)
  T				m_junk;
 
+ // external iterator, does not use or change mp_current (so many may traverse the list at the same time).
+ // Becomes invalid if the item it points to is removed.
+
+ template <class ITEM, class NODE, bool FORWARD>
+ class _iterator
+  {
+  private:
+  NODE PTR mp_node;
+  public:
+  _iterator(NODE PTR p_node = NULL) : mp_node(p_node) {}
+  ITEM REF operator *  () const { return mp_node->item; }
+  ITEM PTR operator -> () const { return &(mp_node->item); }
+  _iterator REF operator ++ ()  { mp_node = FORWARD ? mp_node->next : mp_node->previous; return *this; }
+  _iterator operator ++ (int)   { _iterator old(*this); ++(*this); return old; }
+  bool operator == (const _iterator REF other) const { return mp_node EQL other.mp_node; }
+  bool operator != (const _iterator REF other) const { return mp_node NEQL other.mp_node; }
+  };
+
+ // range of reverse iterators (allows range-for loops from last to first item)
+
+ template <class ITERATOR>
+ class _range
+  {
+  private:
+  ITERATOR m_begin;
+  public:
+  _range(ITERATOR b) : m_begin(b) {}
+  ITERATOR begin() const { return m_begin; }
+  ITERATOR end()   const { return ITERATOR(); }
+  };
+
  public:
 
+ typedef _iterator<T,T_wrapper,true>				iterator;
+ typedef _iterator<const T,const T_wrapper,true>	const_iterator;
+ typedef _iterator<T,T_wrapper,false>				reverse_iterator;
+ typedef _iterator<const T,const T_wrapper,false>	const_reverse_iterator;
+
+ iterator begin()								{ return iterator(mp_first); }		// first item
+ iterator end()									{ return iterator(); }				// past last item
+ const_iterator begin() const					{ return const_iterator(mp_first); }
+ const_iterator end() const						{ return const_iterator(); }
+ const_iterator cbegin() const					{ return const_iterator(mp_first); }
+ const_iterator cend() const					{ return const_iterator(); }
+ reverse_iterator rbegin()						{ return reverse_iterator(mp_last); }	// last item
+ reverse_iterator rend()						{ return reverse_iterator(); }			// before first item
+ const_reverse_iterator rbegin() const			{ return const_reverse_iterator(mp_last); }
+ const_reverse_iterator rend() const			{ return const_reverse_iterator(); }
+ _range<reverse_iterator> reversed()				{ return _range<reverse_iterator>(rbegin()); }	// for(T REF x : list.reversed()) ...
+ _range<const_reverse_iterator> reversed() const	{ return _range<const_reverse_iterator>(rbegin()); }
+
  dllist();
  dllist(int number_of_items);
  dllist(const dllist<T> REF list);
@@ -64,6 +118,8 @@ class dllist : public error_flag_client
  bool remove_last();
  bool remove_current();
  int number_of_items();						// number of items in list
+ int modifications() {return m_modifications;}	// changes whenever items are added or removed (can be used to detect changes in list)
+ size_t memory_usage() {return sizeof(dllist<T>) + (size_t) m_number_of_items * sizeof(T_wrapper);}	// approximate bytes used (list and its nodes, not data allocated by items)
  int size();								// same as above
  int length();								// same as above
  bool is_empty();
@@ -86,6 +142,7 @@ class dllist : public error_flag_client
   {
   mp_first=mp_last=mp_current=NULL;
   m_number_of_items = 0;
+  m_modifications = 0;
   }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -95,6 +152,7 @@ class dllist : public error_flag_client
   {
   mp_first=mp_last=mp_current=NULL;
   m_number_of_items = 0;
+  m_modifications = 0;
 
   for (int i = 0; (no_error() AND (i<number_of_items)); i++) append();
   }
@@ -107,6 +165,7 @@ class dllist : public error_flag_client
  {
  	mp_first=mp_last=mp_current=NULL;
  	m_number_of_items = 0;
+ 	m_modifications = 0;
  	set_error_flag(list.mp_error_flag);
 
  	if(!no_error()) return;
@@ -268,12 +327,14 @@ class dllist : public error_flag_client
  template <class T>
  bool dllist<T>::append()
   {
+  m_modifications++;
   bool ok = no_error();
   if(ok)
    {
    T_wrapper PTR p_new_wrapper;
 
    ok=((p_new_wrapper = new T_wrapper) NEQL NULL);
+   NN_COUNT(cnt_dllist_allocations,1);
 
    if(ok)
     {
@@ -315,11 +376,13 @@ class dllist : public error_flag_client
  template <class T>
  bool dllist<T>::insert(int at_index, const T REF item)
   {
+  m_modifications++;
   if(NOT check()) return false;
 
   T_wrapper PTR p_new;
   p_new = new T_wrapper;
   if(p_new == NULL) return false;
+  NN_COUNT(cnt_dllist_allocations,1);
 
   p_new->item = item;
   p_new->previous=NULL;
@@ -397,6 +460,7 @@ class dllist : public error_flag_client
  template <class T>
  bool dllist<T>::remove_last()
   {
+  m_modifications++;
   bool ok = true;
 
   if(NOT goto_last())							// take mp_current at last item and check if list is not empty...
@@ -437,6 +501,7 @@ class dllist : public error_flag_client
  template <class T>
  bool dllist<T>::remove_current()
  {
+ 	m_modifications++;
  	if(mp_current==NULL)
  	{
  		error(NN_NULLPT_ERR,"dllist, can not remove current");
@@ -688,13 +753,11 @@ bool dllist<T>::append_from(const dllist<T> REF list)
   if(no_error())
    {
    s << "ListSize(elements): " << m_number_of_items << "\n";
-   if(goto_first())
-    do
+   for(T REF item : *this)
      {
-     s << i << ": " << current();
+     s << i << ": " << item;
      i++;
      }
-    while (goto_next());
    }
   }
 
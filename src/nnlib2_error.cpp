@@ -11,6 +11,7 @@
 #include <stdio.h>
 #include <string.h>
 #include "nnlib2_error.h"
+#include <thread>
 
 #ifdef NNLIB2_FOR_MFC_UI
 #include <afx.h>
@@ -44,8 +45,46 @@ static HWND get_active_window_handle()
 #endif
 
 /*-----------------------------------------------------------------------*/
+// lock-free queue for messages raised outside the main thread
+// (threads push nodes with CAS, main thread takes the entire list at once)
 
-bool error(unsigned i, string message,bool * p_error_flag)
+struct pending_message
+ {
+ bool is_error;
+ string text;
+ pending_message * next;
+ };
+
+static std::atomic<pending_message *> g_pending_messages(NULL);
+static std::atomic<bool> g_messages_pending(false);
+static const std::thread::id g_main_thread_id = std::this_thread::get_id();	// library is loaded by the main thread
+
+static void queue_message(bool is_error, const string REF text)
+{
+pending_message * p = new pending_message;
+p->is_error = is_error;
+p->text = text;
+p->next = g_pending_messages.load(std::memory_order_relaxed);
+while(NOT g_pending_messages.compare_exchange_weak(p->next,p,std::memory_order_release,std::memory_order_relaxed)) {}
+g_messages_pending.store(true,std::memory_order_release);
+}
+
+/*-----------------------------------------------------------------------*/
+
+bool is_main_thread()
+{
+return std::this_thread::get_id() == g_main_thread_id;
+}
+
+bool messages_pending()
+{
+return g_messages_pending.load(std::memory_order_acquire);
+}
+
+/*-----------------------------------------------------------------------*/
+// returns full error text and severity for given error id
+
+static int error_description(unsigned i, string REF message)
 {
 int severity;
 
@@ -103,8 +142,15 @@ switch(i)
 		  break;
  }
 
-m1 = message + " (" + m1 + ")";
+message = message + " (" + m1 + ")";
+return severity;
+}
 
+/*-----------------------------------------------------------------------*/
+// display error (main thread only)
+
+static void display_error(string m1)
+{
 bool displayed = false;
 
 #ifdef NNLIB2_FOR_MFC_UI
@@ -119,6 +165,28 @@ displayed = true;
 #endif
 
 if(!displayed) TEXTOUT << "* ERROR: "<< m1 << "\n";
+}
+
+/*-----------------------------------------------------------------------*/
+// display error or queue it (if not in main thread), return severity
+
+static int report_error(unsigned i, string message)
+{
+int severity = error_description(i,message);
+
+if(is_main_thread())
+ display_error(message);
+else
+ queue_message(true,message);
+
+return severity;
+}
+
+/*-----------------------------------------------------------------------*/
+
+bool error(unsigned i, string message,bool * p_error_flag)
+{
+int severity = report_error(i,message);
 
 if (p_error_flag NEQL NULL)
  {
@@ -136,8 +204,30 @@ return false;
 
 /*-----------------------------------------------------------------------*/
 
+bool error(unsigned i, string message,error_flag_t * p_error_flag)
+{
+int severity = report_error(i,message);
+
+if (p_error_flag NEQL NULL)
+ {
+ if (severity>1) p_error_flag->store(true);
+ return p_error_flag->load();
+ }
+
+if (severity>1) return true;
+return false;
+}
+
+/*-----------------------------------------------------------------------*/
+
 void warning(string message)
 {
+if(NOT is_main_thread())
+	{
+	queue_message(false,message);
+	return;
+	}
+
 #ifdef NNLIB2_FOR_MFC_UI
 	const char * msg_str = message.c_str();
     MessageBox(get_active_window_handle(),msg_str,"Neural Network Library Warning",MB_APPLMODAL|MB_OK|MB_ICONEXCLAMATION );
@@ -153,14 +243,73 @@ void warning(string message)
 TEXTOUT << "* WARNING: "<< message << "\n";
 }
 
+/*-----------------------------------------------------------------------*/
+// queue warning, to be displayed by flush_pending_messages(), also when
+// in main thread (R must not be called from destructors, it may throw).
+
+void warning_queued(string message)
+{
+queue_message(false,message);
+}
+
+/*-----------------------------------------------------------------------*/
+
 void warning_modal(string message)
 {
 #ifdef NNLIB2_FOR_MFC_UI
+	if(is_main_thread())
+	{
 	const char * msg_str = message.c_str();
     MessageBox(get_active_window_handle(),msg_str,"Neural Network Library Warning",MB_SYSTEMMODAL|MB_OK|MB_ICONEXCLAMATION );
-#else
-    warning(message);
+	return;
+	}
 #endif
+    warning(message);
+}
+
+/*-----------------------------------------------------------------------*/
+// display messages queued by other threads (in the order they were raised).
+// If errors were queued, all are printed and the first is also displayed
+// as an error (in R this stops execution).
+
+void flush_pending_messages()
+{
+if(NOT is_main_thread()) return;
+if(NOT messages_pending()) return;
+
+g_messages_pending.store(false);
+pending_message * p = g_pending_messages.exchange(NULL,std::memory_order_acquire);
+
+pending_message * p_fifo = NULL;							// reverse to original order
+while(p!=NULL)
+ {
+ pending_message * p_next = p->next;
+ p->next = p_fifo;
+ p_fifo = p;
+ p = p_next;
+ }
+
+string first_error;
+int num_errors = 0;
+
+while(p_fifo!=NULL)
+ {
+ pending_message * p_next = p_fifo->next;
+ if(p_fifo->is_error)
+  {
+  if(num_errors==0) first_error = p_fifo->text;
+  else TEXTOUT << "* ERROR: "<< p_fifo->text << "\n";
+  num_errors++;
+  }
+ else
+  warning(p_fifo->text);
+ delete p_fifo;
+ p_fifo = p_next;
+ }
+
+if(num_errors>0) display_error(first_error);
 }
 
+/*-----------------------------------------------------------------------*/
+
 }   // end of namespace nnlib2
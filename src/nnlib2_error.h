@@ -10,6 +10,7 @@
 #define NN_ERROR_H
 
 #include "nnlib2.h"
+#include <atomic>
 
 namespace nnlib2 {
 
@@ -23,10 +24,27 @@ namespace nnlib2 {
 #define NN_USRABR_ERR	8								/* user aborted           */
 #define NN_METHOD_ERR	9								/* method failed          */
 
+/*-----------------------------------------------------------------------*/
+// the error flag shared by a nn and its components. It is atomic so that
+// components processed in parallel can raise (or test) it without racing.
+
+typedef std::atomic<bool> error_flag_t;
+
 extern bool error(unsigned id, string message,bool * p_error_flag=NULL);
+extern bool error(unsigned id, string message,error_flag_t * p_error_flag);
 extern void warning(string message);
 extern void warning_modal(string message);
 
+/*-----------------------------------------------------------------------*/
+// Errors and warnings raised by threads other than the main one are not
+// sent to TEXTOUT (or R) directly, but queued (lock-free) and displayed
+// later, when the main thread calls flush_pending_messages().
+
+extern bool is_main_thread();
+extern bool messages_pending();							// cheap (atomic) check
+extern void flush_pending_messages();					// call from main thread only
+extern void warning_queued(string message);				// queue warning even in main thread (for destructors)
+
 /*-----------------------------------------------------------------------*/
 // true in m_error_flag means there is a runtime error.
 //
@@ -37,11 +55,13 @@ extern void warning_modal(string message);
 class error_flag_server
  {
  public:
- bool m_error_flag;
- bool * my_error_flag() { return &m_error_flag;}
+ error_flag_t m_error_flag;
+ error_flag_t * my_error_flag() { return &m_error_flag;}
  error_flag_server()    { reset_error(); };
- void reset_error()     { m_error_flag=false; };
- bool no_error()        { return NOT m_error_flag; };
+ error_flag_server(const error_flag_server REF other) { m_error_flag.store(other.m_error_flag.load()); };
+ error_flag_server REF operator= (const error_flag_server REF other) { m_error_flag.store(other.m_error_flag.load()); return *this; };
+ void reset_error()     { m_error_flag.store(false,std::memory_order_relaxed); };
+ bool no_error()        { return NOT m_error_flag.load(std::memory_order_relaxed); };
  };
 
 /*-----------------------------------------------------------------------*/
@@ -50,18 +70,38 @@ class error_flag_client
  {
  protected:
 
- bool m_local_error_flag;					// local error flag, used when no error dependancy exists.
- bool * mp_error_flag;						// actual flag is in (related) error_flag_server
+ error_flag_t m_local_error_flag;			// local error flag, used when no error dependancy exists.
+ error_flag_t * mp_error_flag;				// actual flag is in (related) error_flag_server
 
  public:
 
- error_flag_client(bool * p_error_flag=NULL)
+ error_flag_client(error_flag_t * p_error_flag=NULL)
   {
-  m_local_error_flag = false;
+  m_local_error_flag.store(false);
   set_error_flag(p_error_flag);
   };
 
- void set_error_flag(bool * p_error_flag)
+ error_flag_client(const error_flag_client REF other)	// note: copies share the same (server) flag, if any.
+  {
+  m_local_error_flag.store(other.m_local_error_flag.load());
+  if(other.mp_error_flag == &other.m_local_error_flag)
+   mp_error_flag=&m_local_error_flag;
+  else
+   mp_error_flag=other.mp_error_flag;
+  };
+
+ error_flag_client REF operator= (const error_flag_client REF other)
+  {
+  if(this == &other) return *this;
+  m_local_error_flag.store(other.m_local_error_flag.load());
+  if(other.mp_error_flag == &other.m_local_error_flag)
+   mp_error_flag=&m_local_error_flag;
+  else
+   mp_error_flag=other.mp_error_flag;
+  return *this;
+  };
+
+ void set_error_flag(error_flag_t * p_error_flag)
   {
   if(p_error_flag==NULL)
    mp_error_flag=&m_local_error_flag;
@@ -81,12 +121,12 @@ class error_flag_client
 
  void reset_error()
   {
-  if (mp_error_flag != NULL) *mp_error_flag=false;
+  if (mp_error_flag != NULL) mp_error_flag->store(false,std::memory_order_relaxed);
   };
 
- bool no_error() { return ((* mp_error_flag) EQL false); };
+ bool no_error() { return NOT mp_error_flag->load(std::memory_order_relaxed); };	// a single relaxed atomic load, cheap enough for inner loops
 
- bool * my_error_flag () {return mp_error_flag;};
+ error_flag_t * my_error_flag () {return mp_error_flag;};
 
  };
 
@@ -8,9 +8,20 @@
 
 #include "nnlib2.h"
 #include "nnlib2_error.h"
+#include "nnlib2_memory.h"
 
 #include <stdlib.h>
 
+#if !defined(_WIN32)
+#define NN_DISK_MATRIX_USE_MMAP
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#define NN_DISK_MATRIX_BLOCK_BYTES	(1024*1024)
+
 namespace nnlib2 {
 
 /*--------------------------------------------------------------------*/
@@ -22,13 +33,13 @@ int i,j;
 bool noerror = true;
 
 if((dp=(DATA**)malloc(sizeof(DATA *) * r))==NULL)
- error(NN_MEMORY_ERR,"No memory for pointers to rows.",NULL);
+ error(NN_MEMORY_ERR,"No memory for pointers to rows.");
 else
  for(i=0;((i<r)&&(noerror));i++)
   {
   if((dp[i]=(DATA*)malloc(sizeof(DATA) * c))==NULL)
    {
-   error(NN_MEMORY_ERR,"No memory for rows.",NULL);
+   error(NN_MEMORY_ERR,"No memory for rows.");
    for(j=0;j<i;j++) free(dp[j]);
    free(dp);
    dp=NULL;
@@ -53,11 +64,163 @@ if(dp!=NULL)
  for(i=r-1;i>=0;i--)
  if (dp[i]!=NULL) free(dp[i]);
  else
-  error(NN_NULLPT_ERR,"Cannot free null pointer",NULL);
+  error(NN_NULLPT_ERR,"Cannot free null pointer");
  free(dp);
  }
  else
- error(NN_NULLPT_ERR,"Cannot free null pointer",NULL);
+ error(NN_NULLPT_ERR,"Cannot free null pointer");
+}
+
+/*--------------------------------------------------------------------*/
+/* disk_matrix                                                        */
+/*--------------------------------------------------------------------*/
+
+disk_matrix::disk_matrix()
+{
+mp_mapping = NULL;
+m_size = 0;
+m_rows = 0;
+m_cols = 0;
+m_rows_per_block = 1;
+mp_rows = NULL;
+}
+
+/*--------------------------------------------------------------------*/
+
+disk_matrix::~disk_matrix()
+{
+close();
+}
+
+/*--------------------------------------------------------------------*/
+
+DATA ** disk_matrix::create(std::string filename, int r, int c)
+{
+close();
+
+if((r<=0)||(c<=0)) {error(NN_INTEGR_ERR,"Invalid disk matrix size");return NULL;}
+
+#ifdef NN_DISK_MATRIX_USE_MMAP
+
+size_t row_bytes = sizeof(DATA) * (size_t) c;
+size_t size = row_bytes * (size_t) r;
+
+int fd = ::open(filename.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+if(fd<0) {error(NN_IOFILE_ERR,"Cannot create file for disk matrix");return NULL;}
+
+if(ftruncate(fd,(off_t)size)!=0)					// (file is filled with zeros)
+ {
+ ::close(fd);
+ error(NN_IOFILE_ERR,"Cannot allocate disk space for disk matrix");
+ return NULL;
+ }
+
+void PTR p = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+::close(fd);										// (mapping remains valid)
+if(p==MAP_FAILED) {error(NN_MEMORY_ERR,"Cannot map disk matrix file");return NULL;}
+
+if((mp_rows=(DATA**)malloc(sizeof(DATA *) * r))==NULL)
+ {
+ munmap(p,size);
+ error(NN_MEMORY_ERR,"No memory for pointers to rows.");
+ return NULL;
+ }
+
+for(int i=0;i<r;i++) mp_rows[i] = (DATA PTR)((char PTR)p + row_bytes * i);
+
+madvise(p, size, MADV_SEQUENTIAL);					// rows are usually processed in order
+
+mp_mapping = p;
+m_size = size;
+m_rows = r;
+m_cols = c;
+m_rows_per_block = (int)(NN_DISK_MATRIX_BLOCK_BYTES / row_bytes);
+if(m_rows_per_block<1) m_rows_per_block = 1;
+
+return mp_rows;
+
+#else
+
+error(NN_SYSTEM_ERR,"Disk matrices are not supported on this system");
+return NULL;
+
+#endif
+}
+
+/*--------------------------------------------------------------------*/
+
+void disk_matrix::close()
+{
+#ifdef NN_DISK_MATRIX_USE_MMAP
+if(mp_mapping!=NULL)
+ {
+ msync(mp_mapping, m_size, MS_SYNC);
+ munmap(mp_mapping, m_size);
+ }
+#endif
+if(mp_rows!=NULL) free(mp_rows);
+mp_mapping = NULL;
+mp_rows = NULL;
+m_size = 0;
+m_rows = 0;
+m_cols = 0;
+}
+
+/*--------------------------------------------------------------------*/
+// (ranges are clipped, and extended to whole pages as required by madvise/msync)
+
+void disk_matrix::advise_rows(int first_row, int number_of_rows, bool will_need)
+{
+#ifdef NN_DISK_MATRIX_USE_MMAP
+if(mp_mapping==NULL) return;
+if(first_row<0) { number_of_rows += first_row; first_row = 0; }
+if(first_row+number_of_rows>m_rows) number_of_rows = m_rows-first_row;
+if(number_of_rows<=0) return;
+
+size_t page = (size_t) sysconf(_SC_PAGESIZE);
+size_t begin = sizeof(DATA) * (size_t) m_cols * (size_t) first_row;
+size_t end = begin + sizeof(DATA) * (size_t) m_cols * (size_t) number_of_rows;
+begin = (begin / page) * page;
+
+char PTR p = (char PTR) mp_mapping + begin;
+if(will_need) madvise(p, end-begin, MADV_WILLNEED);
+else          msync(p, end-begin, MS_ASYNC);
+#endif
+}
+
+/*--------------------------------------------------------------------*/
+
+void disk_matrix::prefetch_rows(int first_row, int number_of_rows)
+{
+advise_rows(first_row,number_of_rows,true);
+}
+
+/*--------------------------------------------------------------------*/
+
+void disk_matrix::write_back_rows(int first_row, int number_of_rows)
+{
+advise_rows(first_row,number_of_rows,false);
+}
+
+/*--------------------------------------------------------------------*/
+
+void disk_matrix::row_access_hint(int row, bool writing)
+{
+if((row % m_rows_per_block) NEQL 0) return;
+prefetch_rows(row+m_rows_per_block,m_rows_per_block);
+if(writing) write_back_rows(row-m_rows_per_block,m_rows_per_block);
+}
+
+/*--------------------------------------------------------------------*/
+
+bool disk_matrix::sync()
+{
+#ifdef NN_DISK_MATRIX_USE_MMAP
+if(mp_mapping==NULL) return false;
+return msync(mp_mapping, m_size, MS_SYNC)==0;
+#else
+return false;
+#endif
 }
 
 /*--------------------------------------------------------------------*/
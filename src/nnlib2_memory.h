@@ -11,11 +11,50 @@
 
 #include "nnlib2.h"
 
+#include <string>
+#include <stddef.h>
+
 namespace nnlib2 {
 
 DATA ** malloc_2d (int r, int c);
 void free_2d (DATA ** dp, int r);
 
+/*--------------------------------------------------------------------*/
+// a 2-d matrix stored in a (memory-mapped) disk file, for matrices that
+// may be larger than available memory. Rows are contiguous in the file
+// (row-major, raw DATA values) and the OS loads and writes them back as
+// needed; row-block hints may be given to help it do so efficiently.
+// Note: not available on all systems (currently not on MS-Windows).
+
+class disk_matrix
+ {
+ private:
+
+ void PTR mp_mapping;
+ size_t m_size;
+ int m_rows;
+ int m_cols;
+ int m_rows_per_block;								// rows in a block (about 1MB) used by hints
+ DATA ** mp_rows;
+
+ void advise_rows(int first_row, int number_of_rows, bool will_need);
+
+ public:
+
+ disk_matrix();
+ ~disk_matrix();
+
+ DATA ** create(std::string filename, int r, int c);	// create (or overwrite) file and map it; returns pointers to rows (values are 0), or NULL if failed.
+ void close();										// write back changes and unmap.
+ bool is_open()			{ return mp_rows!=NULL; }
+ int  rows_per_block()	{ return m_rows_per_block; }
+
+ void prefetch_rows(int first_row, int number_of_rows);		// hint: rows will be needed soon
+ void write_back_rows(int first_row, int number_of_rows);	// hint: rows were changed, start writing them to disk
+ void row_access_hint(int row, bool writing);				// called when processing rows in order: at the start of a block, prefetches next block (and writes back previous one if writing)
+ bool sync();												// write all changes to disk (waits)
+ };
+
 } // end of namespace nnlib2
 
 #endif // NN_MEMORY_H
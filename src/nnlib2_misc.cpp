@@ -11,6 +11,8 @@
 
 #include "nnlib2.h"
 #include "nnlib2_vector.h"
+#include "nnlib2_misc.h"
+#include "nnlib2_error.h"
 
 namespace nnlib2 {
 
@@ -25,6 +27,34 @@ DATA random (DATA min, DATA max)
 	return r;
 	}
 
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// R keeps the generator state in .Random.seed (updated by PutRNGstate).
+// Call from main thread only (other threads, s.a. background training, get
+// an empty state).
+
+std::vector<int> random_generator_state()
+	{
+	std::vector<int> state;
+	if(NOT is_main_thread()) return state;
+	PutRNGstate();
+	Rcpp::Environment global_env = Rcpp::Environment::global_env();
+	if(global_env.exists(".Random.seed"))
+		{
+		Rcpp::IntegerVector seed = global_env[".Random.seed"];
+		state.assign(seed.begin(),seed.end());
+		}
+	return state;
+	}
+
+bool set_random_generator_state(const std::vector<int> REF state)
+	{
+	if(state.empty()) return false;
+	Rcpp::Environment global_env = Rcpp::Environment::global_env();
+	global_env.assign(".Random.seed",Rcpp::IntegerVector(state.begin(),state.end()));
+	GetRNGstate();
+	return true;
+	}
+
 #else // not NNLIB2_FOR_RCPP
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -61,6 +91,19 @@ DATA random (DATA min, DATA max)
 	return (DATA) r;
 }
 
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// (state of rand() is not accessible)
+
+std::vector<int> random_generator_state()
+{
+	return std::vector<int>();
+}
+
+bool set_random_generator_state(const std::vector<int> REF state)
+{
+	return false;
+}
+
 #endif // NNLIB2_FOR_RCPP
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
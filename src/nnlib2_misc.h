@@ -10,10 +10,13 @@
 #define NN_MISC_H
 
 #include "nnlib2.h"
+#include <vector>
 
 namespace nnlib2 {
 
 DATA random (DATA min, DATA max);
+std::vector<int> random_generator_state();						// state of generator used by random() (for R, its .Random.seed), empty if not available
+bool set_random_generator_state(const std::vector<int> REF state);	// restore state (as returned above), false if not possible
 int winner_takes_all(DATA * vec, int vec_dim, bool find_max=true);
 int which_max(DATA * vec, int vec_dim);
 int which_min(DATA * vec, int vec_dim);
@@ -0,0 +1,133 @@
+//		----------------------------------------------------------
+//		(c)2026  Vasilis.N.Nikolaidis          All rights reserved.
+//		-----------------------------------------------------------
+//		nnlib2_profiler.h						Version 0.1
+//		-----------------------------------------------------------
+//		Opt-in per-component timing profiler. When enabled, each
+//		encode or recall of a component in a nn topology records the
+//		call count, cumulative and maximum wall time, and the number
+//		of items (PEs or connections) processed, per topology index.
+//		When disabled, the cost is a single relaxed atomic load per
+//		component call. If NN_PROFILING (nnlib2.h) is not defined,
+//		profiling code is removed at compile time.
+//		-----------------------------------------------------------
+
+#ifndef NN_PROFILER_H
+#define NN_PROFILER_H
+
+#include "nnlib2.h"
+
+#include <stdint.h>
+#include <atomic>
+#include <chrono>
+#include <vector>
+
+namespace nnlib2 {
+
+/*-----------------------------------------------------------------------*/
+
+struct component_profile
+ {
+ uint64_t encode_calls;
+ uint64_t encode_nanoseconds;
+ uint64_t encode_max_nanoseconds;
+ uint64_t recall_calls;
+ uint64_t recall_nanoseconds;
+ uint64_t recall_max_nanoseconds;
+ uint64_t items_processed;								// PEs (layers) or connections (sets) processed, in all calls
+ };
+
+/*-----------------------------------------------------------------------*/
+
+class nn_profiler
+ {
+ private:
+
+ std::atomic<bool> m_enabled;
+ std::vector<component_profile> m_records;				// (by topology index)
+
+ public:
+
+ nn_profiler()                                     { m_enabled.store(false); }
+ nn_profiler(const nn_profiler REF other)          { m_enabled.store(other.m_enabled.load()); m_records = other.m_records; }
+ nn_profiler REF operator= (const nn_profiler REF other) { m_enabled.store(other.m_enabled.load()); m_records = other.m_records; return *this; }
+
+#ifdef NN_PROFILING
+ bool enabled()                                    { return m_enabled.load(std::memory_order_relaxed); }
+#else
+ bool enabled()                                    { return false; }
+#endif
+ void enable(bool on)                              { m_enabled.store(on); }
+ void reset()                                      { m_records.clear(); }
+
+ int number_of_records()                           { return (int) m_records.size(); }
+ component_profile record(int index)				// (zeros if nothing was recorded)
+  {
+  component_profile p = {0,0,0,0,0,0,0};
+  if((index>=0) AND (index<(int) m_records.size())) p = m_records[index];
+  return p;
+  }
+
+ void add(int index, bool is_encode, uint64_t nanoseconds, int items)
+  {
+  if(index<0) return;
+  if(index>=(int) m_records.size())
+   {
+   component_profile empty = {0,0,0,0,0,0,0};
+   m_records.resize(index+1,empty);
+   }
+  component_profile REF p = m_records[index];
+  if(is_encode)
+   {
+   p.encode_calls++;
+   p.encode_nanoseconds += nanoseconds;
+   if(nanoseconds>p.encode_max_nanoseconds) p.encode_max_nanoseconds = nanoseconds;
+   }
+  else
+   {
+   p.recall_calls++;
+   p.recall_nanoseconds += nanoseconds;
+   if(nanoseconds>p.recall_max_nanoseconds) p.recall_max_nanoseconds = nanoseconds;
+   }
+  if(items>0) p.items_processed += (uint64_t) items;
+  }
+ };
+
+/*-----------------------------------------------------------------------*/
+// times a scope (s.a. a component's encode or recall) if profiler is enabled:
+//	{ profile_scope s(profiler, index, true, items); component.encode(); }
+
+class profile_scope
+ {
+ private:
+
+ nn_profiler PTR mp_profiler;							// NULL if not profiling
+ int  m_index;
+ bool m_is_encode;
+ int  m_items;
+ std::chrono::steady_clock::time_point m_start;
+
+ public:
+
+ profile_scope(nn_profiler REF profiler, int index, bool is_encode, int items)
+  {
+  mp_profiler = NULL;
+  if(NOT profiler.enabled()) return;
+  mp_profiler = &profiler;
+  m_index = index;
+  m_is_encode = is_encode;
+  m_items = items;
+  m_start = std::chrono::steady_clock::now();
+  }
+
+ ~profile_scope()
+  {
+  if(mp_profiler==NULL) return;
+  std::chrono::nanoseconds elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_start);
+  mp_profiler->add(m_index, m_is_encode, (uint64_t) elapsed.count(), m_items);
+  }
+ };
+
+}   // end of namespace nnlib2
+
+#endif // NN_PROFILER_H
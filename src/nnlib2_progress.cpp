@@ -0,0 +1,75 @@
+//		----------------------------------------------------------
+//		(c)2026  Vasilis.N.Nikolaidis          All rights reserved.
+//		-----------------------------------------------------------
+//		nnlib2_progress.cpp						Version 0.1
+//		-----------------------------------------------------------
+//		process-wide training progress records (see header).
+//		-----------------------------------------------------------
+
+#include "nnlib2_progress.h"
+
+namespace nnlib2 {
+
+training_progress progress_channel;
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+training_progress::training_progress()
+{
+	m_added = 0;
+	m_first_kept = 1;
+	m_runs.store(0);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+void training_progress::add(progress_record record)
+{
+	std::lock_guard<std::mutex> lock(m_lock);
+	if(m_records.empty())
+	{
+		try { m_records.resize(NN_PROGRESS_RECORDS); }
+		catch(...) { m_records.clear(); return; }				// (no memory, not recorded)
+	}
+	m_added++;
+	record.sequence = m_added;
+	m_records[(size_t)((m_added-1) % m_records.size())] = record;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+std::vector<progress_record> training_progress::records_after(uint64_t sequence)
+{
+	std::lock_guard<std::mutex> lock(m_lock);
+	std::vector<progress_record> records;
+	if(m_records.empty()) return records;
+
+	uint64_t first = sequence + 1;
+	uint64_t size = (uint64_t) m_records.size();
+	if(m_added>size AND first<=m_added-size) first = m_added-size+1;	// (older ones were overwritten)
+	if(first<m_first_kept) first = m_first_kept;
+	for(uint64_t s=first;s<=m_added;s++)
+		records.push_back(m_records[(size_t)((s-1) % size)]);
+	return records;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+uint64_t training_progress::last_sequence()
+{
+	std::lock_guard<std::mutex> lock(m_lock);
+	return m_added;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// discard records (sequence numbers continue, so pollers are not confused)
+
+void training_progress::reset()
+{
+	std::lock_guard<std::mutex> lock(m_lock);
+	m_records.clear();
+	m_records.shrink_to_fit();
+	m_first_kept = m_added+1;
+}
+
+}   // end of namespace nnlib2
@@ -0,0 +1,101 @@
+//		----------------------------------------------------------
+//		(c)2026  Vasilis.N.Nikolaidis          All rights reserved.
+//		-----------------------------------------------------------
+//		nnlib2_progress.h						Version 0.1
+//		-----------------------------------------------------------
+//		Structured training progress. Training loops add a record per
+//		epoch (epoch, error level, rows per second, elapsed time) to a
+//		process-wide ring buffer, which can be polled (s.a. from R, or
+//		by another thread) instead of (or in addition to) printing
+//		progress lines. Also, a timer for periodic checks (s.a. for
+//		user interrupts) driven by elapsed time rather than epochs.
+//		-----------------------------------------------------------
+
+#ifndef NN_PROGRESS_H
+#define NN_PROGRESS_H
+
+#include "nnlib2.h"
+
+#include <stdint.h>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <vector>
+
+#define NN_PROGRESS_RECORDS				1024		// records kept (older are overwritten)
+#define NN_INTERRUPT_CHECK_SECONDS		0.2			// suggested interval for user interrupt checks in training loops
+
+namespace nnlib2 {
+
+/*-----------------------------------------------------------------------*/
+
+struct progress_record
+ {
+ uint64_t sequence;								// 1, 2, ... (to poll for new records)
+ int run;										// training loop (run) that added it...
+ const char PTR model;							// ...for this model (static string, s.a. "BP")
+ int epoch;										// epochs completed
+ int64_t rows;									// rows presented in epoch
+ double error_level;							// mean error in epoch (NaN if not available)
+ double rows_per_second;						// in epoch
+ double elapsed_seconds;						// since training (run) started
+ };
+
+/*-----------------------------------------------------------------------*/
+
+class training_progress
+ {
+ private:
+
+ std::mutex m_lock;										// (taken once per epoch, and when polled)
+ std::vector<progress_record> m_records;				// ring
+ uint64_t m_added;
+ uint64_t m_first_kept;									// (sequence of first record after reset)
+ std::atomic<int> m_runs;
+
+ public:
+
+ training_progress();
+
+ int new_run()                                     { return ++m_runs; }	// (called when a training loop starts)
+ void add(progress_record record);						// sequence is set here
+ std::vector<progress_record> records_after(uint64_t sequence);	// records (still kept) added after given sequence number, oldest first
+ uint64_t last_sequence();
+ void reset();
+ };
+
+extern training_progress progress_channel;				// (process-wide, see nnlib2_progress.cpp)
+
+/*-----------------------------------------------------------------------*/
+// true (and restarts) when given interval has passed since last time it
+// was true (or timer creation):
+//	interval_timer checks(NN_INTERRUPT_CHECK_SECONDS);
+//	for(...) { ... if(checks.due()) checkUserInterrupt(); }
+
+class interval_timer
+ {
+ private:
+
+ std::chrono::steady_clock::duration m_interval;
+ std::chrono::steady_clock::time_point m_next;
+
+ public:
+
+ interval_timer(double seconds)
+  {
+  m_interval = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(seconds));
+  m_next = std::chrono::steady_clock::now() + m_interval;
+  }
+
+ bool due()
+  {
+  std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+  if(now<m_next) return false;
+  m_next = now + m_interval;
+  return true;
+  }
+ };
+
+}   // end of namespace nnlib2
+
+#endif // NN_PROGRESS_H
@@ -0,0 +1,154 @@
+//		----------------------------------------------------------
+//		(c)2026  Vasilis.N.Nikolaidis          All rights reserved.
+//		-----------------------------------------------------------
+//		nnlib2_snapshot.cpp						Version 0.1
+//		-----------------------------------------------------------
+//		versioned model snapshots (see header).
+//		-----------------------------------------------------------
+
+#include "nnlib2_snapshot.h"
+
+namespace nnlib2 {
+
+/*-----------------------------------------------------------------------*/
+// hazard pointer slots (process-wide): a reader claims a free slot and
+// stores in it the snapshot it uses; the publisher does not delete
+// snapshots found in any slot.
+
+static std::atomic<bool> slot_in_use[NN_SNAPSHOT_READER_SLOTS];
+static std::atomic<const model_snapshot PTR> slot_snapshot[NN_SNAPSHOT_READER_SLOTS];
+
+static thread_local int next_slot_to_try = 0;					// (so threads usually find their previous slot free)
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+static int claim_slot()
+{
+	for(int n=0;n<NN_SNAPSHOT_READER_SLOTS;n++)
+	{
+		int i = (next_slot_to_try + n) % NN_SNAPSHOT_READER_SLOTS;
+		if(slot_in_use[i].load(std::memory_order_relaxed)) continue;
+		if(slot_in_use[i].exchange(true, std::memory_order_acquire)) continue;
+		next_slot_to_try = i;
+		return i;
+	}
+	return -1;
+}
+
+/*-----------------------------------------------------------------------*/
+
+snapshot_publisher::snapshot_publisher()
+{
+	m_current.store(NULL);
+	m_last_version.store(0);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+snapshot_publisher::~snapshot_publisher()
+{
+	std::lock_guard<std::mutex> lock(m_publish_lock);
+	delete m_current.exchange(NULL);
+	for(size_t i=0;i<m_retired.size();i++) delete m_retired[i];
+	m_retired.clear();
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+uint64_t snapshot_publisher::publish(model_snapshot PTR snapshot)
+{
+	if(snapshot==NULL) return 0;
+
+	std::lock_guard<std::mutex> lock(m_publish_lock);
+	snapshot->m_version = ++m_last_version;
+	model_snapshot PTR replaced = m_current.exchange(snapshot);	// (readers see the new one from now on)
+	if(replaced!=NULL) m_retired.push_back(replaced);
+	reclaim();
+	return snapshot->m_version;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+void snapshot_publisher::clear()
+{
+	std::lock_guard<std::mutex> lock(m_publish_lock);
+	model_snapshot PTR replaced = m_current.exchange(NULL);
+	if(replaced!=NULL) m_retired.push_back(replaced);
+	reclaim();
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+uint64_t snapshot_publisher::current_version()
+{
+	snapshot_reader r(*this);
+	return (r.get()==NULL) ? 0 : r.get()->version();
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+int snapshot_publisher::pending_reclamation()
+{
+	std::lock_guard<std::mutex> lock(m_publish_lock);
+	reclaim();
+	return (int) m_retired.size();
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// delete replaced snapshots that are not in any reader's slot. Readers
+// that get a snapshot after this scan get the current one (see below).
+
+void snapshot_publisher::reclaim()
+{
+	if(m_retired.empty()) return;
+
+	std::vector<const model_snapshot PTR> held;
+	for(int i=0;i<NN_SNAPSHOT_READER_SLOTS;i++)
+	{
+		const model_snapshot PTR p = slot_snapshot[i].load();
+		if(p!=NULL) held.push_back(p);
+	}
+
+	size_t kept = 0;
+	for(size_t r=0;r<m_retired.size();r++)
+	{
+		bool is_held = false;
+		for(size_t h=0;(h<held.size()) AND (NOT is_held);h++) is_held = (held[h]==m_retired[r]);
+		if(is_held) m_retired[kept++] = m_retired[r];
+		else delete m_retired[r];
+	}
+	m_retired.resize(kept);
+}
+
+/*-----------------------------------------------------------------------*/
+// the snapshot is announced in the slot, then the current one is read again:
+// if it is still the same, the publisher has not replaced it before seeing
+// the slot, so it will not be deleted while announced.
+
+snapshot_reader::snapshot_reader(snapshot_publisher REF publisher)
+{
+	m_snapshot = NULL;
+	m_slot = claim_slot();
+	if(m_slot<0) return;										// (too many readers)
+
+	const model_snapshot PTR p = publisher.m_current.load();
+	for(;;)
+	{
+		slot_snapshot[m_slot].store(p);
+		const model_snapshot PTR q = publisher.m_current.load();
+		if(q==p) break;
+		p = q;
+	}
+	m_snapshot = p;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+snapshot_reader::~snapshot_reader()
+{
+	if(m_slot<0) return;
+	slot_snapshot[m_slot].store(NULL, std::memory_order_release);
+	slot_in_use[m_slot].store(false, std::memory_order_release);
+}
+
+}   // end of namespace nnlib2
@@ -0,0 +1,107 @@
+//		----------------------------------------------------------
+//		(c)2026  Vasilis.N.Nikolaidis          All rights reserved.
+//		-----------------------------------------------------------
+//		nnlib2_snapshot.h						Version 0.1
+//		-----------------------------------------------------------
+//		Versioned model snapshots, for serving (recall) while a model
+//		is being trained. A snapshot is an immutable copy of what a
+//		model needs for recall (s.a. its weights, see bp_snapshot and
+//		lvq_snapshot). The trainer publishes a new snapshot by an atomic
+//		pointer swap; readers take the latest one without locks, and
+//		the snapshots replaced are deleted when no reader holds them
+//		(readers announce what they hold in hazard pointer slots, which
+//		the publisher checks before deleting).
+//		Usage:
+//		  trainer:	publisher.publish(model.make_snapshot());
+//		  reader:	{
+//					snapshot_reader r(publisher);
+//					const bp_snapshot PTR s = r.get<bp_snapshot>();
+//					if(s!=NULL) s->recall(...);
+//					}		// (released here)
+//		-----------------------------------------------------------
+
+#ifndef NN_SNAPSHOT_H
+#define NN_SNAPSHOT_H
+
+#include "nnlib2.h"
+
+#include <stdint.h>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+#define NN_SNAPSHOT_READER_SLOTS		256			// max snapshots held by readers at the same time (process-wide)
+
+namespace nnlib2 {
+
+/*-----------------------------------------------------------------------*/
+// base class of snapshots (immutable once published).
+
+class model_snapshot
+ {
+ friend class snapshot_publisher;
+
+ private:
+
+ uint64_t m_version;									// (set when published)
+
+ public:
+
+ model_snapshot()                                  { m_version = 0; }
+ virtual ~model_snapshot()                         {}
+ uint64_t version() const                          { return m_version; }
+ virtual size_t memory_usage() const = 0;			// (approximate, in bytes)
+ };
+
+/*-----------------------------------------------------------------------*/
+
+class snapshot_publisher
+ {
+ friend class snapshot_reader;
+
+ private:
+
+ std::atomic<model_snapshot PTR> m_current;
+ std::atomic<uint64_t> m_last_version;
+ std::mutex m_publish_lock;							// (publishers only, readers do not lock)
+ std::vector<model_snapshot PTR> m_retired;			// replaced, deleted when no reader holds them
+
+ void reclaim();										// (called with m_publish_lock taken)
+
+ public:
+
+ snapshot_publisher();
+ ~snapshot_publisher();								// (no readers should be left)
+
+ uint64_t publish(model_snapshot PTR snapshot);		// takes ownership; returns its version (0 if snapshot is NULL)
+ void clear();											// no current snapshot
+ uint64_t current_version();							// (0 if none)
+ int pending_reclamation();							// replaced snapshots still held by readers
+ };
+
+/*-----------------------------------------------------------------------*/
+// holds the latest snapshot (if any) from creation until destruction.
+
+class snapshot_reader
+ {
+ private:
+
+ int m_slot;											// hazard pointer slot used (-1 if none was free)
+ const model_snapshot PTR m_snapshot;
+
+ snapshot_reader(const snapshot_reader REF);			// (not copyable)
+ void operator=(const snapshot_reader REF);
+
+ public:
+
+ snapshot_reader(snapshot_publisher REF publisher);
+ ~snapshot_reader();
+
+ const model_snapshot PTR get() const              { return m_snapshot; }
+ template <class SNAPSHOT_TYPE>
+ const SNAPSHOT_TYPE PTR get() const               { return dynamic_cast<const SNAPSHOT_TYPE PTR>(m_snapshot); }	// (NULL if none, or of other type)
+ };
+
+}   // end of namespace nnlib2
+
+#endif // NN_SNAPSHOT_H
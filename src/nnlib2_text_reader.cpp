@@ -0,0 +1,280 @@
+//		----------------------------------------------------------
+//		(c)2026  Vasilis.N.Nikolaidis          All rights reserved.
+//		-----------------------------------------------------------
+//		nnlib2_text_reader.cpp					Version 0.1
+//		-----------------------------------------------------------
+//		Fast reader for (text) models (see nnlib2_text_reader.h)
+//		-----------------------------------------------------------
+
+#include "nnlib2_text_reader.h"
+
+#include <cstdlib>
+#include <cerrno>
+#include <climits>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <stdint.h>
+
+namespace nnlib2 {
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// same whitespace as used by istream extraction (in the "C" locale)
+
+static inline bool is_text_space(char c)
+{
+	return (c==' ') OR (c=='\n') OR (c=='\t') OR (c=='\r') OR (c=='\v') OR (c=='\f');
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// fast path for parsing decimal numbers (as written by to_stream methods):
+// if the digits fit exactly in a double (< 2^53) and the decimal exponent is
+// small (|e| <= 22, so that 10^e is also exact) the result of a single
+// multiplication or division is correctly rounded, i.e. identical to strtod.
+// Returns false if the fast path can not be used (then strtod must be used).
+
+static bool parse_decimal_fast(const char * p, const char * p_end, double REF value)
+{
+	static const double powers_of_10[23] = {1e0,1e1,1e2,1e3,1e4,1e5,1e6,1e7,1e8,1e9,1e10,1e11,
+	                                        1e12,1e13,1e14,1e15,1e16,1e17,1e18,1e19,1e20,1e21,1e22};
+
+	bool negative = false;
+	if((p<p_end) AND ((*p=='-') OR (*p=='+'))) { negative = (*p=='-'); p++; }
+
+	uint64_t mantissa = 0;
+	int digits = 0;
+	int exponent = 0;
+
+	const char * p_digits = p;
+	bool in_fraction = false;
+	for(;p<p_end;p++)
+	{
+		if((*p=='.') AND (NOT in_fraction)) { in_fraction = true; continue; }
+		if((*p<'0') OR (*p>'9')) break;
+		if((mantissa>0) OR (*p!='0')) digits++;				// (leading zeros are not significant)
+		if(digits>15) return false;							// (may not fit exactly in a double)
+		mantissa = mantissa*10 + (*p-'0');
+		if(in_fraction) exponent--;
+	}
+	if((p==p_digits) OR ((p==p_digits+1) AND (*p_digits=='.'))) return false;		// no digits
+
+	if((p<p_end) AND ((*p=='e') OR (*p=='E')))
+	{
+		p++;
+		bool negative_exponent = false;
+		if((p<p_end) AND ((*p=='-') OR (*p=='+'))) { negative_exponent = (*p=='-'); p++; }
+		if((p>=p_end) OR (*p<'0') OR (*p>'9')) return false;
+		int e = 0;
+		for(;(p<p_end) AND (*p>='0') AND (*p<='9');p++)
+		{
+			e = e*10 + (*p-'0');
+			if(e>1000) return false;
+		}
+		exponent += negative_exponent ? -e : e;
+	}
+
+	if(p!=p_end) return false;							// not a (plain decimal) number
+	if((exponent<-22) OR (exponent>22)) return false;
+
+	double v = (double) mantissa;
+	if(exponent<0) v = v / powers_of_10[-exponent];
+	else           v = v * powers_of_10[exponent];
+	value = negative ? -v : v;
+	return true;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+text_model_reader::text_model_reader()
+{
+	m_position = 0;
+	m_stream_start = -1;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+bool text_model_reader::load_file(string filename)
+{
+	m_buffer.clear();
+	m_position = 0;
+	m_stream_start = -1;
+
+	std::ifstream f(filename.c_str(), std::ios::binary);
+	if(NOT f)
+	{
+		error(NN_IOFILE_ERR,"Cannot open file " + filename);
+		return false;
+	}
+	return load_stream(f);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+bool text_model_reader::load_stream(std::istream REF s)
+{
+	m_buffer.clear();
+	m_position = 0;
+	m_stream_start = -1;
+
+	if(s.rdstate()) {error(NN_IOFILE_ERR,"Error reading stream (text model)");return false;}
+
+	std::streampos start = s.tellg();
+	if(start != std::streampos(-1))
+	{
+		// stream can be positioned, read remaining contents in one step
+
+		s.seekg(0, std::ios::end);
+		std::streampos end = s.tellg();
+		s.seekg(start);
+		if((end != std::streampos(-1)) AND (end >= start))
+		{
+			m_stream_start = (std::streamoff) start;
+			m_buffer.resize((size_t)(end - start));
+			if(m_buffer.size()>0) s.read(&m_buffer[0], (std::streamsize) m_buffer.size());
+			m_buffer.resize((size_t) s.gcount());
+			return true;
+		}
+		s.clear();
+		s.seekg(start);
+	}
+
+	m_buffer.assign(std::istreambuf_iterator<char>(s), std::istreambuf_iterator<char>());
+	return true;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// allow stream to be used after model (as if read by from_stream methods)
+
+void text_model_reader::return_unused_to(std::istream REF s)
+{
+	if(m_stream_start<0) return;
+	s.clear();
+	s.seekg(m_stream_start + (std::streamoff) m_position);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+int text_model_reader::line_at(size_t offset)
+{
+	int line = 1;
+	if(offset>m_buffer.size()) offset = m_buffer.size();
+	for(size_t i=0;i<offset;i++)
+		if(m_buffer[i]=='\n') line++;
+	return line;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+void text_model_reader::parse_error(string message, size_t offset)
+{
+	std::stringstream s;
+	s << "Error reading model text (" << message << ") at offset " << offset << " (line " << line_at(offset) << ")";
+	error(NN_IOFILE_ERR,s.str());
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// locates next token; does not advance current position
+
+bool text_model_reader::next_token(size_t REF begin, size_t REF end)
+{
+	if(NOT no_error()) return false;
+
+	size_t n = m_buffer.size();
+	size_t i = m_position;
+	while((i<n) AND is_text_space(m_buffer[i])) i++;
+	if(i>=n)
+	{
+		parse_error("unexpected end of text",i);
+		return false;
+	}
+	begin = i;
+	while((i<n) AND (NOT is_text_space(m_buffer[i]))) i++;
+	end = i;
+	return true;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+bool text_model_reader::skip(int number_of_tokens)
+{
+	size_t begin, end;
+	for(int i=0;i<number_of_tokens;i++)
+	{
+		if(NOT next_token(begin,end)) return false;
+		m_position = end;
+	}
+	return true;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+bool text_model_reader::read(string REF value)
+{
+	size_t begin, end;
+	if(NOT next_token(begin,end)) return false;
+	value.assign(m_buffer, begin, end-begin);
+	m_position = end;
+	return true;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// (as done by streamable_string operator >>)
+
+bool text_model_reader::read(streamable_string REF value)
+{
+	string buffer;
+	if(NOT read(buffer)) return false;
+	for (unsigned i = 0; i < buffer.length(); i++)
+		if (buffer[i] == STRING_SPACE_REPLACE) buffer[i] = ' ';
+	value.assign(buffer);
+	return true;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+bool text_model_reader::read(int REF value)
+{
+	size_t begin, end;
+	if(NOT next_token(begin,end)) return false;
+
+	const char * p_begin = m_buffer.c_str() + begin;
+	char * p_end = NULL;
+	errno = 0;
+	long v = strtol(p_begin, &p_end, 10);
+	if((p_end != m_buffer.c_str() + end) OR (errno!=0) OR (v<INT_MIN) OR (v>INT_MAX))
+	{
+		parse_error("integer expected",begin);
+		return false;
+	}
+	value = (int) v;
+	m_position = end;
+	return true;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+bool text_model_reader::read(DATA REF value)
+{
+	size_t begin, end;
+	if(NOT next_token(begin,end)) return false;
+
+	const char * p_begin = m_buffer.c_str() + begin;
+	double v;
+	if(NOT parse_decimal_fast(p_begin, m_buffer.c_str() + end, v))
+	{
+		char * p_end = NULL;
+		v = strtod(p_begin, &p_end);
+		if(p_end != m_buffer.c_str() + end)
+		{
+			parse_error("number expected",begin);
+			return false;
+		}
+	}
+	value = (DATA) v;
+	m_position = end;
+	return true;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+}   // end of namespace nnlib2
@@ -0,0 +1,60 @@
+//		----------------------------------------------------------
+//		(c)2026  Vasilis.N.Nikolaidis          All rights reserved.
+//		-----------------------------------------------------------
+//		nnlib2_text_reader.h					Version 0.1
+//		-----------------------------------------------------------
+//		Fast reader for (text) models saved by to_stream methods.
+//		The entire text is read in a buffer and then tokens (labels
+//		and numbers) are parsed in place, avoiding istream extraction
+//		for each item. Accepts the same format as from_stream methods;
+//		errors are reported with the offset (and line) where they
+//		occurred.
+//		-----------------------------------------------------------
+
+#ifndef NN_TEXT_READER_H
+#define NN_TEXT_READER_H
+
+#include "nnlib2.h"
+#include "nnlib2_error.h"
+#include "nnlib2_string.h"
+
+#include <iostream>
+#include <string>
+
+namespace nnlib2 {
+
+/*-----------------------------------------------------------------------*/
+
+class text_model_reader : public error_flag_client
+ {
+ private:
+
+ string m_buffer;								// entire text (always null-terminated, as required by strtod)
+ size_t m_position;								// current offset in buffer
+ std::streamoff m_stream_start;					// where text was found in stream (-1 if not known, see load_stream)
+
+ bool next_token(size_t REF begin, size_t REF end);
+ void parse_error(string message, size_t offset);
+
+ public:
+
+ text_model_reader();
+
+ bool load_file(string filename);				// read entire text file in buffer
+ bool load_stream(std::istream REF s);			// read remaining contents of stream in buffer
+ void return_unused_to(std::istream REF s);		// reposition stream (if possible) after the last token parsed
+
+ bool skip(int number_of_tokens = 1);			// skip labels (s.a. "ID:")
+ bool read(string REF value);
+ bool read(streamable_string REF value);
+ bool read(int REF value);
+ bool read(DATA REF value);
+
+ size_t offset()		{ return m_position; }
+ size_t size()			{ return m_buffer.size(); }
+ int line_at(size_t offset);					// line number (1 is first) containing given offset
+ };
+
+}   // end of namespace nnlib2
+
+#endif // NN_TEXT_READER_H
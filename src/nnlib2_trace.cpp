@@ -0,0 +1,236 @@
+//		----------------------------------------------------------
+//		(c)2026  Vasilis.N.Nikolaidis          All rights reserved.
+//		-----------------------------------------------------------
+//		nnlib2_trace.cpp						Version 0.1
+//		-----------------------------------------------------------
+//		event tracing with per-thread ring buffers (see header).
+//		-----------------------------------------------------------
+
+#include "nnlib2_trace.h"
+#include "nnlib2_error.h"
+
+#include <cstdio>
+#include <cstring>
+
+namespace nnlib2 {
+
+nn_tracer event_tracer;
+
+/*-----------------------------------------------------------------------*/
+// the ring used by a thread is released (for reuse by later threads, s.a.
+// the next checkpoint writer) when the thread ends.
+
+struct trace_ring_holder
+ {
+ trace_ring PTR p_ring;
+ trace_ring_holder()  { p_ring = NULL; }
+ ~trace_ring_holder() { if(p_ring!=NULL) p_ring->in_use.store(false, std::memory_order_release); }
+ };
+
+static thread_local trace_ring_holder this_thread_ring;
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+nn_tracer::nn_tracer()
+{
+	m_enabled.store(false);
+	m_origin = std::chrono::steady_clock::now();
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+nn_tracer::~nn_tracer()
+{
+	std::lock_guard<std::mutex> lock(m_rings_lock);
+	for(size_t i=0;i<m_rings.size();i++) delete m_rings[i];
+	m_rings.clear();
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+uint64_t nn_tracer::now()
+{
+	return (uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_origin).count();
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// returns ring of calling thread, taking a released one or creating it on
+// first use (NULL if memory is not available).
+
+trace_ring PTR nn_tracer::ring_for_this_thread()
+{
+	if(this_thread_ring.p_ring!=NULL) return this_thread_ring.p_ring;
+
+	std::lock_guard<std::mutex> lock(m_rings_lock);
+
+	trace_ring PTR r = NULL;
+	for(size_t i=0;(i<m_rings.size()) AND (r==NULL);i++)
+		if(NOT m_rings[i]->in_use.load(std::memory_order_acquire))
+			r = m_rings[i];
+
+	if(r==NULL)
+	{
+		try
+		{
+			r = new trace_ring;
+			r->events.resize(NN_TRACE_EVENTS_PER_THREAD);
+		}
+		catch(...)
+		{
+			delete r;
+			return NULL;
+		}
+		r->written.store(0);
+		r->cleared.store(0);
+		r->thread_index = (int) m_rings.size() + 1;
+		m_rings.push_back(r);
+	}
+
+	r->in_use.store(true, std::memory_order_release);
+	r->thread_name.store(is_main_thread() ? "main" : "worker");
+	this_thread_ring.p_ring = r;
+	return r;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+void nn_tracer::name_this_thread(const char PTR name)
+{
+	if(NOT enabled()) return;
+	trace_ring PTR r = ring_for_this_thread();
+	if(r!=NULL) r->thread_name.store(name);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+void nn_tracer::record(const char PTR category, const char PTR name, const char PTR arg_name, int64_t arg, uint64_t start, uint64_t end)
+{
+	trace_ring PTR r = ring_for_this_thread();
+	if(r==NULL) return;
+
+	uint64_t n = r->written.load(std::memory_order_relaxed);		// (only this thread writes it)
+	trace_event REF e = r->events[(size_t)(n % r->events.size())];
+	e.category = category;
+	e.arg_name = arg_name;
+	e.arg = arg;
+	e.start_nanoseconds = start;
+	e.duration_nanoseconds = (end>start) ? end-start : 0;
+	strncpy(e.name, name, NN_TRACE_NAME_LENGTH-1);
+	e.name[NN_TRACE_NAME_LENGTH-1] = '\0';
+	r->written.store(n+1, std::memory_order_release);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+void nn_tracer::reset()
+{
+	std::lock_guard<std::mutex> lock(m_rings_lock);
+	for(size_t i=0;i<m_rings.size();i++)
+		m_rings[i]->cleared.store(m_rings[i]->written.load(std::memory_order_acquire));
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+static void write_json_string(std::ostream REF s, const char PTR text)
+{
+	s << '"';
+	for(const char PTR p=text;*p!='\0';p++)
+	{
+		unsigned char c = (unsigned char) *p;
+		if((c=='"') OR (c=='\\')) s << '\\' << (char) c;
+		else
+		if(c<0x20)
+		{
+			char code[8];
+			snprintf(code, sizeof(code), "\\u%04x", (unsigned) c);
+			s << code;
+		}
+		else s << (char) c;
+	}
+	s << '"';
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// writes microseconds (Chrome trace time unit) from nanoseconds.
+
+static void write_microseconds(std::ostream REF s, uint64_t nanoseconds)
+{
+	char text[32];
+	snprintf(text, sizeof(text), "%llu.%03u", (unsigned long long)(nanoseconds/1000), (unsigned)(nanoseconds%1000));
+	s << text;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// events are copied from each ring without stopping its writer; copies of
+// any that may have been overwritten while copying are dropped.
+
+int nn_tracer::write_chrome_trace(std::ostream REF s)
+{
+	std::lock_guard<std::mutex> lock(m_rings_lock);
+
+	int written_events = 0;
+	bool first = true;
+
+	s << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+	for(size_t i=0;i<m_rings.size();i++)
+	{
+		trace_ring REF r = *m_rings[i];
+		uint64_t size = (uint64_t) r.events.size();
+		uint64_t last = r.written.load(std::memory_order_acquire);
+		uint64_t from = r.cleared.load();
+		if(last>size AND from<last-size) from = last-size;
+		if(from>=last) continue;
+
+		std::vector<trace_event> copied;
+		for(uint64_t n=from;n<last;n++) copied.push_back(r.events[(size_t)(n % size)]);
+
+		uint64_t now_written = r.written.load(std::memory_order_acquire);
+		uint64_t valid_from = (now_written>size) ? now_written-size : 0;
+		if(valid_from<from) valid_from = from;
+
+		if(NOT first) s << ",\n";
+		first = false;
+		s << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << r.thread_index << ",\"args\":{\"name\":";
+		write_json_string(s, r.thread_name.load());
+		s << "}}";
+
+		for(uint64_t n=valid_from;n<last;n++)
+		{
+			trace_event REF e = copied[(size_t)(n-from)];
+			s << ",\n{\"name\":";
+			write_json_string(s, e.name);
+			s << ",\"cat\":";
+			write_json_string(s, e.category);
+			s << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << r.thread_index << ",\"ts\":";
+			write_microseconds(s, e.start_nanoseconds);
+			s << ",\"dur\":";
+			write_microseconds(s, e.duration_nanoseconds);
+			if(e.arg_name!=NULL)
+			{
+				s << ",\"args\":{";
+				write_json_string(s, e.arg_name);
+				s << ":" << (long long) e.arg << "}";
+			}
+			s << "}";
+			written_events++;
+		}
+	}
+
+	s << "\n]}\n";
+	return written_events;
+}
+
+/*-----------------------------------------------------------------------*/
+
+void trace_scope::begin(const char PTR category, const char PTR name, const char PTR arg_name, int64_t arg)
+{
+	m_category = category;
+	m_arg_name = arg_name;
+	m_arg = arg;
+	strncpy(m_name, name, NN_TRACE_NAME_LENGTH-1);
+	m_name[NN_TRACE_NAME_LENGTH-1] = '\0';
+	m_start = event_tracer.now();
+}
+
+}   // end of namespace nnlib2
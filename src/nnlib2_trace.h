@@ -0,0 +1,132 @@
+//		----------------------------------------------------------
+//		(c)2026  Vasilis.N.Nikolaidis          All rights reserved.
+//		-----------------------------------------------------------
+//		nnlib2_trace.h							Version 0.1
+//		-----------------------------------------------------------
+//		Optional event tracing, for viewing training and recall on a
+//		timeline (chrome://tracing or https://ui.perfetto.dev). When
+//		enabled, each traced scope (component encode or recall, epoch,
+//		R callback, checkpoint or data set file I/O, waits for data)
+//		records a complete event (start and duration) in a ring buffer
+//		owned by the thread that ran it. Each ring has a single writer
+//		and no locks; when full, oldest events are overwritten. Rings
+//		can be written (at any time) as Chrome trace event JSON. When
+//		disabled, the cost is a single relaxed atomic load per traced
+//		scope. If NN_TRACING (nnlib2.h) is not defined, tracing code
+//		is removed at compile time.
+//		-----------------------------------------------------------
+
+#ifndef NN_TRACE_H
+#define NN_TRACE_H
+
+#include "nnlib2.h"
+
+#include <stdint.h>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+#define NN_TRACE_NAME_LENGTH		48			// event names longer than this are truncated
+#define NN_TRACE_EVENTS_PER_THREAD	32768		// ring buffer size (events kept per thread)
+
+namespace nnlib2 {
+
+/*-----------------------------------------------------------------------*/
+
+struct trace_event
+ {
+ const char PTR category;						// s.a. "encode", "epoch" (static strings only)
+ const char PTR arg_name;						// optional argument shown with event, NULL if none (static string)
+ int64_t arg;
+ uint64_t start_nanoseconds;					// (since tracer was created)
+ uint64_t duration_nanoseconds;
+ char name[NN_TRACE_NAME_LENGTH];
+ };
+
+/*-----------------------------------------------------------------------*/
+// events of one thread (written only by that thread, read by any).
+
+struct trace_ring
+ {
+ std::vector<trace_event> events;
+ std::atomic<uint64_t> written;					// events written (ever), next goes to written % size
+ std::atomic<uint64_t> cleared;					// events before this were discarded (reset)
+ std::atomic<const char PTR> thread_name;		// (static string)
+ std::atomic<bool> in_use;						// false when thread ended (ring can be reused by a new thread)
+ int thread_index;
+ };
+
+/*-----------------------------------------------------------------------*/
+
+class nn_tracer
+ {
+ private:
+
+ std::atomic<bool> m_enabled;
+ std::chrono::steady_clock::time_point m_origin;
+ std::mutex m_rings_lock;								// (only taken when a thread records its first event, and for writing)
+ std::vector<trace_ring PTR> m_rings;
+
+ trace_ring PTR ring_for_this_thread();
+
+ public:
+
+ nn_tracer();
+ ~nn_tracer();
+
+#ifdef NN_TRACING
+ bool enabled()                                    { return m_enabled.load(std::memory_order_relaxed); }
+#else
+ bool enabled()                                    { return false; }
+#endif
+ void enable(bool on)                              { m_enabled.store(on); }
+ void reset();											// discard recorded events
+
+ uint64_t now();										// nanoseconds since tracer was created
+ void record(const char PTR category, const char PTR name, const char PTR arg_name, int64_t arg, uint64_t start, uint64_t end);
+ void name_this_thread(const char PTR name);			// (static string) label of calling thread's events, s.a. "checkpoint writer"
+
+ int write_chrome_trace(std::ostream REF s);			// write events as Chrome trace JSON, returns number of events written
+ };
+
+extern nn_tracer event_tracer;							// (process-wide, see nnlib2_trace.cpp)
+
+/*-----------------------------------------------------------------------*/
+// records a scope as an event if tracing is enabled:
+//	{ trace_scope t("encode", component.name().c_str(), "index", i); component.encode(); }
+// (name is copied, it need not outlive the constructor call)
+
+class trace_scope
+ {
+ private:
+
+ bool m_active;
+ const char PTR m_category;
+ const char PTR m_arg_name;
+ int64_t m_arg;
+ uint64_t m_start;
+ char m_name[NN_TRACE_NAME_LENGTH];
+
+ void begin(const char PTR category, const char PTR name, const char PTR arg_name, int64_t arg);
+
+ public:
+
+ trace_scope(const char PTR category, const char PTR name, const char PTR arg_name = NULL, int64_t arg = 0)
+  {
+  m_active = event_tracer.enabled();
+  if(m_active) begin(category, name, arg_name, arg);
+  }
+
+ ~trace_scope()
+  {
+  if(m_active) event_tracer.record(m_category, m_name, m_arg_name, m_arg, m_start, event_tracer.now());
+  }
+
+ void set_arg(int64_t arg)                         { m_arg = arg; }	// (s.a. rows read, known at end of scope)
+ };
+
+}   // end of namespace nnlib2
+
+#endif // NN_TRACE_H
@@ -0,0 +1,170 @@
+//		----------------------------------------------------------
+//		(c)2026  Vasilis.N.Nikolaidis          All rights reserved.
+//		-----------------------------------------------------------
+//		nnlib2_training_job.cpp					Version 0.1
+//		-----------------------------------------------------------
+//		training in the background (see header).
+//		-----------------------------------------------------------
+
+#include "nnlib2_training_job.h"
+#include "nnlib2_error.h"
+#include "nnlib2_trace.h"
+
+#include <limits>
+
+namespace nnlib2 {
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+training_job::training_job()
+{
+	m_state.store(job_none);
+	m_cancel_requested.store(false);
+	m_epochs = 0;
+	m_epochs_completed = 0;
+	m_error_level = std::numeric_limits<double>::quiet_NaN();
+	m_seconds = 0;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+training_job::~training_job()
+{
+	cancel();
+	wait(-1);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+bool training_job::start(int epochs, std::function<bool()> loop)
+{
+	if(is_running()) return false;
+	if(m_thread.joinable()) m_thread.join();					// (previous job, finished)
+
+	{
+		std::lock_guard<std::mutex> lock(m_lock);
+		m_epochs = epochs;
+		m_epochs_completed = 0;
+		m_error_level = std::numeric_limits<double>::quiet_NaN();
+		m_seconds = 0;
+		m_start = std::chrono::steady_clock::now();
+	}
+	m_cancel_requested.store(false);
+	m_state.store(job_running);
+
+	try
+	{
+		m_thread = std::thread(&training_job::run, this, loop);
+	}
+	catch(...)
+	{
+		m_state.store(job_failed);
+		return false;
+	}
+	return true;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+void training_job::run(std::function<bool()> loop)
+{
+	event_tracer.name_this_thread("training");
+
+	bool ok = false;
+	try
+	{
+		ok = loop();
+	}
+	catch(...)													// (s.a. out of memory)
+	{
+		warning("Background training stopped by an unexpected error");
+		ok = false;
+	}
+
+	std::lock_guard<std::mutex> lock(m_lock);
+	m_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start).count();
+	if(NOT ok) m_state.store(job_failed);
+	else
+	if(m_cancel_requested.load()) m_state.store(job_cancelled);
+	else m_state.store(job_completed);
+	m_finished.notify_all();
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+void training_job::epoch_done(int completed_epochs, double error_level)
+{
+	std::lock_guard<std::mutex> lock(m_lock);
+	m_epochs_completed = completed_epochs;
+	m_error_level = error_level;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+bool training_job::cancel()
+{
+	if(NOT is_running()) return false;
+	m_cancel_requested.store(true);
+	return true;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+bool training_job::wait(double seconds)
+{
+	{
+		std::unique_lock<std::mutex> lock(m_lock);
+		if(seconds<0)
+			m_finished.wait(lock, [this]{ return m_state.load()!=job_running; });
+		else
+			m_finished.wait_for(lock, std::chrono::duration<double>(seconds), [this]{ return m_state.load()!=job_running; });
+		if(m_state.load()==job_running) return false;
+	}
+	if(m_thread.joinable()) m_thread.join();
+	return true;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+const char PTR training_job::state_name(training_job_state state)
+{
+	switch(state)
+	{
+	case job_none:		return "none";
+	case job_running:	return "running";
+	case job_completed:	return "completed";
+	case job_cancelled:	return "cancelled";
+	case job_failed:	return "failed";
+	default:			return "unknown";
+	}
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+int training_job::epochs()
+{
+	std::lock_guard<std::mutex> lock(m_lock);
+	return m_epochs;
+}
+
+int training_job::epochs_completed()
+{
+	std::lock_guard<std::mutex> lock(m_lock);
+	return m_epochs_completed;
+}
+
+double training_job::error_level()
+{
+	std::lock_guard<std::mutex> lock(m_lock);
+	return m_error_level;
+}
+
+double training_job::elapsed_seconds()
+{
+	std::lock_guard<std::mutex> lock(m_lock);
+	if(m_state.load()==job_none) return 0;
+	if(m_state.load()==job_running) return std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start).count();
+	return m_seconds;
+}
+
+}   // end of namespace nnlib2
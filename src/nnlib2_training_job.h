@@ -0,0 +1,82 @@
+//		----------------------------------------------------------
+//		(c)2026  Vasilis.N.Nikolaidis          All rights reserved.
+//		-----------------------------------------------------------
+//		nnlib2_training_job.h					Version 0.1
+//		-----------------------------------------------------------
+//		Training in the background: runs a training (epoch) loop on a
+//		worker thread, so that the caller (s.a. the R session) is not
+//		blocked. The loop reports each completed epoch and checks for
+//		cancellation; the caller can poll status, cancel, or wait for
+//		the job to finish (with a timeout).
+//		The loop must not use the caller's environment while running
+//		(for R: no R functions, objects, output or random numbers),
+//		so its data should be copied before the job starts, and the
+//		NN should not be used by the caller until the job finishes.
+//		-----------------------------------------------------------
+
+#ifndef NN_TRAINING_JOB_H
+#define NN_TRAINING_JOB_H
+
+#include "nnlib2.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace nnlib2 {
+
+/*-----------------------------------------------------------------------*/
+
+enum training_job_state { job_none = 0, job_running, job_completed, job_cancelled, job_failed };
+
+/*-----------------------------------------------------------------------*/
+
+class training_job
+ {
+ private:
+
+ std::thread m_thread;
+ std::mutex m_lock;
+ std::condition_variable m_finished;
+ std::atomic<int> m_state;
+ std::atomic<bool> m_cancel_requested;
+ int m_epochs;												// epochs requested...
+ int m_epochs_completed;									// ...and completed so far
+ double m_error_level;										// after last completed epoch (NaN if not available)
+ std::chrono::steady_clock::time_point m_start;
+ double m_seconds;											// duration, when finished
+
+ void run(std::function<bool()> loop);						// (runs in worker thread)
+
+ public:
+
+ training_job();
+ ~training_job();											// (a running job is cancelled, and waited for)
+
+ bool start(int epochs, std::function<bool()> loop);		// loop returns false if training failed. Returns false if a job is running or thread could not start.
+
+ // called by the loop (in worker thread):
+
+ bool cancel_requested()                           { return m_cancel_requested.load(std::memory_order_relaxed); }
+ void epoch_done(int completed_epochs, double error_level);
+
+ // called by the owner:
+
+ bool cancel();												// request cancellation (the loop stops after current epoch), true if a job was running
+ bool wait(double seconds);									// wait up to seconds (or, if negative, until finished), true if no job is running
+ bool is_running()                                 { return m_state.load()==job_running; }
+ training_job_state state()                        { return (training_job_state) m_state.load(); }
+ static const char PTR state_name(training_job_state state);	// s.a. "running"
+
+ int epochs();
+ int epochs_completed();
+ double error_level();
+ double elapsed_seconds();									// since job started (total, if finished)
+ };
+
+}   // end of namespace nnlib2
+
+#endif // NN_TRAINING_JOB_H
@@ -50,6 +50,8 @@ class vector : public error_flag_client
  bool setup (const int new_number_of_items);
  void reset ();
  int number_of_items ();
+ T PTR data () { return m_storage; }				// direct access to (contiguous) storage, NULL if empty
+ size_t memory_usage() { return sizeof(vector<T>) + (size_t) m_number_of_elements * sizeof(T); }	// approximate bytes used (not data allocated by elements)
  bool contains (T REF item);
  int first_location_of(T REF item);
  void from_stream (std::istream REF s);
@@ -67,6 +67,7 @@ void pe::move_input_to_output()
 
 bool pe::receive_input_value(DATA value)
   {
+  NN_COUNT(cnt_received_values_allocations,1);
   return(received_values.append(value));
   }
 
@@ -77,9 +78,8 @@ DATA pe::input_function()
 {
 	input=0;
 
-	if(received_values.goto_first())
-		do input = input + received_values.current();
-	while(received_values.goto_next());
+	for(DATA d : received_values)
+		input = input + d;
 
 	received_values.reset();
 	return input;
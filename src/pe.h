@@ -53,6 +53,8 @@ class pe
  int number_of_received_input_values();               	// how many values are in the queue?
  DATA received_input_value(int i);						// the i-th received value.
  int  reset_received_values();                          // empties list of received input values (received_values).
+ size_t received_values_memory()						// bytes allocated for queued received values (besides pe itself)
+  { return received_values.memory_usage() - sizeof(received_values); }
  void move_input_to_output();                           // sometimes useful, also sets input to 0 and resets received values.
  DATA preview_current_input();							// The pe's preview_current_input() method is a PATCH to _estimate_ current input value without changing the pe's current state.
 